@@ -1388,6 +1388,36 @@ LLPolyMesh*	LLAvatarAppearance::getUpperBodyMesh()
 	return mMeshLOD[MESH_ID_UPPER_BODY]->mMeshParts[0]->getMesh();
 }
 
+//-----------------------------------------------------------------------------
+// LLAvatarAppearance::beginVisualParamUpdates()
+//-----------------------------------------------------------------------------
+// virtual
+void LLAvatarAppearance::beginVisualParamUpdates()
+{
+	for (polymesh_map_t::iterator iter = mPolyMeshes.begin(); iter != mPolyMeshes.end(); ++iter)
+	{
+		// LOD meshes share the morphed data of their reference mesh
+		if (!iter->second->isLOD())
+		{
+			iter->second->beginMorphBatch();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// LLAvatarAppearance::endVisualParamUpdates()
+//-----------------------------------------------------------------------------
+// virtual
+void LLAvatarAppearance::endVisualParamUpdates()
+{
+	for (polymesh_map_t::iterator iter = mPolyMeshes.begin(); iter != mPolyMeshes.end(); ++iter)
+	{
+		if (!iter->second->isLOD())
+		{
+			iter->second->endMorphBatch();
+		}
+	}
+}
 
 
 // virtual
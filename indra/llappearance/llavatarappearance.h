@@ -96,6 +96,8 @@ public:
 	/*virtual*/ S32				getCollisionVolumeID(std::string &name);
 	/*virtual*/ LLPolyMesh*		getHeadMesh();
 	/*virtual*/ LLPolyMesh*		getUpperBodyMesh();
+	/*virtual*/ void			beginVisualParamUpdates();
+	/*virtual*/ void			endVisualParamUpdates();
 
 /**                    Inherited
  **                                                                            **
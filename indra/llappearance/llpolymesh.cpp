@@ -755,6 +755,7 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
 	mReferenceMesh = reference_mesh;
 	mAvatarp = NULL;
 	mVertexData = NULL;
+	mMorphBatchDepth = 0;
 
 	mCurVertexCount = 0;
 	mFaceIndexCount = 0;
@@ -798,6 +799,7 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
 		mScaledNormals		=   (LLVector4a*)(mVertexData + offset); offset += 4*nverts;
 		mBinormals			=   (LLVector4a*)(mVertexData + offset); offset += 4*nverts;
 		mScaledBinormals	=   (LLVector4a*)(mVertexData + offset); offset += 4*nverts; 
+		mVertexMorphed.resize(mSharedData->mNumVertices, FALSE);
 		initializeForMorph();
 	}
 }
@@ -988,6 +990,50 @@ void LLPolyMesh::initializeForMorph()
 	}
 }
 
+//-----------------------------------------------------------------------------
+// endMorphBatch()
+//-----------------------------------------------------------------------------
+static LLTrace::BlockTimerStatHandle FTM_MORPH_NORMALS("Morph Normals");
+
+void LLPolyMesh::endMorphBatch()
+{
+	llassert(mMorphBatchDepth > 0);
+	if (--mMorphBatchDepth > 0 || mMorphedVertices.empty())
+	{
+		return;
+	}
+
+	LL_RECORD_BLOCK_TIME(FTM_MORPH_NORMALS);
+
+	// in vertex order, so the pass walks the arrays front to back
+	std::sort(mMorphedVertices.begin(), mMorphedVertices.end());
+	for (std::vector<U32>::iterator iter = mMorphedVertices.begin();
+		 iter != mMorphedVertices.end(); ++iter)
+	{
+		renormalize(*iter);
+		mVertexMorphed[*iter] = FALSE;
+	}
+	mMorphedVertices.clear();
+}
+
+//-----------------------------------------------------------------------------
+// renormalize()
+//-----------------------------------------------------------------------------
+void LLPolyMesh::renormalize(U32 vert_index)
+{
+	// calculate new normals based on half angles
+	LLVector4a norm = mScaledNormals[vert_index];
+	norm.normalize3fast();
+	mNormals[vert_index] = norm;
+
+	// calculate new binormals
+	LLVector4a tangent;
+	tangent.setCross3(mScaledBinormals[vert_index], norm);
+	LLVector4a& normalized_binormal = mBinormals[vert_index];
+	normalized_binormal.setCross3(norm, tangent);
+	normalized_binormal.normalize3fast();
+}
+
 //-----------------------------------------------------------------------------
 // getMorphData()
 //-----------------------------------------------------------------------------
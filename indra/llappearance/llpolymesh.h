@@ -307,6 +307,24 @@ public:
 	}
 
 	LLPolyMorphData*	getMorphData(const std::string& morph_name);
+
+	// Morphs applied while a batch is open only accumulate into the scaled
+	// normals and binormals.  The vertices they touched are renormalized
+	// once when the batch ends, rather than once per morph.
+	void	beginMorphBatch() { mMorphBatchDepth++; }
+	void	endMorphBatch();
+	BOOL	isMorphBatchOpen() const { return mMorphBatchDepth > 0; }
+	void	addMorphedVertex(U32 vert_index)
+	{
+		if (!mVertexMorphed[vert_index])
+		{
+			mVertexMorphed[vert_index] = TRUE;
+			mMorphedVertices.push_back(vert_index);
+		}
+	}
+
+	// Recomputes output normal and binormal from the scaled ones
+	void	renormalize(U32 vert_index);
 // 	void	removeMorphData(LLPolyMorphData *morph_target);
 // 	void	deleteAllMorphData();
 
@@ -356,6 +374,11 @@ protected:
 	
 	LLPolyMesh				*mReferenceMesh;
 
+	S32						mMorphBatchDepth;
+	// vertices morphed in the open batch, and a flag per vertex for lookup
+	std::vector<U32>		mMorphedVertices;
+	std::vector<U8>			mVertexMorphed;
+
 	// global mesh list
 	typedef std::map<std::string, LLPolyMeshSharedData*> LLPolyMeshSharedDataTable; 
 	static LLPolyMeshSharedDataTable sGlobalSharedMeshList;
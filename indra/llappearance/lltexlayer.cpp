@@ -35,6 +35,7 @@
 #include "lldir.h"
 #include "llvfile.h"
 #include "llvfs.h"
+#include "lltexlayercompositor.h"
 #include "lltexlayerparams.h"
 #include "lltexturemanagerbridge.h"
 #include "lllocaltextureobject.h"
@@ -1578,8 +1579,10 @@ void LLTexLayer::renderMorphMasks(S32 x, S32 y, S32 width, S32 height, const LLC
 			alpha_data = new U8[width * height];
 			mAlphaCache[cache_index] = alpha_data;
     
+			// Readback waits for the GPU to finish everything queued so far,
+			// so build the mask on the CPU instead when we have its sources.
 			// nSight doesn't support use of glReadPixels
-			if (!LLRender::sNsightDebugSupport)
+			if (!composeMorphMask(alpha_data, width, height, layer_color) && !LLRender::sNsightDebugSupport)
 			{
 				glReadPixels(x, y, width, height, GL_ALPHA, GL_UNSIGNED_BYTE, alpha_data);
 			}
@@ -1592,6 +1595,51 @@ void LLTexLayer::renderMorphMasks(S32 x, S32 y, S32 width, S32 height, const LLC
 	}
 }
 
+static LLTrace::BlockTimerStatHandle FTM_COMPOSE_MORPH_MASK("composeMorphMask");
+BOOL LLTexLayer::composeMorphMask(U8 *data, S32 width, S32 height, const LLColor4 &layer_color)
+{
+	LL_RECORD_BLOCK_TIME(FTM_COMPOSE_MORPH_MASK);
+
+	// A multiply first param blends against the alpha already in the frame buffer
+	LLTexLayerParamAlpha* first_param = *mParamAlphaList.begin();
+	if (first_param && first_param->getMultiplyBlend())
+	{
+		return FALSE;
+	}
+
+	// Local and static mask textures only have their alpha on the GPU
+	if( getInfo()->mLocalTexture != -1 )
+	{
+		LLGLTexture* tex = mLocalTextureObject ? mLocalTextureObject->getImage() : NULL;
+		if( tex && (tex->getComponents() == 4) )
+		{
+			return FALSE;
+		}
+	}
+	if( !getInfo()->mStaticImageFileName.empty() && getInfo()->mStaticImageIsMask )
+	{
+		return FALSE;
+	}
+
+	const S32 count = width * height;
+	memset(data, 0, count);
+	for (param_alpha_list_t::iterator iter = mParamAlphaList.begin(); iter != mParamAlphaList.end(); iter++)
+	{
+		LLTexLayerParamAlpha* param = *iter;
+		if (!param->composeAlpha(data, width, height))
+		{
+			return FALSE;
+		}
+	}
+
+	if ( !is_approx_equal(layer_color.mV[VW], 1.f) )
+	{
+		U8 alpha = (U8)ll_round(llclamp(layer_color.mV[VW], 0.f, 1.f) * 255.f);
+		LLTexLayerCompositor::multiply(data, alpha, count);
+	}
+	return TRUE;
+}
+
 static LLTrace::BlockTimerStatHandle FTM_ADD_ALPHA_MASK("addAlphaMask");
 void LLTexLayer::addAlphaMask(U8 *data, S32 originX, S32 originY, S32 width, S32 height)
 {
@@ -1610,14 +1658,7 @@ void LLTexLayer::addAlphaMask(U8 *data, S32 originX, S32 originY, S32 width, S32
 	}
 	if (alphaData)
 	{
-		for( S32 i = 0; i < size; i++ )
-		{
-			U8 curAlpha = data[i];
-			U16 resultAlpha = curAlpha;
-			resultAlpha *= ( ((U16)alphaData[i]) + 1);
-			resultAlpha = resultAlpha >> 8;
-			data[i] = (U8)resultAlpha;
-		}
+		LLTexLayerCompositor::applyMask(data, alphaData, size);
 	}
 }
 
@@ -0,0 +1,161 @@
+/** 
+ * @file lltexlayercompositor.cpp
+ * @brief CPU blending of tex layer alpha masks.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "lltexlayercompositor.h"
+
+#include "llimage.h"
+#include "llmath.h"
+#include "llsimdmath.h"
+
+// a * b / 255 rounded to nearest, for each of eight 16 bit lanes
+static inline __m128i mul_255(__m128i a, __m128i b)
+{
+	const __m128i half = _mm_set1_epi16(128);
+	__m128i t = _mm_add_epi16(_mm_mullo_epi16(a, b), half);
+	return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+static inline U8 mul_255(U32 a, U32 b)
+{
+	U32 t = a * b + 128;
+	return (U8)((t + (t >> 8)) >> 8);
+}
+
+static inline void multiply_16(U8* dst, __m128i src)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i d = _mm_loadu_si128((const __m128i*)dst);
+	__m128i lo = mul_255(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(src, zero));
+	__m128i hi = mul_255(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(src, zero));
+	_mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+}
+
+// static
+BOOL LLTexLayerCompositor::copy(U8* dst, S32 width, S32 height, LLImageRaw* src)
+{
+	if (!src || src->getComponents() != 1 || !src->getData())
+	{
+		return FALSE;
+	}
+
+	if (src->getWidth() == width && src->getHeight() == height)
+	{
+		memcpy(dst, src->getData(), width * height);
+		return TRUE;
+	}
+
+	LLPointer<LLImageRaw> scaled = new LLImageRaw(src->getData(), src->getWidth(), src->getHeight(), 1);
+	if (!scaled->scale(width, height))
+	{
+		return FALSE;
+	}
+	memcpy(dst, scaled->getData(), width * height);
+	return TRUE;
+}
+
+// static
+void LLTexLayerCompositor::add(U8* dst, const U8* src, S32 count)
+{
+	S32 i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		__m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(d, s));
+	}
+	for (; i < count; i++)
+	{
+		dst[i] = (U8)llmin((U32)dst[i] + src[i], (U32)255);
+	}
+}
+
+// static
+void LLTexLayerCompositor::add(U8* dst, U8 value, S32 count)
+{
+	const __m128i s = _mm_set1_epi8((char)value);
+	S32 i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(d, s));
+	}
+	for (; i < count; i++)
+	{
+		dst[i] = (U8)llmin((U32)dst[i] + value, (U32)255);
+	}
+}
+
+// static
+void LLTexLayerCompositor::multiply(U8* dst, const U8* src, S32 count)
+{
+	S32 i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		multiply_16(dst + i, _mm_loadu_si128((const __m128i*)(src + i)));
+	}
+	for (; i < count; i++)
+	{
+		dst[i] = mul_255(dst[i], src[i]);
+	}
+}
+
+// static
+void LLTexLayerCompositor::multiply(U8* dst, U8 value, S32 count)
+{
+	const __m128i s = _mm_set1_epi8((char)value);
+	S32 i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		multiply_16(dst + i, s);
+	}
+	for (; i < count; i++)
+	{
+		dst[i] = mul_255(dst[i], value);
+	}
+}
+
+// static
+void LLTexLayerCompositor::applyMask(U8* dst, const U8* mask, S32 count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	S32 i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+		__m128i m = _mm_loadu_si128((const __m128i*)(mask + i));
+		__m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_add_epi16(_mm_unpacklo_epi8(m, zero), one));
+		__m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_add_epi16(_mm_unpackhi_epi8(m, zero), one));
+		_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8)));
+	}
+	for (; i < count; i++)
+	{
+		dst[i] = (U8)(((U16)dst[i] * ((U16)mask[i] + 1)) >> 8);
+	}
+}
@@ -0,0 +1,58 @@
+/** 
+ * @file lltexlayercompositor.h
+ * @brief CPU blending of tex layer alpha masks.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTEXLAYERCOMPOSITOR_H
+#define LL_LLTEXLAYERCOMPOSITOR_H
+
+class LLImageRaw;
+
+//-----------------------------------------------------------------------------
+// LLTexLayerCompositor
+// The blends tex layers use to build alpha masks, done on the CPU over
+// single channel 8 bit planes.  Results match what the same blends give
+// in an 8 bit GL framebuffer, so a mask built here can stand in for one
+// read back after rendering.
+//-----------------------------------------------------------------------------
+class LLTexLayerCompositor
+{
+public:
+	// Copies a single channel image into dst, resampling it to width by
+	// height like a stretched texture when the sizes differ.
+	static BOOL copy(U8* dst, S32 width, S32 height, LLImageRaw* src);
+
+	// dst = min(dst + src, 255), as BT_ADD
+	static void add(U8* dst, const U8* src, S32 count);
+	static void add(U8* dst, U8 value, S32 count);
+
+	// dst = dst * src / 255, as BF_DEST_ALPHA, BF_ZERO
+	static void multiply(U8* dst, const U8* src, S32 count);
+	static void multiply(U8* dst, U8 value, S32 count);
+
+	// dst = dst * (mask + 1) / 256, how layer masks are combined
+	static void applyMask(U8* dst, const U8* mask, S32 count);
+};
+
+#endif // LL_LLTEXLAYERCOMPOSITOR_H
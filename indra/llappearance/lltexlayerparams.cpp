@@ -32,6 +32,7 @@
 #include "llimagetga.h"
 #include "llquantize.h"
 #include "lltexlayer.h"
+#include "lltexlayercompositor.h"
 #include "lltexturemanagerbridge.h"
 #include "../llui/llui.h"
 #include "llwearable.h"
@@ -373,6 +374,54 @@ BOOL LLTexLayerParamAlpha::render(S32 x, S32 y, S32 width, S32 height)
 	return success;
 }
 
+BOOL LLTexLayerParamAlpha::composeAlpha(U8* data, S32 width, S32 height)
+{
+	if (!mTexLayer || getSkip())
+	{
+		return TRUE;
+	}
+
+	F32 effective_weight = (mTexLayer->getTexLayerSet()->getAvatarAppearance()->getSex() & getSex()) ? mCurWeight : getDefaultWeight();
+	LLTexLayerParamAlphaInfo *info = (LLTexLayerParamAlphaInfo *)getInfo();
+	const S32 count = width * height;
+
+	if (!info->mStaticImageFileName.empty() && !mStaticImageInvalid)
+	{
+		if (mStaticImageRaw.isNull() || effective_weight != mCachedEffectiveWeight)
+		{
+			return FALSE;
+		}
+
+		std::vector<U8> alpha(count);
+		if (!LLTexLayerCompositor::copy(&alpha[0], width, height, mStaticImageRaw))
+		{
+			return FALSE;
+		}
+		if (info->mMultiplyBlend)
+		{
+			LLTexLayerCompositor::multiply(data, &alpha[0], count);
+		}
+		else
+		{
+			LLTexLayerCompositor::add(data, &alpha[0], count);
+		}
+	}
+	else
+	{
+		U8 alpha = (U8)ll_round(llclamp(effective_weight, 0.f, 1.f) * 255.f);
+		if (info->mMultiplyBlend)
+		{
+			LLTexLayerCompositor::multiply(data, alpha, count);
+		}
+		else
+		{
+			LLTexLayerCompositor::add(data, alpha, count);
+		}
+	}
+
+	return TRUE;
+}
+
 //-----------------------------------------------------------------------------
 // LLTexLayerParamAlphaInfo
 //-----------------------------------------------------------------------------
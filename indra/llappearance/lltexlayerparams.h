@@ -99,6 +99,9 @@ public:
 
 	// New functions
 	BOOL					render( S32 x, S32 y, S32 width, S32 height );
+	// Blends into an alpha plane as render() does into the framebuffer,
+	// using the image render() processed.  FALSE if there is none.
+	BOOL					composeAlpha(U8* data, S32 width, S32 height);
 	BOOL					getSkip() const;
 	void					deleteCaches();
 	BOOL					getMultiplyBlend() const;
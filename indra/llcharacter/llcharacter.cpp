@@ -483,6 +483,7 @@ void LLCharacter::addVisualParam(LLVisualParam *param)
 //-----------------------------------------------------------------------------
 void LLCharacter::updateVisualParams()
 {
+	beginVisualParamUpdates();
 	for (LLVisualParam *param = getFirstVisualParam(); 
 		param;
 		param = getNextVisualParam())
@@ -498,6 +499,7 @@ void LLCharacter::updateVisualParams()
 			param->apply( mSex );
 		}
 	}
+	endVisualParamUpdates();
 }
  
 LLAnimPauseRequest LLCharacter::requestPause()
@@ -117,6 +117,11 @@ public:
 	// updates all visual parameters for this character
 	virtual void updateVisualParams();
 
+	// called around the params applied by updateVisualParams(), so work
+	// shared between them can be done once after they are all applied
+	virtual void beginVisualParamUpdates() {}
+	virtual void endVisualParamUpdates() {}
+
 	virtual void addDebugText( const std::string& text ) = 0;
 
 	virtual const LLUUID&	getID() const = 0;
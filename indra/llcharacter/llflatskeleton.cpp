@@ -0,0 +1,235 @@
+/** 
+ * @file llflatskeleton.cpp
+ * @brief Joint hierarchy flattened into arrays for world matrix updates.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "llflatskeleton.h"
+
+#include "lljoint.h"
+#include "llmemory.h"
+#include "llvector4a.h"
+
+// r = a * b, as LLQuaternion's operator*
+static inline void quat_mul(LLVector4a& r, const LLVector4a& a, const LLVector4a& b)
+{
+	const LLQuad aq = a;
+	const LLQuad bq = b;
+	// aw * (bx, by, bz, bw)
+	LLQuad sum = _mm_mul_ps(_mm_shuffle_ps(aq, aq, _MM_SHUFFLE(3, 3, 3, 3)), bq);
+	// (ax, ay, az, -ax) * (bw, bw, bw, bx) + (az, ax, ay, -ay) * (by, bz, bx, by)
+	LLQuad signed_terms = _mm_add_ps(
+		_mm_mul_ps(_mm_shuffle_ps(aq, aq, _MM_SHUFFLE(0, 2, 1, 0)), _mm_shuffle_ps(bq, bq, _MM_SHUFFLE(0, 3, 3, 3))),
+		_mm_mul_ps(_mm_shuffle_ps(aq, aq, _MM_SHUFFLE(1, 1, 0, 2)), _mm_shuffle_ps(bq, bq, _MM_SHUFFLE(1, 0, 2, 1))));
+	const LLQuad negate_w = _mm_set_ps(-0.f, 0.f, 0.f, 0.f);
+	sum = _mm_add_ps(sum, _mm_xor_ps(signed_terms, negate_w));
+	// - (ay, az, ax, az) * (bz, bx, by, bz)
+	sum = _mm_sub_ps(sum, _mm_mul_ps(_mm_shuffle_ps(aq, aq, _MM_SHUFFLE(2, 0, 2, 1)), _mm_shuffle_ps(bq, bq, _MM_SHUFFLE(2, 1, 0, 2))));
+	r = sum;
+}
+
+// Rotation rows as LLMatrix4::initAll() builds them, before scaling.
+static inline void quat_rows(LLVector4a* rows, const LLVector4a& q)
+{
+	const F32* v = q.getF32ptr();
+	const F32 xx = v[VX] * v[VX], xy = v[VX] * v[VY], xz = v[VX] * v[VZ], xw = v[VX] * v[VW];
+	const F32 yy = v[VY] * v[VY], yz = v[VY] * v[VZ], yw = v[VY] * v[VW];
+	const F32 zz = v[VZ] * v[VZ], zw = v[VZ] * v[VW];
+
+	rows[0].set(1.f - 2.f * (yy + zz), 2.f * (xy + zw), 2.f * (xz - yw));
+	rows[1].set(2.f * (xy - zw), 1.f - 2.f * (xx + zz), 2.f * (yz + xw));
+	rows[2].set(2.f * (xz + yw), 2.f * (yz - xw), 1.f - 2.f * (xx + yy));
+}
+
+LLFlatSkeleton::LLFlatSkeleton() :
+	mRoot(NULL),
+	mHierarchyVersion(0),
+	mWorldPositions(NULL),
+	mWorldRotations(NULL),
+	mWorldRows(NULL)
+{
+}
+
+LLFlatSkeleton::~LLFlatSkeleton()
+{
+	ll_aligned_free_16(mWorldPositions);
+}
+
+void LLFlatSkeleton::setRoot(LLJoint* root)
+{
+	if (root != mRoot)
+	{
+		mRoot = root;
+		mJoints.clear();
+	}
+}
+
+void LLFlatSkeleton::build()
+{
+	mJoints.clear();
+	mParents.clear();
+	mSubtreeEnds.clear();
+	mHierarchyVersion = mRoot->mHierarchyVersion;
+
+	// Depth first with an explicit stack
+	std::vector<std::pair<LLJoint*, S32> > stack;
+	stack.push_back(std::make_pair(mRoot, -1));
+	while (!stack.empty())
+	{
+		LLJoint* joint = stack.back().first;
+		const S32 parent = stack.back().second;
+		stack.pop_back();
+
+		const S32 index = (S32)mJoints.size();
+		mJoints.push_back(joint);
+		mParents.push_back(parent);
+
+		// Reversed so children come out in mChildren order.
+		for (LLJoint::child_list_t::reverse_iterator iter = joint->mChildren.rbegin();
+			 iter != joint->mChildren.rend(); ++iter)
+		{
+			stack.push_back(std::make_pair(*iter, index));
+		}
+	}
+
+	// Subtrees are contiguous, widen each parent's to cover its children's.
+	const S32 count = (S32)mJoints.size();
+	mSubtreeEnds.resize(count);
+	for (S32 i = count - 1; i >= 0; i--)
+	{
+		mSubtreeEnds[i] = llmax(mSubtreeEnds[i], i + 1);
+		if (mParents[i] >= 0)
+		{
+			mSubtreeEnds[mParents[i]] = llmax(mSubtreeEnds[mParents[i]], mSubtreeEnds[i]);
+		}
+	}
+
+	ll_aligned_free_16(mWorldPositions);
+	mWorldPositions = (LLVector4a*)ll_aligned_malloc_16(sizeof(LLVector4a) * count * 5);
+	mWorldRotations = mWorldPositions + count;
+	mWorldRows = mWorldRotations + count;
+}
+
+// Picks up a joint that is already up to date, or that LLJoint updated.
+void LLFlatSkeleton::loadWorld(S32 index)
+{
+	LLXformMatrix* xform = mJoints[index]->getXform();
+	mWorldPositions[index].load3(xform->getWorldPosition().mV);
+	mWorldRotations[index].loadua(xform->getWorldRotation().mQ);
+	quat_rows(mWorldRows + index * 3, mWorldRotations[index]);
+}
+
+void LLFlatSkeleton::updateWorldMatrices()
+{
+	if (!mRoot)
+	{
+		return;
+	}
+	if (mJoints.empty() || mHierarchyVersion != mRoot->mHierarchyVersion)
+	{
+		build();
+	}
+
+	const S32 count = (S32)mJoints.size();
+	for (S32 i = 0; i < count; )
+	{
+		LLJoint* joint = mJoints[i];
+		if (!joint->mUpdateXform)
+		{
+			i = mSubtreeEnds[i];
+			continue;
+		}
+
+		const S32 parent = mParents[i];
+		if (!(joint->mDirtyFlags & LLJoint::MATRIX_DIRTY))
+		{
+			loadWorld(i);
+		}
+		else if (parent < 0)
+		{
+			// The root's xform may hang off an object's, let it do its own.
+			joint->updateWorldMatrix();
+			loadWorld(i);
+		}
+		else
+		{
+			LLXformMatrix* xform = joint->getXform();
+			LLXformMatrix* parent_xform = mJoints[parent]->getXform();
+			const LLVector4a* parent_rows = mWorldRows + parent * 3;
+
+			// position = parent position + (local position * parent rotation)
+			LLVector4a local;
+			local.load3(xform->getPosition().mV);
+			if (parent_xform->getScaleChildOffset())
+			{
+				LLVector4a parent_scale;
+				parent_scale.load3(parent_xform->getScale().mV);
+				local.mul(parent_scale);
+			}
+			LLVector4a& pos = mWorldPositions[i];
+			LLVector4a axis;
+			axis.splat<0>(local);
+			pos.setMul(axis, parent_rows[0]);
+			axis.splat<1>(local);
+			axis.mul(parent_rows[1]);
+			pos.add(axis);
+			axis.splat<2>(local);
+			axis.mul(parent_rows[2]);
+			pos.add(axis);
+			pos.add(mWorldPositions[parent]);
+
+			// rotation = local rotation * parent rotation
+			LLVector4a local_rot;
+			local_rot.loadua(xform->getRotation().mQ);
+			quat_mul(mWorldRotations[i], local_rot, mWorldRotations[parent]);
+
+			LLVector4a* rows = mWorldRows + i * 3;
+			quat_rows(rows, mWorldRotations[i]);
+
+			// Same layout as LLMatrix4::initAll(scale, rotation, position)
+			LLVector4a scale;
+			scale.load3(xform->getScale().mV);
+			LLMatrix4& mat = xform->getWorldMatrixRw();
+			LLVector4a row;
+			for (S32 r = 0; r < 3; r++)
+			{
+				row.splat(scale, r);
+				row.mul(rows[r]);
+				_mm_storeu_ps(mat.mMatrix[r], row);
+			}
+			row = pos;
+			_mm_storeu_ps(mat.mMatrix[3], row);
+			mat.mMatrix[3][3] = 1.f;
+
+			const F32* rot = mWorldRotations[i].getF32ptr();
+			xform->setWorldPositionRotation(LLVector3(pos.getF32ptr()), LLQuaternion(rot[VX], rot[VY], rot[VZ], rot[VW]));
+
+			joint->mDirtyFlags = 0x0;
+			LLJoint::sNumUpdates++;
+		}
+		i++;
+	}
+}
@@ -0,0 +1,78 @@
+/** 
+ * @file llflatskeleton.h
+ * @brief Joint hierarchy flattened into arrays for world matrix updates.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLFLATSKELETON_H
+#define LL_LLFLATSKELETON_H
+
+#include <vector>
+
+class LLJoint;
+class LLVector4a;
+
+// The joints under a root in depth first order, parents before children,
+// with each joint's parent as an index.  updateWorldMatrices() walks the
+// arrays front to back composing world transforms with SSE, keeping the
+// world position, rotation and rotation rows of every joint in contiguous
+// arrays so children never go back to their parent's LLJoint for them.
+//
+// The arrays are rebuilt whenever a joint is added to or removed from the
+// root's subtree, see LLJoint::mHierarchyVersion.
+class LLFlatSkeleton
+{
+public:
+	LLFlatSkeleton();
+	~LLFlatSkeleton();
+
+	void setRoot(LLJoint* root);
+	LLJoint* getRoot() const { return mRoot; }
+
+	// Same result as getRoot()->updateWorldMatrixChildren()
+	void updateWorldMatrices();
+
+	S32 getNumJoints() const { return (S32)mJoints.size(); }
+
+private:
+	LLFlatSkeleton(const LLFlatSkeleton&);
+	LLFlatSkeleton& operator=(const LLFlatSkeleton&);
+
+	void build();
+	void loadWorld(S32 index);
+
+	LLJoint* mRoot;
+	U32 mHierarchyVersion;
+
+	std::vector<LLJoint*> mJoints;
+	std::vector<S32> mParents;		// -1 for the root
+	std::vector<S32> mSubtreeEnds;	// index after the joint's last descendant
+
+	// Per joint world state, 16 byte aligned
+	LLVector4a* mWorldPositions;
+	LLVector4a* mWorldRotations;	// quaternions, w last
+	LLVector4a* mWorldRows;			// 3 per joint, unscaled rotation matrix
+};
+
+#endif // LL_LLFLATSKELETON_H
@@ -35,8 +35,8 @@
 #include "llcallstack.h"
 #include <boost/algorithm/string.hpp>
 
-S32 LLJoint::sNumUpdates = 0;
-S32 LLJoint::sNumTouches = 0;
+LL_THREAD_LOCAL S32 LLJoint::sNumUpdates = 0;
+LL_THREAD_LOCAL S32 LLJoint::sNumTouches = 0;
 
 template <class T> 
 bool attachment_map_iter_compare_key(const T& a, const T& b)
@@ -110,6 +110,7 @@ void LLJoint::init()
 	mXform.setScale(LLVector3(1.0f, 1.0f, 1.0f));
 	mDirtyFlags = MATRIX_DIRTY | ROTATION_DIRTY | POSITION_DIRTY;
 	mUpdateXform = TRUE;
+	mHierarchyVersion = 0;
     mSupport = SUPPORT_BASE;
     mEnd = LLVector3(0.0f, 0.0f, 0.0f);
 }
@@ -278,6 +279,7 @@ void LLJoint::addChild(LLJoint* joint)
 	joint->mXform.setParent(&mXform);
 	joint->mParent = this;	
 	joint->touch();
+	hierarchyChanged();
 }
 
 
@@ -294,6 +296,7 @@ void LLJoint::removeChild(LLJoint* joint)
 		joint->mXform.setParent(NULL);
 		joint->mParent = NULL;
 		joint->touch();
+		hierarchyChanged();
 	}
 }
 
@@ -303,6 +306,11 @@ void LLJoint::removeChild(LLJoint* joint)
 //--------------------------------------------------------------------
 void LLJoint::removeAllChildren()
 {
+	if (mChildren.empty())
+	{
+		return;
+	}
+
 	for (child_list_t::iterator iter = mChildren.begin();
 		 iter != mChildren.end();)
 	{
@@ -313,6 +321,21 @@ void LLJoint::removeAllChildren()
 		joint->mParent = NULL;
 		joint->touch();
 	}
+	hierarchyChanged();
+}
+
+
+//--------------------------------------------------------------------
+// hierarchyChanged()
+//--------------------------------------------------------------------
+void LLJoint::hierarchyChanged()
+{
+	// A skeleton can be rooted at any joint, so every subtree that now
+	// looks different gets a new version, not only the topmost one.
+	for (LLJoint* joint = this; joint; joint = joint->mParent)
+	{
+		joint->mHierarchyVersion++;
+	}
 }
 
 
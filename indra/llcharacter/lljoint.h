@@ -132,9 +132,13 @@ public:
 	typedef std::list<LLJoint*> child_list_t;
 	child_list_t mChildren;
 
-	// debug statics
-	static S32		sNumTouches;
-	static S32		sNumUpdates;
+	// bumped whenever a joint is added to or removed from this joint's
+	// subtree, see LLFlatSkeleton
+	U32				mHierarchyVersion;
+
+	// debug statics, per thread as LLSkeletonUpdater updates joints on several
+	static LL_THREAD_LOCAL S32	sNumTouches;
+	static LL_THREAD_LOCAL S32	sNumUpdates;
     typedef std::set<std::string> debug_joint_name_t;
     static debug_joint_name_t s_debugJointNames;
     static void setDebugJointNames(const debug_joint_name_t& names);
@@ -176,6 +180,9 @@ public:
 private:
 	void init();
 
+	// bump mHierarchyVersion on this joint and all its ancestors
+	void hierarchyChanged();
+
 public:
 	// set name and parent
 	void setup( const std::string &name, LLJoint *parent=NULL );
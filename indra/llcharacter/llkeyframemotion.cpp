@@ -40,6 +40,7 @@
 #include "llkeyframemotion.h"
 #include "llquantize.h"
 #include "llvfile.h"
+#include "llvector4a.h"
 #include "m3math.h"
 #include "message.h"
 
@@ -129,6 +130,37 @@ U32 LLKeyframeMotion::JointMotionList::dumpDiagInfo()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// find_key()
+// Index of the first key at or after time, as std::lower_bound would give.
+// Playback mostly moves forward a key or none per frame, so the search
+// starts from cursor, where the last one for this curve ended.
+//-----------------------------------------------------------------------------
+static S32 find_key(const std::vector<F32>& times, F32 time, S32& cursor)
+{
+	const S32 count = (S32)times.size();
+	S32 right = llclamp(cursor, 0, count);
+
+	const S32 MAX_STEPS = 4;
+	for (S32 steps = 0; right < count && times[right] < time; steps++)
+	{
+		if (steps == MAX_STEPS)
+		{
+			right = std::lower_bound(times.begin() + right, times.end(), time) - times.begin();
+			break;
+		}
+		right++;
+	}
+	if (right > 0 && times[right - 1] >= time)
+	{
+		// Looped or jumped back
+		right = std::lower_bound(times.begin(), times.begin() + right, time) - times.begin();
+	}
+
+	cursor = right;
+	return right;
+}
+
 //-----------------------------------------------------------------------------
 // ScaleCurve::ScaleCurve()
 //-----------------------------------------------------------------------------
@@ -148,64 +180,62 @@ LLKeyframeMotion::ScaleCurve::~ScaleCurve()
 }
 
 //-----------------------------------------------------------------------------
-// getValue()
+// compile()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration)
+void LLKeyframeMotion::ScaleCurve::compile()
 {
-	LLVector3 value;
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	mKeyTimes.reserve(mKeys.size());
+	mKeyValues.reserve(mKeys.size());
+	for (key_map_t::iterator iter = mKeys.begin(); iter != mKeys.end(); ++iter)
+	{
+		mKeyTimes.push_back(iter->first);
+		mKeyValues.push_back(iter->second.mScale);
+	}
+}
 
-	if (mKeys.empty())
+//-----------------------------------------------------------------------------
+// getValue()
+//-----------------------------------------------------------------------------
+LLVector3 LLKeyframeMotion::ScaleCurve::getValue(F32 time, F32 duration, S32& cursor)
+{
+	if (mKeyTimes.empty())
 	{
-		value.clearVec();
-		return value;
+		return LLVector3::zero;
 	}
-	
-	key_map_t::iterator right = mKeys.lower_bound(time);
-	if (right == mKeys.end())
+
+	S32 right = find_key(mKeyTimes, time, cursor);
+	if (right == (S32)mKeyTimes.size())
 	{
 		// Past last key
-		--right;
-		value = right->second.mScale;
+		return mKeyValues.back();
 	}
-	else if (right == mKeys.begin() || right->first == time)
+	if (right == 0 || mKeyTimes[right] == time)
 	{
 		// Before first key or exactly on a key
-		value = right->second.mScale;
+		return mKeyValues[right];
 	}
-	else
-	{
-		// Between two keys
-		key_map_t::iterator left = right; --left;
-		F32 index_before = left->first;
-		F32 index_after = right->first;
-		ScaleKey& scale_before = left->second;
-		ScaleKey& scale_after = right->second;
-		if (right == mKeys.end())
-		{
-			scale_after = mLoopInKey;
-			index_after = duration;
-		}
 
-		F32 u = (time - index_before) / (index_after - index_before);
-		value = interp(u, scale_before, scale_after);
-	}
-	return value;
+	// Between two keys
+	F32 u = (time - mKeyTimes[right - 1]) / (mKeyTimes[right] - mKeyTimes[right - 1]);
+	return interp(u, mKeyValues[right - 1], mKeyValues[right]);
 }
 
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::ScaleCurve::interp(F32 u, ScaleKey& before, ScaleKey& after)
+LLVector3 LLKeyframeMotion::ScaleCurve::interp(F32 u, const LLVector3& before, const LLVector3& after)
 {
 	switch (mInterpolationType)
 	{
 	case IT_STEP:
-		return before.mScale;
+		return before;
 
 	default:
 	case IT_LINEAR:
 	case IT_SPLINE:
-		return lerp(before.mScale, after.mScale, u);
+		return lerp(before, after, u);
 	}
 }
 
@@ -228,64 +258,62 @@ LLKeyframeMotion::RotationCurve::~RotationCurve()
 }
 
 //-----------------------------------------------------------------------------
-// RotationCurve::getValue()
+// compile()
 //-----------------------------------------------------------------------------
-LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration)
+void LLKeyframeMotion::RotationCurve::compile()
 {
-	LLQuaternion value;
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	mKeyTimes.reserve(mKeys.size());
+	mKeyValues.reserve(mKeys.size());
+	for (key_map_t::iterator iter = mKeys.begin(); iter != mKeys.end(); ++iter)
+	{
+		mKeyTimes.push_back(iter->first);
+		mKeyValues.push_back(iter->second.mRotation);
+	}
+}
 
-	if (mKeys.empty())
+//-----------------------------------------------------------------------------
+// RotationCurve::getValue()
+//-----------------------------------------------------------------------------
+LLQuaternion LLKeyframeMotion::RotationCurve::getValue(F32 time, F32 duration, S32& cursor)
+{
+	if (mKeyTimes.empty())
 	{
-		value = LLQuaternion::DEFAULT;
-		return value;
+		return LLQuaternion::DEFAULT;
 	}
-	
-	key_map_t::iterator right = mKeys.lower_bound(time);
-	if (right == mKeys.end())
+
+	S32 right = find_key(mKeyTimes, time, cursor);
+	if (right == (S32)mKeyTimes.size())
 	{
 		// Past last key
-		--right;
-		value = right->second.mRotation;
+		return mKeyValues.back();
 	}
-	else if (right == mKeys.begin() || right->first == time)
+	if (right == 0 || mKeyTimes[right] == time)
 	{
 		// Before first key or exactly on a key
-		value = right->second.mRotation;
+		return mKeyValues[right];
 	}
-	else
-	{
-		// Between two keys
-		key_map_t::iterator left = right; --left;
-		F32 index_before = left->first;
-		F32 index_after = right->first;
-		RotationKey& rot_before = left->second;
-		RotationKey& rot_after = right->second;
-		if (right == mKeys.end())
-		{
-			rot_after = mLoopInKey;
-			index_after = duration;
-		}
 
-		F32 u = (time - index_before) / (index_after - index_before);
-		value = interp(u, rot_before, rot_after);
-	}
-	return value;
+	// Between two keys
+	F32 u = (time - mKeyTimes[right - 1]) / (mKeyTimes[right] - mKeyTimes[right - 1]);
+	return interp(u, mKeyValues[right - 1], mKeyValues[right]);
 }
 
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLQuaternion LLKeyframeMotion::RotationCurve::interp(F32 u, RotationKey& before, RotationKey& after)
+LLQuaternion LLKeyframeMotion::RotationCurve::interp(F32 u, const LLQuaternion& before, const LLQuaternion& after)
 {
 	switch (mInterpolationType)
 	{
 	case IT_STEP:
-		return before.mRotation;
+		return before;
 
 	default:
 	case IT_LINEAR:
 	case IT_SPLINE:
-		return nlerp(u, before.mRotation, after.mRotation);
+		return nlerp(u, before, after);
 	}
 }
 
@@ -309,46 +337,48 @@ LLKeyframeMotion::PositionCurve::~PositionCurve()
 }
 
 //-----------------------------------------------------------------------------
-// PositionCurve::getValue()
+// compile()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration)
+void LLKeyframeMotion::PositionCurve::compile()
 {
-	LLVector3 value;
+	mKeyTimes.clear();
+	mKeyValues.clear();
+	mKeyTimes.reserve(mKeys.size());
+	mKeyValues.reserve(mKeys.size());
+	for (key_map_t::iterator iter = mKeys.begin(); iter != mKeys.end(); ++iter)
+	{
+		mKeyTimes.push_back(iter->first);
+		mKeyValues.push_back(iter->second.mPosition);
+	}
+}
 
-	if (mKeys.empty())
+//-----------------------------------------------------------------------------
+// PositionCurve::getValue()
+//-----------------------------------------------------------------------------
+LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration, S32& cursor)
+{
+	if (mKeyTimes.empty())
 	{
-		value.clearVec();
-		return value;
+		return LLVector3::zero;
 	}
-	
-	key_map_t::iterator right = mKeys.lower_bound(time);
-	if (right == mKeys.end())
+
+	LLVector3 value;
+	S32 right = find_key(mKeyTimes, time, cursor);
+	if (right == (S32)mKeyTimes.size())
 	{
 		// Past last key
-		--right;
-		value = right->second.mPosition;
+		value = mKeyValues.back();
 	}
-	else if (right == mKeys.begin() || right->first == time)
+	else if (right == 0 || mKeyTimes[right] == time)
 	{
 		// Before first key or exactly on a key
-		value = right->second.mPosition;
+		value = mKeyValues[right];
 	}
 	else
 	{
 		// Between two keys
-		key_map_t::iterator left = right; --left;
-		F32 index_before = left->first;
-		F32 index_after = right->first;
-		PositionKey& pos_before = left->second;
-		PositionKey& pos_after = right->second;
-		if (right == mKeys.end())
-		{
-			pos_after = mLoopInKey;
-			index_after = duration;
-		}
-
-		F32 u = (time - index_before) / (index_after - index_before);
-		value = interp(u, pos_before, pos_after);
+		F32 u = (time - mKeyTimes[right - 1]) / (mKeyTimes[right] - mKeyTimes[right - 1]);
+		value = interp(u, mKeyValues[right - 1], mKeyValues[right]);
 	}
 
 	llassert(value.isFinite());
@@ -359,62 +389,16 @@ LLVector3 LLKeyframeMotion::PositionCurve::getValue(F32 time, F32 duration)
 //-----------------------------------------------------------------------------
 // interp()
 //-----------------------------------------------------------------------------
-LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, PositionKey& before, PositionKey& after)
+LLVector3 LLKeyframeMotion::PositionCurve::interp(F32 u, const LLVector3& before, const LLVector3& after)
 {
 	switch (mInterpolationType)
 	{
 	case IT_STEP:
-		return before.mPosition;
+		return before;
 	default:
 	case IT_LINEAR:
 	case IT_SPLINE:
-		return lerp(before.mPosition, after.mPosition, u);
-	}
-}
-
-
-//-----------------------------------------------------------------------------
-//-----------------------------------------------------------------------------
-// JointMotion class
-//-----------------------------------------------------------------------------
-//-----------------------------------------------------------------------------
-
-//-----------------------------------------------------------------------------
-// JointMotion::update()
-//-----------------------------------------------------------------------------
-void LLKeyframeMotion::JointMotion::update(LLJointState* joint_state, F32 time, F32 duration)
-{
-	// this value being 0 is the cause of https://jira.lindenlab.com/browse/SL-22678 but I haven't 
-	// managed to get a stack to see how it got here. Testing for 0 here will stop the crash.
-	if ( joint_state == NULL )
-	{
-		return;
-	}
-
-	U32 usage = joint_state->getUsage();
-
-	//-------------------------------------------------------------------------
-	// update scale component of joint state
-	//-------------------------------------------------------------------------
-	if ((usage & LLJointState::SCALE) && mScaleCurve.mNumKeys)
-	{
-		joint_state->setScale( mScaleCurve.getValue( time, duration ) );
-	}
-
-	//-------------------------------------------------------------------------
-	// update rotation component of joint state
-	//-------------------------------------------------------------------------
-	if ((usage & LLJointState::ROT) && mRotationCurve.mNumKeys)
-	{
-		joint_state->setRotation( mRotationCurve.getValue( time, duration ) );
-	}
-
-	//-------------------------------------------------------------------------
-	// update position component of joint state
-	//-------------------------------------------------------------------------
-	if ((usage & LLJointState::POS) && mPositionCurve.mNumKeys)
-	{
-		joint_state->setPosition( mPositionCurve.getValue( time, duration ) );
+		return lerp(before, after, u);
 	}
 }
 
@@ -722,17 +706,137 @@ BOOL LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 	return mLastLoopedTime <= mJointMotionList->mDuration;
 }
 
+//-----------------------------------------------------------------------------
+// nlerp_batch()
+// nlerp() for count pairs of quaternions that are in the same hemisphere,
+// four at a time.  Same steps as the scalar lerp() and normalize().
+//-----------------------------------------------------------------------------
+static void nlerp_batch(LLQuaternion* out, const LLQuaternion* a, const LLQuaternion* b, const F32* u, S32 count)
+{
+	const LLQuad one = _mm_set1_ps(1.f);
+	const LLQuad abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	const LLQuad tolerance = _mm_set1_ps(ONE_PART_IN_A_MILLION);
+	for (S32 i = 0; i < count; i += 4)
+	{
+		LLQuad ax = _mm_loadu_ps(a[i].mQ), ay = _mm_loadu_ps(a[i + 1].mQ);
+		LLQuad az = _mm_loadu_ps(a[i + 2].mQ), aw = _mm_loadu_ps(a[i + 3].mQ);
+		_MM_TRANSPOSE4_PS(ax, ay, az, aw);
+		LLQuad bx = _mm_loadu_ps(b[i].mQ), by = _mm_loadu_ps(b[i + 1].mQ);
+		LLQuad bz = _mm_loadu_ps(b[i + 2].mQ), bw = _mm_loadu_ps(b[i + 3].mQ);
+		_MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+		const LLQuad t = _mm_loadu_ps(u + i);
+		const LLQuad inv_t = _mm_sub_ps(one, t);
+		LLQuad rx = _mm_add_ps(_mm_mul_ps(t, bx), _mm_mul_ps(inv_t, ax));
+		LLQuad ry = _mm_add_ps(_mm_mul_ps(t, by), _mm_mul_ps(inv_t, ay));
+		LLQuad rz = _mm_add_ps(_mm_mul_ps(t, bz), _mm_mul_ps(inv_t, az));
+		LLQuad rw = _mm_add_ps(_mm_mul_ps(t, bw), _mm_mul_ps(inv_t, aw));
+
+		// Keys in the same hemisphere are never near FP_MAG_THRESHOLD apart,
+		// only the skip for lengths already close to unity is needed.
+		const LLQuad mag = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)),
+												  _mm_add_ps(_mm_mul_ps(rz, rz), _mm_mul_ps(rw, rw))));
+		const LLQuad renormalize = _mm_cmpgt_ps(_mm_and_ps(_mm_sub_ps(one, mag), abs_mask), tolerance);
+		const LLQuad oomag = _mm_or_ps(_mm_and_ps(renormalize, _mm_div_ps(one, mag)),
+									   _mm_andnot_ps(renormalize, one));
+		rx = _mm_mul_ps(rx, oomag);
+		ry = _mm_mul_ps(ry, oomag);
+		rz = _mm_mul_ps(rz, oomag);
+		rw = _mm_mul_ps(rw, oomag);
+
+		_MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+		_mm_storeu_ps(out[i].mQ, rx);
+		_mm_storeu_ps(out[i + 1].mQ, ry);
+		_mm_storeu_ps(out[i + 2].mQ, rz);
+		_mm_storeu_ps(out[i + 3].mQ, rw);
+	}
+}
+
 //-----------------------------------------------------------------------------
 // applyKeyframes()
 //-----------------------------------------------------------------------------
 void LLKeyframeMotion::applyKeyframes(F32 time)
 {
-	llassert_always (mJointMotionList->getNumJointMotions() <= mJointStates.size());
-	for (U32 i=0; i<mJointMotionList->getNumJointMotions(); i++)
+	const U32 num_motions = mJointMotionList->getNumJointMotions();
+	llassert_always (num_motions <= mJointStates.size());
+	llassert_always (num_motions <= LL_CHARACTER_MAX_ANIMATED_JOINTS);
+	if (mKeyCursors.size() < num_motions * 3)
+	{
+		mKeyCursors.resize(num_motions * 3, 0);
+	}
+	const F32 duration = mJointMotionList->mDuration;
+
+	// Rotations between two keys are gathered and interpolated together,
+	// padded out to a multiple of four with identity.
+	const S32 MAX_BATCH = (LL_CHARACTER_MAX_ANIMATED_JOINTS + 3) & ~3;
+	LLQuaternion rot_before[MAX_BATCH];
+	LLQuaternion rot_after[MAX_BATCH];
+	LLQuaternion rot_result[MAX_BATCH];
+	F32 rot_u[MAX_BATCH];
+	LLJointState* rot_states[MAX_BATCH];
+	S32 num_rots = 0;
+
+	for (U32 i = 0; i < num_motions; i++)
+	{
+		LLJointState* joint_state = mJointStates[i];
+		// this value being 0 is the cause of https://jira.lindenlab.com/browse/SL-22678 but I haven't 
+		// managed to get a stack to see how it got here. Testing for 0 here will stop the crash.
+		if (joint_state == NULL)
+		{
+			continue;
+		}
+
+		JointMotion* joint_motion = mJointMotionList->getJointMotion(i);
+		S32* cursors = &mKeyCursors[i * 3];
+		U32 usage = joint_state->getUsage();
+
+		if ((usage & LLJointState::SCALE) && joint_motion->mScaleCurve.mNumKeys)
+		{
+			joint_state->setScale(joint_motion->mScaleCurve.getValue(time, duration, cursors[0]));
+		}
+
+		RotationCurve& rot_curve = joint_motion->mRotationCurve;
+		if ((usage & LLJointState::ROT) && rot_curve.mNumKeys)
+		{
+			const std::vector<F32>& times = rot_curve.mKeyTimes;
+			S32 right = find_key(times, time, cursors[1]);
+			if (right == 0 || right == (S32)times.size() || times[right] == time
+				|| rot_curve.mInterpolationType == IT_STEP
+				|| dot(rot_curve.mKeyValues[right - 1], rot_curve.mKeyValues[right]) < 0.f)
+			{
+				// On a key, or needs slerp()
+				joint_state->setRotation(rot_curve.getValue(time, duration, cursors[1]));
+			}
+			else
+			{
+				rot_before[num_rots] = rot_curve.mKeyValues[right - 1];
+				rot_after[num_rots] = rot_curve.mKeyValues[right];
+				rot_u[num_rots] = (time - times[right - 1]) / (times[right] - times[right - 1]);
+				rot_states[num_rots] = joint_state;
+				num_rots++;
+			}
+		}
+
+		if ((usage & LLJointState::POS) && joint_motion->mPositionCurve.mNumKeys)
+		{
+			joint_state->setPosition(joint_motion->mPositionCurve.getValue(time, duration, cursors[2]));
+		}
+	}
+
+	if (num_rots)
 	{
-		mJointMotionList->getJointMotion(i)->update(mJointStates[i],
-													  time, 
-													  mJointMotionList->mDuration );
+		const S32 padded = (num_rots + 3) & ~3;
+		for (S32 i = num_rots; i < padded; i++)
+		{
+			rot_before[i] = LLQuaternion::DEFAULT;
+			rot_after[i] = LLQuaternion::DEFAULT;
+			rot_u[i] = 0.f;
+		}
+		nlerp_batch(rot_result, rot_before, rot_after, rot_u, padded);
+		for (S32 i = 0; i < num_rots; i++)
+		{
+			rot_states[i]->setRotation(rot_result[i]);
+		}
 	}
 
 	LLJoint::JointPriority* pose_priority = (LLJoint::JointPriority* )mCharacter->getAnimationData("Hand Pose Priority");
@@ -1687,6 +1791,9 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 			}
 		}
 
+		joint_motion->mScaleCurve.compile();
+		joint_motion->mRotationCurve.compile();
+		joint_motion->mPositionCurve.compile();
 		joint_motion->mUsage = joint_state->getUsage();
 	}
 
@@ -2231,14 +2338,15 @@ void LLKeyframeMotion::setLoopIn(F32 in_point)
 			PositionCurve* pos_curve = &joint_motion->mPositionCurve;
 			RotationCurve* rot_curve = &joint_motion->mRotationCurve;
 			ScaleCurve* scale_curve = &joint_motion->mScaleCurve;
+			S32 cursor = 0;
 			
 			pos_curve->mLoopInKey.mTime = mJointMotionList->mLoopInPoint;
 			rot_curve->mLoopInKey.mTime = mJointMotionList->mLoopInPoint;
 			scale_curve->mLoopInKey.mTime = mJointMotionList->mLoopInPoint;
 
-			pos_curve->mLoopInKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration);
-			rot_curve->mLoopInKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration);
-			scale_curve->mLoopInKey.mScale = scale_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration);
+			pos_curve->mLoopInKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration, cursor);
+			rot_curve->mLoopInKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration, cursor);
+			scale_curve->mLoopInKey.mScale = scale_curve->getValue(mJointMotionList->mLoopInPoint, mJointMotionList->mDuration, cursor);
 		}
 	}
 }
@@ -2260,14 +2368,15 @@ void LLKeyframeMotion::setLoopOut(F32 out_point)
 			PositionCurve* pos_curve = &joint_motion->mPositionCurve;
 			RotationCurve* rot_curve = &joint_motion->mRotationCurve;
 			ScaleCurve* scale_curve = &joint_motion->mScaleCurve;
+			S32 cursor = 0;
 			
 			pos_curve->mLoopOutKey.mTime = mJointMotionList->mLoopOutPoint;
 			rot_curve->mLoopOutKey.mTime = mJointMotionList->mLoopOutPoint;
 			scale_curve->mLoopOutKey.mTime = mJointMotionList->mLoopOutPoint;
 
-			pos_curve->mLoopOutKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration);
-			rot_curve->mLoopOutKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration);
-			scale_curve->mLoopOutKey.mScale = scale_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration);
+			pos_curve->mLoopOutKey.mPosition = pos_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration, cursor);
+			rot_curve->mLoopOutKey.mRotation = rot_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration, cursor);
+			scale_curve->mLoopOutKey.mScale = scale_curve->getValue(mJointMotionList->mLoopOutPoint, mJointMotionList->mDuration, cursor);
 		}
 	}
 }
@@ -320,8 +320,8 @@ public:
 	public:
 		ScaleCurve();
 		~ScaleCurve();
-		LLVector3 getValue(F32 time, F32 duration);
-		LLVector3 interp(F32 u, ScaleKey& before, ScaleKey& after);
+		LLVector3 getValue(F32 time, F32 duration, S32& cursor);
+		LLVector3 interp(F32 u, const LLVector3& before, const LLVector3& after);
 
 		InterpolationType	mInterpolationType;
 		S32					mNumKeys;
@@ -329,6 +329,11 @@ public:
 		key_map_t 			mKeys;
 		ScaleKey			mLoopInKey;
 		ScaleKey			mLoopOutKey;
+
+		// mKeys as sorted arrays, built by compile() once loaded
+		void compile();
+		std::vector<F32>		mKeyTimes;
+		std::vector<LLVector3>	mKeyValues;
 	};
 
 	//-------------------------------------------------------------------------
@@ -339,8 +344,8 @@ public:
 	public:
 		RotationCurve();
 		~RotationCurve();
-		LLQuaternion getValue(F32 time, F32 duration);
-		LLQuaternion interp(F32 u, RotationKey& before, RotationKey& after);
+		LLQuaternion getValue(F32 time, F32 duration, S32& cursor);
+		LLQuaternion interp(F32 u, const LLQuaternion& before, const LLQuaternion& after);
 
 		InterpolationType	mInterpolationType;
 		S32					mNumKeys;
@@ -348,6 +353,11 @@ public:
 		key_map_t		mKeys;
 		RotationKey		mLoopInKey;
 		RotationKey		mLoopOutKey;
+
+		// mKeys as sorted arrays, built by compile() once loaded
+		void compile();
+		std::vector<F32>		mKeyTimes;
+		std::vector<LLQuaternion>	mKeyValues;
 	};
 
 	//-------------------------------------------------------------------------
@@ -358,8 +368,8 @@ public:
 	public:
 		PositionCurve();
 		~PositionCurve();
-		LLVector3 getValue(F32 time, F32 duration);
-		LLVector3 interp(F32 u, PositionKey& before, PositionKey& after);
+		LLVector3 getValue(F32 time, F32 duration, S32& cursor);
+		LLVector3 interp(F32 u, const LLVector3& before, const LLVector3& after);
 
 		InterpolationType	mInterpolationType;
 		S32					mNumKeys;
@@ -367,6 +377,11 @@ public:
 		key_map_t		mKeys;
 		PositionKey		mLoopInKey;
 		PositionKey		mLoopOutKey;
+
+		// mKeys as sorted arrays, built by compile() once loaded
+		void compile();
+		std::vector<F32>		mKeyTimes;
+		std::vector<LLVector3>	mKeyValues;
 	};
 
 	//-------------------------------------------------------------------------
@@ -381,8 +396,6 @@ public:
 		std::string		mJointName;
 		U32				mUsage;
 		LLJoint::JointPriority	mPriority;
-
-		void update(LLJointState* joint_state, F32 time, F32 duration);
 	};
 	
 	//-------------------------------------------------------------------------
@@ -430,6 +443,7 @@ protected:
 	typedef std::list<JointConstraint*>	constraint_list_t;
 	constraint_list_t				mConstraints;
 	U32								mLastSkeletonSerialNum;
+	std::vector<S32>				mKeyCursors;	// per joint scale, rotation and position key last sampled
 	F32								mLastUpdateTime;
 	F32								mLastLoopedTime;
 	AssetStatus						mAssetStatus;
@@ -0,0 +1,218 @@
+/** 
+ * @file llskeletonupdater.cpp
+ * @brief Propagates skeleton world matrices on worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "linden_common.h"
+
+#include "llskeletonupdater.h"
+
+#include <algorithm>
+
+#include "llapr.h"
+#include "llfasttimer.h"
+#include "llflatskeleton.h"
+#include "lljoint.h"
+#include "llmutex.h"
+#include "llthread.h"
+#include "lltracethreadrecorder.h"
+
+// Waking the threads costs more than updating a few skeletons.
+const U32 MIN_THREADED_SKELETONS = 4;
+
+static LLTrace::BlockTimerStatHandle FTM_SKELETON_UPDATE("Skeleton Update");
+
+// The threads wait on sCondition for flush() to bump sGeneration, and
+// flush() waits on it for sBusyThreads to drop to zero.  All three are
+// only read or changed with sCondition locked.
+static LLCondition* sCondition = NULL;
+static U32 sGeneration = 0;
+static S32 sBusyThreads = 0;
+static bool sQuitting = false;
+
+static LLAtomicS32 sNextJob(0);
+static LLAtomicS32 sJointUpdates(0);
+
+LLSkeletonUpdater::skeleton_list_t LLSkeletonUpdater::sQueued;
+LLSkeletonUpdater::thread_list_t LLSkeletonUpdater::sThreads;
+S32 LLSkeletonUpdater::sLastJointUpdates = 0;
+
+class LLSkeletonUpdater::WorkerThread : public LLThread
+{
+public:
+	WorkerThread(const std::string& name) :
+		LLThread(name)
+	{
+	}
+
+private:
+	// virtual
+	void run()
+	{
+		U32 generation = 0;
+		sCondition->lock();
+		while (1)
+		{
+			while (generation == sGeneration && !sQuitting)
+			{
+				sCondition->wait();
+			}
+			if (sQuitting)
+			{
+				break;
+			}
+			generation = sGeneration;
+			sCondition->unlock();
+
+			LLSkeletonUpdater::updateQueued();
+
+			sCondition->lock();
+			if (--sBusyThreads == 0)
+			{
+				sCondition->broadcast();
+			}
+		}
+		sCondition->unlock();
+
+		LLTrace::get_thread_recorder()->pushToParent();
+	}
+};
+
+// static
+void LLSkeletonUpdater::initClass(S32 num_threads)
+{
+	if (num_threads <= 0)
+	{
+		return;
+	}
+
+	sCondition = new LLCondition(NULL);
+	sQuitting = false;
+	for (S32 i = 0; i < num_threads; i++)
+	{
+		WorkerThread* thread = new WorkerThread(llformat("Skeleton Update %d", i));
+		sThreads.push_back(thread);
+		thread->start();
+	}
+}
+
+// static
+void LLSkeletonUpdater::cleanupClass()
+{
+	flush();
+
+	if (sCondition)
+	{
+		sCondition->lock();
+		sQuitting = true;
+		sCondition->broadcast();
+		sCondition->unlock();
+	}
+
+	// ~LLThread() waits for each thread to stop
+	for (thread_list_t::iterator iter = sThreads.begin(); iter != sThreads.end(); ++iter)
+	{
+		delete *iter;
+	}
+	sThreads.clear();
+
+	delete sCondition;
+	sCondition = NULL;
+}
+
+// static
+void LLSkeletonUpdater::queue(LLFlatSkeleton* skeleton)
+{
+	if (sThreads.empty())
+	{
+		skeleton->updateWorldMatrices();
+		return;
+	}
+
+	// Two threads updating the same skeleton would race, only queue it once.
+	if (std::find(sQueued.begin(), sQueued.end(), skeleton) == sQueued.end())
+	{
+		sQueued.push_back(skeleton);
+	}
+}
+
+// static
+void LLSkeletonUpdater::dequeue(LLFlatSkeleton* skeleton)
+{
+	sQueued.erase(std::remove(sQueued.begin(), sQueued.end(), skeleton), sQueued.end());
+}
+
+// static
+void LLSkeletonUpdater::flush()
+{
+	if (sQueued.empty())
+	{
+		return;
+	}
+
+	LL_RECORD_BLOCK_TIME(FTM_SKELETON_UPDATE);
+
+	sNextJob = 0;
+	sJointUpdates = 0;
+	if (sQueued.size() >= MIN_THREADED_SKELETONS && !sThreads.empty())
+	{
+		sCondition->lock();
+		sBusyThreads = (S32)sThreads.size();
+		++sGeneration;
+		sCondition->broadcast();
+		sCondition->unlock();
+
+		updateQueued();
+
+		// Everything is taken by now, wait for the last ones to finish.
+		sCondition->lock();
+		while (sBusyThreads > 0)
+		{
+			sCondition->wait();
+		}
+		sCondition->unlock();
+	}
+	else
+	{
+		updateQueued();
+	}
+	sLastJointUpdates = sJointUpdates.CurrentValue();
+	sQueued.clear();
+}
+
+// static
+// Called on the main and worker threads at once, each takes the next
+// skeleton nobody has started on.
+void LLSkeletonUpdater::updateQueued()
+{
+	const S32 count = (S32)sQueued.size();
+	LLJoint::sNumUpdates = 0;
+	for (S32 i = sNextJob++; i < count; i = sNextJob++)
+	{
+		sQueued[i]->updateWorldMatrices();
+	}
+	// LLJoint's counts are per thread, gather them for getLastJointUpdates()
+	sJointUpdates += LLJoint::sNumUpdates;
+}
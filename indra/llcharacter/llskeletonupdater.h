@@ -0,0 +1,72 @@
+/** 
+ * @file llskeletonupdater.h
+ * @brief Propagates skeleton world matrices on worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ * 
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLSKELETONUPDATER_H
+#define LL_LLSKELETONUPDATER_H
+
+#include <vector>
+
+class LLFlatSkeleton;
+
+// Each frame the avatars queue their skeleton after animating it, and
+// flush() brings every queued skeleton's world matrices up to date before
+// rendering.  Skeletons don't share joints, so they are updated on as many
+// threads as were set up, the calling thread included.
+//
+// Between queue() and flush() the main thread may still read the joints,
+// the world matrix getters update whatever they need themselves.  It must
+// not read or change a queued skeleton from elsewhere while flush() runs.
+class LLSkeletonUpdater
+{
+public:
+	// num_threads extra threads.  With none queue() updates the skeleton
+	// right away, as the avatars did before.
+	static void initClass(S32 num_threads);
+	static void cleanupClass();
+
+	static void queue(LLFlatSkeleton* skeleton);
+	static void dequeue(LLFlatSkeleton* skeleton);
+
+	static void flush();
+
+	// Joint world matrix updates done by the last flush(), on all threads
+	static S32 getLastJointUpdates() { return sLastJointUpdates; }
+
+private:
+	class WorkerThread;
+	static void updateQueued();
+
+	typedef std::vector<LLFlatSkeleton*> skeleton_list_t;
+	static skeleton_list_t sQueued;
+
+	typedef std::vector<WorkerThread*> thread_list_t;
+	static thread_list_t sThreads;
+
+	static S32 sLastJointUpdates;
+};
+
+#endif // LL_LLSKELETONUPDATER_H
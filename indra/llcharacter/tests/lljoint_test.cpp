@@ -221,6 +221,37 @@ namespace tut
 		ensure("2. addChild failed to remove prior parent", llparent1.findJoint("child2") == NULL);
 	}
 
+	template<> template<>
+	void lljoint_object::test<15>()
+	{
+		LLJoint llroot1("root1");
+		LLJoint llroot2("root2");
+		LLJoint llparent("parent", &llroot1);
+		LLJoint llchild("child");
+
+		U32 root1 = llroot1.mHierarchyVersion;
+		U32 parent = llparent.mHierarchyVersion;
+		U32 root2 = llroot2.mHierarchyVersion;
+		llparent.addChild(&llchild);
+		ensure("addChild() did not change the parent's version", llparent.mHierarchyVersion != parent);
+		ensure("addChild() did not change the root's version", llroot1.mHierarchyVersion != root1);
+		ensure_equals("addChild() changed another hierarchy's version", llroot2.mHierarchyVersion, root2);
+
+		root1 = llroot1.mHierarchyVersion;
+		U32 child = llchild.mHierarchyVersion;
+		llroot2.addChild(&llchild);
+		ensure("moving a joint did not change the old root's version", llroot1.mHierarchyVersion != root1);
+		ensure("moving a joint did not change the new root's version", llroot2.mHierarchyVersion != root2);
+		ensure_equals("moving a joint changed its own version", llchild.mHierarchyVersion, child);
+
+		root2 = llroot2.mHierarchyVersion;
+		llroot2.removeAllChildren();
+		ensure("removeAllChildren() did not change the version", llroot2.mHierarchyVersion != root2);
+		root2 = llroot2.mHierarchyVersion;
+		llroot2.removeAllChildren();
+		ensure_equals("removeAllChildren() with no children changed the version", llroot2.mHierarchyVersion, root2);
+	}
+
 
 	/*
 		Test cases for the following not added. They perform operations 
@@ -30,15 +30,62 @@
 #include "lltimer.h"	// ms_sleep()
 #include "lltracethreadrecorder.h"
 
+//============================================================================
+// Extra worker threads for an LLQueuedThread created with num_threads > 1.
+// They share the owner's request queue and data lock, so priorities,
+// setPriority() and abortRequest() behave exactly as with a single thread.
+
+class LLQueuedThread::HelperThread : public LLThread
+{
+public:
+	HelperThread(const std::string& name, LLQueuedThread* queued_thread) :
+		LLThread(name),
+		mQueuedThread(queued_thread)
+	{
+	}
+
+	void quit() { setQuitting(); }
+
+private:
+	// virtual
+	bool runCondition()
+	{
+		// mRunCondition must be locked here
+		return !mQueuedThread->isPaused() && mQueuedThread->hasQueuedRequests();
+	}
+
+	// virtual
+	void run()
+	{
+		while (1)
+		{
+			checkPause();
+
+			if (isQuitting() || mQueuedThread->isQuitting() || mQueuedThread->isStopped())
+			{
+				LLTrace::get_thread_recorder()->pushToParent();
+				break;
+			}
+
+			mQueuedThread->mBusyHelpers++;
+			mQueuedThread->processNextRequest();
+			mQueuedThread->mBusyHelpers--;
+		}
+	}
+
+	LLQueuedThread* mQueuedThread;
+};
+
 //============================================================================
 
 // MAIN THREAD
-LLQueuedThread::LLQueuedThread(const std::string& name, bool threaded, bool should_pause) :
+LLQueuedThread::LLQueuedThread(const std::string& name, bool threaded, bool should_pause, S32 num_threads) :
 	LLThread(name),
 	mThreaded(threaded),
 	mIdleThread(TRUE),
 	mNextHandle(0),
-	mStarted(FALSE)
+	mStarted(FALSE),
+	mBusyHelpers(0)
 {
 	if (mThreaded)
 	{
@@ -48,6 +95,13 @@ LLQueuedThread::LLQueuedThread(const std::string& name, bool threaded, bool shou
 		}
 
 		start();
+
+		for (S32 i = 1; i < num_threads; i++)
+		{
+			HelperThread* helper = new HelperThread(llformat("%s %d", name.c_str(), i), this);
+			mHelperThreads.push_back(helper);
+			helper->start();
+		}
 	}
 }
 
@@ -65,6 +119,10 @@ LLQueuedThread::~LLQueuedThread()
 void LLQueuedThread::shutdown()
 {
 	setQuitting();
+	for (helper_list_t::iterator iter = mHelperThreads.begin(); iter != mHelperThreads.end(); ++iter)
+	{
+		(*iter)->quit();
+	}
 
 	unpause(); // MAIN THREAD
 	if (mThreaded)
@@ -83,6 +141,13 @@ void LLQueuedThread::shutdown()
 		{
 			LL_WARNS() << "~LLQueuedThread (" << mName << ") timed out!" << LL_ENDL;
 		}
+
+		// ~LLThread() waits for each helper to leave run()
+		for (helper_list_t::iterator iter = mHelperThreads.begin(); iter != mHelperThreads.end(); ++iter)
+		{
+			delete *iter;
+		}
+		mHelperThreads.clear();
 	}
 	else
 	{
@@ -135,8 +200,9 @@ S32 LLQueuedThread::updateQueue(F32 max_time_ms)
 		pending = getPending();
 		if(pending > 0)
 		{
-		unpause();
-	}
+			unpause();
+			wakeHelpers();
+		}
 	}
 	else
 	{
@@ -158,10 +224,28 @@ void LLQueuedThread::incQueue()
 		if (mThreaded)
 		{
 			wake(); // Wake the thread up if necessary.
+			wakeHelpers();
 		}
 	}
 }
 
+void LLQueuedThread::wakeHelpers()
+{
+	for (helper_list_t::iterator iter = mHelperThreads.begin(); iter != mHelperThreads.end(); ++iter)
+	{
+		(*iter)->wake();
+	}
+}
+
+// Called from helper threads, must not call virtual methods (see HelperThread::runCondition())
+bool LLQueuedThread::hasQueuedRequests()
+{
+	lockData();
+	bool res = !mRequestQueue.empty();
+	unlockData();
+	return res;
+}
+
 //virtual
 // May be called from any thread
 S32 LLQueuedThread::getPending()
@@ -180,7 +264,7 @@ void LLQueuedThread::waitOnPending()
 	{
 		update(0);
 
-		if (mIdleThread)
+		if (mIdleThread && mBusyHelpers == 0)
 		{
 			break;
 		}
@@ -149,7 +149,9 @@ public:
 	static handle_t nullHandle() { return handle_t(0); }
 	
 public:
-	LLQueuedThread(const std::string& name, bool threaded = true, bool should_pause = false);
+	// num_threads > 1 adds helper threads that pull requests from the same
+	// priority queue. Only use it when requests are safe to process concurrently.
+	LLQueuedThread(const std::string& name, bool threaded = true, bool should_pause = false, S32 num_threads = 1);
 	virtual ~LLQueuedThread();	
 	virtual void shutdown();
 	
@@ -164,6 +166,10 @@ private:
 	virtual void endThread(void);
 	virtual void threadedUpdate(void);
 
+	class HelperThread;
+	void wakeHelpers();
+	bool hasQueuedRequests();
+
 protected:
 	handle_t generateHandle();
 	bool addRequest(QueuedRequest* req);
@@ -181,6 +187,7 @@ public:
 
 	virtual S32 getPending();
 	bool getThreaded() { return mThreaded ? true : false; }
+	S32 getNumThreads() { return mThreaded ? (S32)mHelperThreads.size() + 1 : 1; }
 
 	// Request accessors
 	status_t getRequestStatus(handle_t handle);
@@ -208,6 +215,11 @@ protected:
 	request_hash_t mRequestHash;
 
 	handle_t mNextHandle;
+
+private:
+	typedef std::vector<HelperThread*> helper_list_t;
+	helper_list_t mHelperThreads;
+	LLAtomic32<S32> mBusyHelpers; // helper threads currently inside processNextRequest()
 };
 
 #endif // LL_LLQUEUEDTHREAD_H
@@ -0,0 +1,478 @@
+/**
+ * @file llsdbinaryview.cpp
+ * @brief Read only, on demand access to binary serialized LLSD.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llsdbinaryview.h"
+#include "llsdserialize.h"
+
+#if !LL_WINDOWS
+#include <netinet/in.h> // htonl & ntohl
+#endif
+
+// Same nesting limit unzip_llsd() uses when it parses.
+static const S32 MAX_VIEW_DEPTH = 96;
+
+static bool read_size(const U8* p, const U8* end, S32& size)
+{
+	if (end - p < (S32)sizeof(U32))
+	{
+		return false;
+	}
+	U32 value_nbo;
+	memcpy(&value_nbo, p, sizeof(U32));		/* Flawfinder: ignore */
+	size = (S32)ntohl(value_nbo);
+	return true;
+}
+
+// Find the end of a notation style string, p is just past the opening
+// delimiter. Returns the position of the closing delimiter or NULL.
+static const U8* find_delim(const U8* p, const U8* end, U8 delim, bool* escaped = NULL)
+{
+	while (p < end)
+	{
+		if (*p == '\\')
+		{
+			// \xNN hex digits can never be the delimiter, so skipping the
+			// one character after the backslash is enough.
+			if (escaped)
+			{
+				*escaped = true;
+			}
+			p += 2;
+		}
+		else if (*p == delim)
+		{
+			return p;
+		}
+		else
+		{
+			++p;
+		}
+	}
+	return NULL;
+}
+
+// Returns the first byte after the value starting at p, or NULL if it is
+// malformed or runs past end.
+static const U8* skip_value(const U8* p, const U8* end, S32 depth)
+{
+	if (p >= end || depth > MAX_VIEW_DEPTH)
+	{
+		return NULL;
+	}
+
+	S32 fixed = 0;
+	switch (*p)
+	{
+	case '!':
+	case '0':
+	case '1':
+		fixed = 1;
+		break;
+	case 'i':
+		fixed = 1 + sizeof(U32);
+		break;
+	case 'r':
+	case 'd':
+		fixed = 1 + sizeof(F64);
+		break;
+	case 'u':
+		fixed = 1 + UUID_BYTES;
+		break;
+	case 's':
+	case 'l':
+	case 'b':
+	{
+		S32 size = 0;
+		if (!read_size(p + 1, end, size) || size < 0)
+		{
+			return NULL;
+		}
+		p += 1 + sizeof(U32);
+		return (end - p >= size) ? p + size : NULL;
+	}
+	case '\'':
+	case '"':
+	{
+		const U8* close = find_delim(p + 1, end, *p);
+		return close ? close + 1 : NULL;
+	}
+	case '[':
+	{
+		S32 size = 0;
+		if (!read_size(p + 1, end, size))
+		{
+			return NULL;
+		}
+		p += 1 + sizeof(U32);
+		for (S32 i = 0; i < size && p; ++i)
+		{
+			p = skip_value(p, end, depth + 1);
+		}
+		return (p && p < end && *p == ']') ? p + 1 : NULL;
+	}
+	case '{':
+	{
+		S32 size = 0;
+		if (!read_size(p + 1, end, size))
+		{
+			return NULL;
+		}
+		p += 1 + sizeof(U32);
+		for (S32 i = 0; i < size && p; ++i)
+		{
+			// keys are 's' style strings marked with 'k', or notation strings
+			if (p < end && *p == 'k')
+			{
+				S32 len = 0;
+				if (!read_size(p + 1, end, len) || len < 0 || end - p - 5 < len)
+				{
+					return NULL;
+				}
+				p += 1 + sizeof(U32) + len;
+			}
+			else
+			{
+				p = skip_value(p, end, depth + 1);
+			}
+			if (p)
+			{
+				p = skip_value(p, end, depth + 1);
+			}
+		}
+		return (p && p < end && *p == '}') ? p + 1 : NULL;
+	}
+	default:
+		return NULL;
+	}
+
+	return (end - p >= fixed) ? p + fixed : NULL;
+}
+
+/**
+ * LLSDBinaryView
+ */
+LLSDBinaryView::LLSDBinaryView()
+:	mBegin(NULL),
+	mEnd(NULL)
+{
+}
+
+LLSDBinaryView::LLSDBinaryView(const U8* buf, S32 size)
+:	mBegin(buf),
+	mEnd(buf ? buf + llmax(size, 0) : NULL)
+{
+}
+
+LLSD::Type LLSDBinaryView::type() const
+{
+	if (mBegin >= mEnd)
+	{
+		return LLSD::TypeUndefined;
+	}
+	switch (*mBegin)
+	{
+	case '0':
+	case '1':
+		return LLSD::TypeBoolean;
+	case 'i':
+		return LLSD::TypeInteger;
+	case 'r':
+		return LLSD::TypeReal;
+	case 's':
+	case '\'':
+	case '"':
+		return LLSD::TypeString;
+	case 'u':
+		return LLSD::TypeUUID;
+	case 'd':
+		return LLSD::TypeDate;
+	case 'l':
+		return LLSD::TypeURI;
+	case 'b':
+		return LLSD::TypeBinary;
+	case '{':
+		return LLSD::TypeMap;
+	case '[':
+		return LLSD::TypeArray;
+	default:
+		return LLSD::TypeUndefined;
+	}
+}
+
+S32 LLSDBinaryView::size() const
+{
+	S32 size = 0;
+	if ((isMap() || isArray()) && read_size(mBegin + 1, mEnd, size))
+	{
+		return llmax(size, 0);
+	}
+	return 0;
+}
+
+bool LLSDBinaryView::has(const std::string& key) const
+{
+	return get(key).isDefined();
+}
+
+LLSDBinaryView LLSDBinaryView::get(const std::string& key) const
+{
+	for (map_const_iterator it = beginMap(), end = endMap(); it != end; ++it)
+	{
+		if (it.keyEquals(key))
+		{
+			return it.value();
+		}
+	}
+	return LLSDBinaryView();
+}
+
+LLSDBinaryView LLSDBinaryView::get(S32 index) const
+{
+	if (!isArray() || index < 0 || index >= size())
+	{
+		return LLSDBinaryView();
+	}
+	const U8* p = mBegin + 1 + sizeof(U32);
+	for (S32 i = 0; i < index && p; ++i)
+	{
+		p = skip_value(p, mEnd, 1);
+	}
+	if (!p)
+	{
+		return LLSDBinaryView();
+	}
+	return LLSDBinaryView(p, (S32)(mEnd - p));
+}
+
+LLSD::Boolean LLSDBinaryView::asBoolean() const
+{
+	if (mBegin < mEnd && (*mBegin == '0' || *mBegin == '1'))
+	{
+		return *mBegin == '1';
+	}
+	return asLLSD().asBoolean();
+}
+
+LLSD::Integer LLSDBinaryView::asInteger() const
+{
+	if (type() == LLSD::TypeInteger)
+	{
+		S32 value = 0;
+		return read_size(mBegin + 1, mEnd, value) ? value : 0;
+	}
+	return asLLSD().asInteger();
+}
+
+LLSD::Real LLSDBinaryView::asReal() const
+{
+	return asLLSD().asReal();
+}
+
+LLSD::String LLSDBinaryView::asString() const
+{
+	if (mBegin < mEnd && *mBegin == 's')
+	{
+		S32 len = 0;
+		if (read_size(mBegin + 1, mEnd, len) && len >= 0 && mEnd - mBegin - 5 >= len)
+		{
+			return std::string((const char*)mBegin + 1 + sizeof(U32), len);
+		}
+		return std::string();
+	}
+	return asLLSD().asString();
+}
+
+LLSD::UUID LLSDBinaryView::asUUID() const
+{
+	LLUUID id;
+	if (type() == LLSD::TypeUUID)
+	{
+		if (mEnd - mBegin >= 1 + UUID_BYTES)
+		{
+			memcpy(id.mData, mBegin + 1, UUID_BYTES);	/* Flawfinder: ignore */
+		}
+		return id;
+	}
+	return asLLSD().asUUID();
+}
+
+LLSD::Date LLSDBinaryView::asDate() const
+{
+	return asLLSD().asDate();
+}
+
+LLSD::URI LLSDBinaryView::asURI() const
+{
+	return asLLSD().asURI();
+}
+
+LLSD::Binary LLSDBinaryView::asBinary() const
+{
+	if (type() == LLSD::TypeBinary)
+	{
+		S32 len = 0;
+		if (read_size(mBegin + 1, mEnd, len) && len >= 0 && mEnd - mBegin - 5 >= len)
+		{
+			const U8* data = mBegin + 1 + sizeof(U32);
+			return LLSD::Binary(data, data + len);
+		}
+		return LLSD::Binary();
+	}
+	return asLLSD().asBinary();
+}
+
+LLSD LLSDBinaryView::asLLSD() const
+{
+	LLSD sd;
+	if (mBegin < mEnd)
+	{
+		LLSDSerialize::fromBinary(sd, mBegin, (S32)(mEnd - mBegin), MAX_VIEW_DEPTH);
+	}
+	return sd;
+}
+
+S32 LLSDBinaryView::encodedSize() const
+{
+	const U8* next = skip_value(mBegin, mEnd, 0);
+	return next ? (S32)(next - mBegin) : 0;
+}
+
+LLSDBinaryView::map_const_iterator LLSDBinaryView::beginMap() const
+{
+	S32 count = size();
+	if (!isMap() || count == 0)
+	{
+		return endMap();
+	}
+	return map_const_iterator(mBegin + 1 + sizeof(U32), mEnd, count);
+}
+
+LLSDBinaryView::map_const_iterator LLSDBinaryView::endMap() const
+{
+	return map_const_iterator();
+}
+
+/**
+ * LLSDBinaryView::map_const_iterator
+ */
+LLSDBinaryView::map_const_iterator::map_const_iterator()
+:	mCur(NULL),
+	mEnd(NULL),
+	mRemaining(0),
+	mKey(NULL),
+	mKeyLen(0),
+	mKeyEscaped(false)
+{
+}
+
+LLSDBinaryView::map_const_iterator::map_const_iterator(const U8* cur, const U8* end, S32 remaining)
+:	mCur(cur),
+	mEnd(end),
+	mRemaining(remaining),
+	mKey(NULL),
+	mKeyLen(0),
+	mKeyEscaped(false)
+{
+	load();
+}
+
+void LLSDBinaryView::map_const_iterator::load()
+{
+	const U8* value = NULL;
+	mKeyEscaped = false;
+	if (mCur && mRemaining > 0 && mCur < mEnd)
+	{
+		if (*mCur == 'k')
+		{
+			S32 len = 0;
+			if (read_size(mCur + 1, mEnd, len) && len >= 0 && mEnd - mCur - 5 >= len)
+			{
+				mKey = mCur + 1 + sizeof(U32);
+				mKeyLen = len;
+				value = mKey + len;
+			}
+		}
+		else if (*mCur == '\'' || *mCur == '"')
+		{
+			const U8* close = find_delim(mCur + 1, mEnd, *mCur, &mKeyEscaped);
+			if (close)
+			{
+				mKey = mCur + 1;
+				mKeyLen = (S32)(close - mKey);
+				value = close + 1;
+			}
+		}
+	}
+
+	if (value && value < mEnd)
+	{
+		mValue = LLSDBinaryView(value, (S32)(mEnd - value));
+	}
+	else
+	{
+		// done or malformed, either way become the end iterator
+		*this = map_const_iterator();
+	}
+}
+
+bool LLSDBinaryView::map_const_iterator::operator==(const map_const_iterator& rhs) const
+{
+	return mCur == rhs.mCur && mRemaining == rhs.mRemaining;
+}
+
+LLSDBinaryView::map_const_iterator& LLSDBinaryView::map_const_iterator::operator++()
+{
+	if (mCur)
+	{
+		mCur = skip_value(mValue.mBegin, mEnd, 1);
+		--mRemaining;
+		load();
+	}
+	return *this;
+}
+
+std::string LLSDBinaryView::map_const_iterator::key() const
+{
+	if (!mKeyEscaped)
+	{
+		return std::string((const char*)mKey, mKeyLen);
+	}
+	// A notation style key is also a valid binary LLSD string value,
+	// let the parser deal with the escapes.
+	LLSD sd;
+	LLSDSerialize::fromBinary(sd, mCur, (S32)(mEnd - mCur));
+	return sd.asString();
+}
+
+bool LLSDBinaryView::map_const_iterator::keyEquals(const std::string& key) const
+{
+	if (!mKeyEscaped)
+	{
+		return mKeyLen == (S32)key.size() && !memcmp(mKey, key.data(), mKeyLen);
+	}
+	return this->key() == key;
+}
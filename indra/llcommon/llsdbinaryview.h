@@ -0,0 +1,126 @@
+/**
+ * @file llsdbinaryview.h
+ * @brief Read only, on demand access to binary serialized LLSD.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSDBINARYVIEW_H
+#define LL_LLSDBINARYVIEW_H
+
+#include "llsd.h"
+
+/**
+ * @class LLSDBinaryView
+ * @brief A read only view of one value in a binary LLSD buffer.
+ *
+ * Nothing is parsed up front. Map and array lookups walk the encoded
+ * data, skipping values they do not need. Scalars are decoded only when
+ * asked for. Reading a few keys out of a large document therefore costs
+ * about what is read, not the size of the whole tree.
+ *
+ * Use asLLSD() on any subtree to get a regular LLSD for the llsdutil
+ * helpers or for code that needs one.
+ *
+ * The view does not own the buffer. The caller must keep the memory
+ * valid for as long as this view, or any view taken from it, is used.
+ * Reads never go past the end of the buffer, malformed or truncated
+ * values read as undefined or as their type's default.
+ *
+ * Every map lookup is a linear walk of that map. When reading many
+ * keys from the same map, walk it once with beginMap()/endMap().
+ */
+class LL_COMMON_API LLSDBinaryView
+{
+public:
+	LLSDBinaryView();
+	LLSDBinaryView(const U8* buf, S32 size);
+
+	LLSD::Type type() const;
+	bool isUndefined() const	{ return type() == LLSD::TypeUndefined; }
+	bool isDefined() const		{ return !isUndefined(); }
+	bool isMap() const			{ return type() == LLSD::TypeMap; }
+	bool isArray() const		{ return type() == LLSD::TypeArray; }
+
+	// Number of entries in a map or array, 0 for anything else.
+	S32 size() const;
+
+	bool has(const std::string& key) const;
+	LLSDBinaryView get(const std::string& key) const;
+	LLSDBinaryView get(S32 index) const;
+	LLSDBinaryView operator[](const std::string& key) const	{ return get(key); }
+	LLSDBinaryView operator[](const char* key) const		{ return get(std::string(key)); }
+	LLSDBinaryView operator[](S32 index) const				{ return get(index); }
+
+	// Same conversions as the LLSD accessors of the same name.
+	LLSD::Boolean	asBoolean() const;
+	LLSD::Integer	asInteger() const;
+	LLSD::Real		asReal() const;
+	LLSD::String	asString() const;
+	LLSD::UUID		asUUID() const;
+	LLSD::Date		asDate() const;
+	LLSD::URI		asURI() const;
+	LLSD::Binary	asBinary() const;
+
+	// Fully parse this value and everything under it.
+	LLSD asLLSD() const;
+
+	// Bytes this value occupies in the buffer, 0 if it is malformed.
+	S32 encodedSize() const;
+
+	class map_const_iterator;
+	map_const_iterator beginMap() const;
+	map_const_iterator endMap() const;
+
+private:
+	const U8* mBegin;	// first byte of this value
+	const U8* mEnd;		// end of the underlying buffer
+};
+
+class LL_COMMON_API LLSDBinaryView::map_const_iterator
+{
+public:
+	map_const_iterator();
+
+	bool operator==(const map_const_iterator& rhs) const;
+	bool operator!=(const map_const_iterator& rhs) const { return !(*this == rhs); }
+	map_const_iterator& operator++();
+
+	std::string key() const;
+	bool keyEquals(const std::string& key) const;
+	const LLSDBinaryView& value() const { return mValue; }
+
+private:
+	friend class LLSDBinaryView;
+	map_const_iterator(const U8* cur, const U8* end, S32 remaining);
+	void load();
+
+	const U8* mCur;		// start of the current key
+	const U8* mEnd;		// end of the underlying buffer
+	S32 mRemaining;		// entries left, including the current one
+	const U8* mKey;		// raw key characters
+	S32 mKeyLen;
+	bool mKeyEscaped;	// notation style key with escapes in it
+	LLSDBinaryView mValue;
+};
+
+#endif // LL_LLSDBINARYVIEW_H
@@ -32,6 +32,7 @@
 #include "llstreamtools.h" // for fullread
 
 #include <iostream>
+#include <boost/unordered_map.hpp>
 #include "apr_base64.h"
 
 #ifdef LL_USESYSTEMLIBS
@@ -309,20 +310,78 @@ static const char BINARY_FALSE_SERIAL = '0';
 /**
  * LLSDParser
  */
+// Values seen so far in one parse, keyed by what they hold. Reals
+// and dates are keyed by bit pattern so -0.0 and NaNs stay distinct.
+struct LLSDParser::SharedValues
+{
+	struct uuid_hash
+	{
+		size_t operator()(const LLUUID& id) const { return id.getCRC32(); }
+	};
+
+	LLSD mFalse;
+	LLSD mTrue;
+	boost::unordered_map<LLSD::Integer, LLSD> mIntegers;
+	boost::unordered_map<U64, LLSD> mReals;
+	boost::unordered_map<LLSD::String, LLSD> mStrings;
+	boost::unordered_map<LLSD::UUID, LLSD, uuid_hash> mUUIDs;
+	boost::unordered_map<U64, LLSD> mDates;
+	boost::unordered_map<LLSD::String, LLSD> mURIs;
+
+	void clear()
+	{
+		mFalse.clear();
+		mTrue.clear();
+		mIntegers.clear();
+		mReals.clear();
+		mStrings.clear();
+		mUUIDs.clear();
+		mDates.clear();
+		mURIs.clear();
+	}
+};
+
+namespace
+{
+	U64 real_bits(F64 real)
+	{
+		U64 bits;
+		memcpy(&bits, &real, sizeof(bits));
+		return bits;
+	}
+
+	// Point data at the value already stored in slot, storing value
+	// there first if this is the first time it has been seen.
+	template<typename T>
+	void assign_shared(LLSD& slot, LLSD& data, const T& value)
+	{
+		if (slot.isUndefined())
+		{
+			slot = value;
+		}
+		data = slot;
+	}
+}
+
 LLSDParser::LLSDParser()
-	: mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false)
+	: mCheckLimits(true), mMaxBytesLeft(0), mParseLines(false),
+	  mSharedValues(NULL)
 {
 }
 
 // virtual
 LLSDParser::~LLSDParser()
-{ }
+{
+	delete mSharedValues;
+}
 
 S32 LLSDParser::parse(std::istream& istr, LLSD& data, S32 max_bytes, S32 max_depth)
 {
 	mCheckLimits = (LLSDSerialize::SIZE_UNLIMITED == max_bytes) ? false : true;
 	mMaxBytesLeft = max_bytes;
-	return doParse(istr, data, max_depth);
+	S32 parse_count = doParse(istr, data, max_depth);
+	clearSharedValues();
+	return parse_count;
 }
 
 
@@ -331,7 +390,106 @@ S32 LLSDParser::parseLines(std::istream& istr, LLSD& data)
 {
 	mCheckLimits = false;
 	mParseLines = true;
-	return doParse(istr, data);
+	S32 parse_count = doParse(istr, data);
+	clearSharedValues();
+	return parse_count;
+}
+
+void LLSDParser::reset()
+{
+	clearSharedValues();
+	doReset();
+}
+
+void LLSDParser::setShareValues(bool share)
+{
+	if (share && !mSharedValues)
+	{
+		mSharedValues = new SharedValues;
+	}
+	else if (!share && mSharedValues)
+	{
+		delete mSharedValues;
+		mSharedValues = NULL;
+	}
+}
+
+void LLSDParser::clearSharedValues() const
+{
+	if (mSharedValues)
+	{
+		mSharedValues->clear();
+	}
+}
+
+void LLSDParser::assignValue(LLSD& data, LLSD::Boolean value) const
+{
+	if (!mSharedValues)
+	{
+		data = value;
+		return;
+	}
+	assign_shared(value ? mSharedValues->mTrue : mSharedValues->mFalse, data, value);
+}
+
+void LLSDParser::assignValue(LLSD& data, LLSD::Integer value) const
+{
+	if (!mSharedValues)
+	{
+		data = value;
+		return;
+	}
+	assign_shared(mSharedValues->mIntegers[value], data, value);
+}
+
+void LLSDParser::assignValue(LLSD& data, LLSD::Real value) const
+{
+	if (!mSharedValues)
+	{
+		data = value;
+		return;
+	}
+	assign_shared(mSharedValues->mReals[real_bits(value)], data, value);
+}
+
+void LLSDParser::assignValue(LLSD& data, const LLSD::String& value) const
+{
+	if (!mSharedValues)
+	{
+		data = value;
+		return;
+	}
+	assign_shared(mSharedValues->mStrings[value], data, value);
+}
+
+void LLSDParser::assignValue(LLSD& data, const LLSD::UUID& value) const
+{
+	if (!mSharedValues)
+	{
+		data = value;
+		return;
+	}
+	assign_shared(mSharedValues->mUUIDs[value], data, value);
+}
+
+void LLSDParser::assignValue(LLSD& data, const LLSD::Date& value) const
+{
+	if (!mSharedValues)
+	{
+		data = value;
+		return;
+	}
+	assign_shared(mSharedValues->mDates[real_bits(value.secondsSinceEpoch())], data, value);
+}
+
+void LLSDParser::assignValue(LLSD& data, const LLSD::URI& value) const
+{
+	if (!mSharedValues)
+	{
+		data = value;
+		return;
+	}
+	assign_shared(mSharedValues->mURIs[value.asString()], data, value);
 }
 
 
@@ -482,7 +640,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 
 	case '0':
 		c = get(istr);
-		data = false;
+		assignValue(data, false);
 		break;
 
 	case 'F':
@@ -501,7 +659,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 		}
 		else
 		{
-			data = false;
+			assignValue(data, false);
 		}
 		if(istr.fail())
 		{
@@ -512,7 +670,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 
 	case '1':
 		c = get(istr);
-		data = true;
+		assignValue(data, true);
 		break;
 
 	case 'T':
@@ -527,7 +685,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 		}
 		else
 		{
-			data = true;
+			assignValue(data, true);
 		}
 		if(istr.fail())
 		{
@@ -541,7 +699,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 		c = get(istr);
 		S32 integer = 0;
 		istr >> integer;
-		data = integer;
+		assignValue(data, integer);
 		if(istr.fail())
 		{
 			LL_INFOS() << "STREAM FAILURE reading integer." << LL_ENDL;
@@ -555,7 +713,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 		c = get(istr);
 		F64 real = 0.0;
 		istr >> real;
-		data = real;
+		assignValue(data, real);
 		if(istr.fail())
 		{
 			LL_INFOS() << "STREAM FAILURE reading real." << LL_ENDL;
@@ -569,7 +727,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 		c = get(istr);
 		LLUUID id;
 		istr >> id;
-		data = id;
+		assignValue(data, id);
 		if(istr.fail())
 		{
 			LL_INFOS() << "STREAM FAILURE reading uuid." << LL_ENDL;
@@ -604,7 +762,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 		}
 		else
 		{
-			data = LLURI(str);
+			assignValue(data, LLURI(str));
 			account(cnt);
 		}
 		if(istr.fail())
@@ -627,7 +785,7 @@ S32 LLSDNotationParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) c
 		}
 		else
 		{
-			data = LLDate(str);
+			assignValue(data, LLDate(str));
 			account(cnt);
 		}
 		if(istr.fail())
@@ -768,7 +926,7 @@ bool LLSDNotationParser::parseString(std::istream& istr, LLSD& data) const
 	int count = deserialize_string(istr, value, mMaxBytesLeft);
 	if(PARSE_FAILURE == count) return false;
 	account(count);
-	data = value;
+	assignValue(data, value);
 	return true;
 }
 
@@ -948,18 +1106,18 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
 		break;
 
 	case '0':
-		data = false;
+		assignValue(data, false);
 		break;
 
 	case '1':
-		data = true;
+		assignValue(data, true);
 		break;
 
 	case 'i':
 	{
 		U32 value_nbo = 0;
 		read(istr, (char*)&value_nbo, sizeof(U32));	 /*Flawfinder: ignore*/
-		data = (S32)ntohl(value_nbo);
+		assignValue(data, (LLSD::Integer)ntohl(value_nbo));
 		if(istr.fail())
 		{
 			LL_INFOS() << "STREAM FAILURE reading binary integer." << LL_ENDL;
@@ -971,7 +1129,7 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
 	{
 		F64 real_nbo = 0.0;
 		read(istr, (char*)&real_nbo, sizeof(F64));	 /*Flawfinder: ignore*/
-		data = ll_ntohd(real_nbo);
+		assignValue(data, (LLSD::Real)ll_ntohd(real_nbo));
 		if(istr.fail())
 		{
 			LL_INFOS() << "STREAM FAILURE reading binary real." << LL_ENDL;
@@ -983,7 +1141,7 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
 	{
 		LLUUID id;
 		read(istr, (char*)(&id.mData), UUID_BYTES);	 /*Flawfinder: ignore*/
-		data = id;
+		assignValue(data, id);
 		if(istr.fail())
 		{
 			LL_INFOS() << "STREAM FAILURE reading binary uuid." << LL_ENDL;
@@ -1002,7 +1160,7 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
 		}
 		else
 		{
-			data = value;
+			assignValue(data, value);
 			account(cnt);
 		}
 		if(istr.fail())
@@ -1019,7 +1177,7 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
 		std::string value;
 		if(parseString(istr, value))
 		{
-			data = value;
+			assignValue(data, value);
 		}
 		else
 		{
@@ -1038,7 +1196,7 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
 		std::string value;
 		if(parseString(istr, value))
 		{
-			data = LLURI(value);
+			assignValue(data, LLURI(value));
 		}
 		else
 		{
@@ -1056,7 +1214,7 @@ S32 LLSDBinaryParser::doParse(std::istream& istr, LLSD& data, S32 max_depth) con
 	{
 		F64 real = 0.0;
 		read(istr, (char*)&real, sizeof(F64));	 /*Flawfinder: ignore*/
-		data = LLDate(real);
+		assignValue(data, LLDate(real));
 		if(istr.fail())
 		{
 			LL_INFOS() << "STREAM FAILURE reading binary date." << LL_ENDL;
@@ -1221,6 +1379,500 @@ bool LLSDBinaryParser::parseString(
 }
 
 
+/**
+ * LLSDBinaryBufferParser
+ *
+ * Same format and failure rules as LLSDBinaryParser, but reads straight
+ * out of memory instead of going through the istream one get()/read() at
+ * a time. The bytes are either one contiguous range, for the buffer
+ * overload of LLSDSerialize::fromBinary(), or a series of windows from a
+ * Source, which is how unzip_llsd() parses while it inflates.
+ */
+namespace
+{
+class LLSDBinaryBufferParser
+{
+public:
+	// Hands the parser the bytes following the current window, for
+	// documents that are never in memory all at once.
+	class Source
+	{
+	public:
+		virtual ~Source() {}
+		// Points begin and end at the next bytes, returns false when
+		// there are none left.
+		virtual bool next(const U8*& begin, const U8*& end) = 0;
+	};
+
+	LLSDBinaryBufferParser(const U8* buf, S32 size)
+	:	mStart(buf),
+		mCur(buf),
+		mEnd(buf + llmax(size, 0)),
+		mSource(NULL),
+		mConsumed(0)
+	{
+	}
+
+	LLSDBinaryBufferParser(Source& source)
+	:	mStart(NULL),
+		mCur(NULL),
+		mEnd(NULL),
+		mSource(&source),
+		mConsumed(0)
+	{
+	}
+
+	S32 parse(LLSD& data, S32 max_depth);
+	S32 bytesRead() const { return mConsumed + (S32)(mCur - mStart); }
+
+private:
+	class WindowBuf;
+
+	S32 bytesLeft() const { return (S32)(mEnd - mCur); }
+	// True when there is at least one byte at mCur.
+	bool more() { return (mCur < mEnd) || nextWindow(); }
+	bool nextWindow();
+	bool read(void* dst, S32 size);
+	bool readSize(S32& size);
+	template<typename CONTAINER>
+	bool readInto(CONTAINER& value, S32 size);
+	bool parseString(std::string& value);
+	bool parseDelimitedString(std::string& value, char delim);
+	S32 parseMap(LLSD& map, S32 max_depth);
+	S32 parseArray(LLSD& array, S32 max_depth);
+
+	const U8* mStart;
+	const U8* mCur;
+	const U8* mEnd;
+	Source* mSource;
+	S32 mConsumed;		// bytes in the windows before mStart
+};
+
+// Lets the stream based unescaping code read across windows.
+class LLSDBinaryBufferParser::WindowBuf : public std::streambuf
+{
+public:
+	WindowBuf(LLSDBinaryBufferParser& parser)
+	:	mParser(parser)
+	{
+		setWindow();
+	}
+
+	// Hands the read position back to the parser.
+	void finish() { mParser.mCur = (const U8*)gptr(); }
+
+protected:
+	/*virtual*/ int_type underflow()
+	{
+		mParser.mCur = mParser.mEnd;
+		if (!mParser.nextWindow())
+		{
+			return traits_type::eof();
+		}
+		setWindow();
+		return traits_type::to_int_type(*gptr());
+	}
+
+private:
+	void setWindow()
+	{
+		char* cur = (char*)mParser.mCur;
+		setg(cur, cur, (char*)mParser.mEnd);
+	}
+
+	LLSDBinaryBufferParser& mParser;
+};
+
+bool LLSDBinaryBufferParser::nextWindow()
+{
+	if (!mSource)
+	{
+		return false;
+	}
+	mConsumed += (S32)(mEnd - mStart);
+	const U8* begin = NULL;
+	const U8* end = NULL;
+	while (mSource->next(begin, end))
+	{
+		if (begin < end)
+		{
+			mStart = mCur = begin;
+			mEnd = end;
+			return true;
+		}
+	}
+	mStart = mCur = mEnd;
+	return false;
+}
+
+bool LLSDBinaryBufferParser::read(void* dst, S32 size)
+{
+	U8* out = (U8*)dst;
+	while (size > bytesLeft())
+	{
+		S32 have = bytesLeft();
+		if (have)
+		{
+			memcpy(out, mCur, have);		/* Flawfinder: ignore */
+			out += have;
+			size -= have;
+		}
+		mCur = mEnd;
+		if (!nextWindow())
+		{
+			return false;
+		}
+	}
+	memcpy(out, mCur, size);		/* Flawfinder: ignore */
+	mCur += size;
+	return true;
+}
+
+bool LLSDBinaryBufferParser::readSize(S32& size)
+{
+	U32 value_nbo = 0;
+	if (!read(&value_nbo, sizeof(U32)))
+	{
+		return false;
+	}
+	size = (S32)ntohl(value_nbo);
+	return true;
+}
+
+template<typename CONTAINER>
+bool LLSDBinaryBufferParser::readInto(CONTAINER& value, S32 size)
+{
+	if (size < 0)
+	{
+		return false;
+	}
+	if (size <= bytesLeft())
+	{
+		value.assign(mCur, mCur + size);
+		mCur += size;
+		return true;
+	}
+	if (!mSource)
+	{
+		return false;
+	}
+	// Spans windows. Grow as the bytes arrive rather than trusting size
+	// for the allocation.
+	value.clear();
+	while (size > 0)
+	{
+		if (!more())
+		{
+			return false;
+		}
+		S32 chunk = llmin(size, bytesLeft());
+		value.insert(value.end(), mCur, mCur + chunk);
+		mCur += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+bool LLSDBinaryBufferParser::parseString(std::string& value)
+{
+	S32 size = 0;
+	return readSize(size) && readInto(value, size);
+}
+
+bool LLSDBinaryBufferParser::parseDelimitedString(std::string& value, char delim)
+{
+	// Notation style strings are rare in binary LLSD, reuse the stream
+	// unescaping code over the remaining bytes rather than duplicate it.
+	WindowBuf buf(*this);
+	std::istream istr(&buf);
+	int cnt = deserialize_string_delim(istr, value, delim);
+	buf.finish();
+	return LLSDParser::PARSE_FAILURE != cnt;
+}
+
+S32 LLSDBinaryBufferParser::parse(LLSD& data, S32 max_depth)
+{
+	if (!more())
+	{
+		return 0;
+	}
+	if (max_depth == 0)
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	char c = (char)*mCur++;
+	S32 parse_count = 1;
+	switch(c)
+	{
+	case '{':
+	{
+		S32 child_count = parseMap(data, max_depth - 1);
+		if ((child_count == LLSDParser::PARSE_FAILURE) || data.isUndefined())
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		else
+		{
+			parse_count += child_count;
+		}
+		break;
+	}
+
+	case '[':
+	{
+		S32 child_count = parseArray(data, max_depth - 1);
+		if ((child_count == LLSDParser::PARSE_FAILURE) || data.isUndefined())
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		else
+		{
+			parse_count += child_count;
+		}
+		break;
+	}
+
+	case '!':
+		data.clear();
+		break;
+
+	case '0':
+		data = false;
+		break;
+
+	case '1':
+		data = true;
+		break;
+
+	case 'i':
+	{
+		U32 value_nbo = 0;
+		if (read(&value_nbo, sizeof(U32)))
+		{
+			data = (S32)ntohl(value_nbo);
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'r':
+	{
+		F64 real_nbo = 0.0;
+		if (read(&real_nbo, sizeof(F64)))
+		{
+			data = ll_ntohd(real_nbo);
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'u':
+	{
+		LLUUID id;
+		if (read(id.mData, UUID_BYTES))
+		{
+			data = id;
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case '\'':
+	case '"':
+	{
+		std::string value;
+		if (parseDelimitedString(value, c))
+		{
+			data = value;
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 's':
+	{
+		std::string value;
+		if (parseString(value))
+		{
+			data = value;
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'l':
+	{
+		std::string value;
+		if (parseString(value))
+		{
+			data = LLURI(value);
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'd':
+	{
+		F64 real = 0.0;
+		if (read(&real, sizeof(F64)))
+		{
+			data = LLDate(real);
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'b':
+	{
+		S32 size = 0;
+		std::vector<U8> value;
+		if (!readSize(size) || ((size > 0) && !readInto(value, size)))
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		else
+		{
+			data = value;
+		}
+		break;
+	}
+
+	default:
+		parse_count = LLSDParser::PARSE_FAILURE;
+		LL_INFOS() << "Unrecognized character while parsing: int(" << (int)c
+			<< ")" << LL_ENDL;
+		break;
+	}
+	if (LLSDParser::PARSE_FAILURE == parse_count)
+	{
+		data.clear();
+	}
+	return parse_count;
+}
+
+S32 LLSDBinaryBufferParser::parseMap(LLSD& map, S32 max_depth)
+{
+	map = LLSD::emptyMap();
+	S32 size = 0;
+	if (!readSize(size))
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	S32 parse_count = 0;
+	S32 count = 0;
+	while ((count < size) && more() && (*mCur != '}'))
+	{
+		char c = (char)*mCur++;
+		std::string name;
+		switch(c)
+		{
+		case 'k':
+			if (!parseString(name))
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			break;
+		case '\'':
+		case '"':
+			if (!parseDelimitedString(name, c))
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			break;
+		}
+		LLSD child;
+		S32 child_count = parse(child, max_depth);
+		if (child_count > 0)
+		{
+			// There must be a value for every key, thus child_count
+			// must be greater than 0.
+			parse_count += child_count;
+			map.insert(name, child);
+		}
+		else
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+		++count;
+	}
+	if (!more() || (*mCur++ != '}') || (count < size))
+	{
+		// Make sure it is correctly terminated and we parsed as many
+		// as were said to be there.
+		return LLSDParser::PARSE_FAILURE;
+	}
+	return parse_count;
+}
+
+S32 LLSDBinaryBufferParser::parseArray(LLSD& array, S32 max_depth)
+{
+	array = LLSD::emptyArray();
+	S32 size = 0;
+	if (!readSize(size))
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	S32 parse_count = 0;
+	S32 count = 0;
+	while ((count < size) && more() && (*mCur != ']'))
+	{
+		LLSD child;
+		S32 child_count = parse(child, max_depth);
+		if (LLSDParser::PARSE_FAILURE == child_count)
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+		if (child_count)
+		{
+			parse_count += child_count;
+			array.append(child);
+		}
+		++count;
+	}
+	if (!more() || (*mCur++ != ']') || (count < size))
+	{
+		// Make sure it is correctly terminated and we parsed as many
+		// as were said to be there.
+		return LLSDParser::PARSE_FAILURE;
+	}
+	return parse_count;
+}
+} // anonymous namespace
+
+// static
+S32 LLSDSerialize::fromBinary(LLSD& sd, const U8* buf, S32 size, S32 max_depth, S32* bytes_read)
+{
+	LLSDBinaryBufferParser parser(buf, size);
+	S32 parse_count = parser.parse(sd, max_depth);
+	if (bytes_read)
+	{
+		*bytes_read = parser.bytesRead();
+	}
+	return parse_count;
+}
+
+
 /**
  * LLSDFormatter
  */
@@ -2133,129 +2785,199 @@ std::string zip_llsd(LLSD& data)
 	return result;
 }
 
-//decompress a block of LLSD from provided istream
-// not very efficient -- creats a copy of decompressed LLSD block in memory
-// and deserializes from that copy using LLSDSerialize
-LLUZipHelper::EZipRresult LLUZipHelper::unzip_llsd(LLSD& data, std::istream& is, S32 size)
+namespace
 {
-	U8* result = NULL;
-	U32 cur_size = 0;
-	z_stream strm;
-		
-	const U32 CHUNK = 65536;
+// Inflated bytes handed to the parser at a time.
+const U32 UNZIP_WINDOW_SIZE = 65536;
+// Compressed bytes read from an istream at a time.
+const U32 UNZIP_READ_SIZE = 16384;
+
+// Inflates a zlib block one fixed size window at a time for
+// LLSDBinaryBufferParser, so neither the whole compressed block nor the
+// whole inflated one has to be held in memory.
+class LLSDInflateSource : public LLSDBinaryBufferParser::Source
+{
+public:
+	LLSDInflateSource(const U8* in, S32 size)
+	:	mInput(NULL),
+		mInputLeft(0),
+		mReadBuffer(NULL),
+		mWindow(NULL),
+		mRet(Z_OK),
+		mInit(false),
+		mFirst(true)
+	{
+		memset(&mStream, 0, sizeof(mStream));
+		mStream.next_in = const_cast<U8*>(in);
+		mStream.avail_in = size;
+	}
 
-	U8 *in = new(std::nothrow) U8[size];
-	if (!in)
+	LLSDInflateSource(std::istream& is, S32 size)
+	:	mInput(&is),
+		mInputLeft(size),
+		mReadBuffer(NULL),
+		mWindow(NULL),
+		mRet(Z_OK),
+		mInit(false),
+		mFirst(true)
 	{
-		return ZR_MEM_ERROR;
+		memset(&mStream, 0, sizeof(mStream));
 	}
-	is.read((char*) in, size); 
 
-	U8 out[CHUNK];
-		
-	strm.zalloc = Z_NULL;
-	strm.zfree = Z_NULL;
-	strm.opaque = Z_NULL;
-	strm.avail_in = size;
-	strm.next_in = in;
+	~LLSDInflateSource()
+	{
+		if (mInit)
+		{
+			inflateEnd(&mStream);
+		}
+		delete [] mReadBuffer;
+		delete [] mWindow;
+	}
 
-	S32 ret = inflateInit(&strm);
-	
-	do
+	LLUZipHelper::EZipRresult init()
 	{
-		strm.avail_out = CHUNK;
-		strm.next_out = out;
-		ret = inflate(&strm, Z_NO_FLUSH);
-		if (ret == Z_STREAM_ERROR)
+		mWindow = new(std::nothrow) U8[UNZIP_WINDOW_SIZE];
+		if (mInput)
 		{
-			inflateEnd(&strm);
-			free(result);
-			delete [] in;
-			return ZR_DATA_ERROR;
+			mReadBuffer = new(std::nothrow) U8[UNZIP_READ_SIZE];
 		}
-		
-		switch (ret)
+		if (!mWindow || (mInput && !mReadBuffer))
 		{
-		case Z_NEED_DICT:
-			ret = Z_DATA_ERROR;
-		case Z_DATA_ERROR:
-		case Z_MEM_ERROR:
-			inflateEnd(&strm);
-			free(result);
-			delete [] in;
-			return ZR_MEM_ERROR;
-			break;
+			return LLUZipHelper::ZR_MEM_ERROR;
 		}
+		mInit = (inflateInit(&mStream) == Z_OK);
+		return mInit ? LLUZipHelper::ZR_OK : LLUZipHelper::ZR_MEM_ERROR;
+	}
 
-		U32 have = CHUNK-strm.avail_out;
+	/*virtual*/ bool next(const U8*& begin, const U8*& end)
+	{
+		if (mRet != Z_OK)
+		{
+			// Ended or failed
+			return false;
+		}
 
-		U8* new_result = (U8*)realloc(result, cur_size + have);
-		if (new_result == NULL)
+		mStream.next_out = mWindow;
+		mStream.avail_out = UNZIP_WINDOW_SIZE;
+		while (mStream.avail_out && (mRet == Z_OK))
 		{
-			inflateEnd(&strm);
-			if (result)
+			if (!mStream.avail_in && (mInputLeft > 0))
 			{
-				free(result);
+				S32 want = llmin(mInputLeft, (S32)UNZIP_READ_SIZE);
+				mInput->read((char*)mReadBuffer, want);
+				S32 got = (S32)mInput->gcount();
+				mInputLeft = (got < want) ? 0 : mInputLeft - want;
+				mStream.next_in = mReadBuffer;
+				mStream.avail_in = got;
 			}
-			delete[] in;
-			return ZR_MEM_ERROR;
+			mRet = inflate(&mStream, Z_NO_FLUSH);
 		}
-		result = new_result;
-		memcpy(result+cur_size, out, have);
-		cur_size += have;
-
-	} while (ret == Z_OK);
-
-	inflateEnd(&strm);
-	delete [] in;
-
-	if (ret != Z_STREAM_END)
-	{
-		free(result);
-		return ZR_DATA_ERROR;
-	}
 
-	//result now points to the decompressed LLSD block
-	{
-		std::istringstream istr;
-		// Since we are using this for meshes, data we are dealing with tend to be large.
-		// So string can potentially fail to allocate, make sure this won't cause problems
-		try
+		begin = mWindow;
+		end = mWindow + (UNZIP_WINDOW_SIZE - mStream.avail_out);
+		if (mFirst)
 		{
-			std::string res_str((char*)result, cur_size);
-
-			std::string deprecated_header("<? LLSD/Binary ?>");
-
-			if (res_str.substr(0, deprecated_header.size()) == deprecated_header)
+			mFirst = false;
+			static const char deprecated_header[] = "<? LLSD/Binary ?>";
+			const S32 deprecated_header_len = sizeof(deprecated_header) - 1;
+			if ((end - begin >= deprecated_header_len)
+				&& !memcmp(begin, deprecated_header, deprecated_header_len))
 			{
-				res_str = res_str.substr(deprecated_header.size() + 1, cur_size);
+				// skip the header and the newline after it
+				begin += llmin(deprecated_header_len + 1, (S32)(end - begin));
 			}
-			cur_size = res_str.size();
-
-			istr.str(res_str);
 		}
-#ifdef LL_WINDOWS
-		catch (std::length_error)
+		return end > mWindow;
+	}
+
+	// Inflates whatever the parser did not read so the checksum at the end
+	// is verified and all size bytes are taken off the istream.
+	LLUZipHelper::EZipRresult finish()
+	{
+		const U8* begin = NULL;
+		const U8* end = NULL;
+		while (next(begin, end))
 		{
-			free(result);
-			return ZR_SIZE_ERROR;
 		}
-#endif
-		catch (std::bad_alloc)
+		if (mInputLeft > 0)
 		{
-			free(result);
-			return ZR_MEM_ERROR;
+			mInput->ignore(mInputLeft);
+			mInputLeft = 0;
 		}
 
-		if (!LLSDSerialize::fromBinary(data, istr, cur_size, UNZIP_LLSD_MAX_DEPTH))
+		switch (mRet)
 		{
-			free(result);
-			return ZR_PARSE_ERROR;
+		case Z_STREAM_END:
+			return LLUZipHelper::ZR_OK;
+		case Z_NEED_DICT:
+		case Z_DATA_ERROR:
+		case Z_MEM_ERROR:
+			return LLUZipHelper::ZR_MEM_ERROR;
+		default:
+			return LLUZipHelper::ZR_DATA_ERROR;
 		}
 	}
 
-	free(result);
-	return ZR_OK;
+private:
+	z_stream		mStream;
+	std::istream*	mInput;
+	S32				mInputLeft;		// bytes of the block still in mInput
+	U8*				mReadBuffer;
+	U8*				mWindow;
+	S32				mRet;			// last inflate() result
+	bool			mInit;
+	bool			mFirst;
+};
+
+LLUZipHelper::EZipRresult unzip_llsd_from(LLSD& data, LLSDInflateSource& source)
+{
+	LLUZipHelper::EZipRresult result = source.init();
+	if (result != LLUZipHelper::ZR_OK)
+	{
+		return result;
+	}
+
+	LLSD parsed;
+	LLSDBinaryBufferParser parser(source);
+	S32 parse_count = parser.parse(parsed, UNZIP_LLSD_MAX_DEPTH);
+
+	result = source.finish();
+	if (result != LLUZipHelper::ZR_OK)
+	{
+		return result;
+	}
+	if (parse_count <= 0)
+	{
+		return LLUZipHelper::ZR_PARSE_ERROR;
+	}
+	data = parsed;
+	return LLUZipHelper::ZR_OK;
+}
+} // anonymous namespace
+
+//decompress a block of LLSD from provided istream
+// reads and inflates the block a piece at a time, parsing as it goes
+LLUZipHelper::EZipRresult LLUZipHelper::unzip_llsd(LLSD& data, std::istream& is, S32 size)
+{
+	if (size < 0)
+	{
+		return ZR_SIZE_ERROR;
+	}
+	LLSDInflateSource source(is, size);
+	return unzip_llsd_from(data, source);
+}
+
+//decompress a block of LLSD from a memory buffer
+// the inflated LLSD is parsed a window at a time as it comes out of zlib,
+// without staging all of it first
+LLUZipHelper::EZipRresult LLUZipHelper::unzip_llsd(LLSD& data, const U8* in, S32 size)
+{
+	if (size < 0)
+	{
+		return ZR_SIZE_ERROR;
+	}
+	LLSDInflateSource source(in, size);
+	return unzip_llsd_from(data, source);
 }
 //This unzip function will only work with a gzip header and trailer - while the contents
 //of the actual compressed data is the same for either format (gzip vs zlib ), the headers
@@ -88,7 +88,20 @@ public:
 	/** 
 	 * @brief Resets the parser so parse() or parseLines() can be called again for another <llsd> chunk.
 	 */
-	void reset()	{ doReset();	};
+	void reset();
+
+	/**
+	 * @brief Share one value between identical scalars of a document.
+	 *
+	 * LLSD values are reference counted and copy on write, so repeated
+	 * strings, UUIDs, numbers and dates in one parse can all refer to a
+	 * single Impl instead of allocating one each. The lookup table lives
+	 * for one parse() or parseLines() call. Off by default: it only pays
+	 * for large, repetitive documents, and the result must not be read
+	 * from several threads at once since copies of shared values touch
+	 * a common, non atomic use count.
+	 */
+	void setShareValues(bool share);
 
 
 protected:
@@ -196,6 +209,27 @@ protected:
 	 */
 	void account(S32 bytes) const;
 
+	/**
+	 * @brief Assign a parsed scalar to data.
+	 *
+	 * Reuses an identical value from earlier in the same parse when
+	 * setShareValues() is on, otherwise a plain assignment.
+	 */
+	//@{
+	void assignValue(LLSD& data, LLSD::Boolean value) const;
+	void assignValue(LLSD& data, LLSD::Integer value) const;
+	void assignValue(LLSD& data, LLSD::Real value) const;
+	void assignValue(LLSD& data, const LLSD::String& value) const;
+	void assignValue(LLSD& data, const LLSD::UUID& value) const;
+	void assignValue(LLSD& data, const LLSD::Date& value) const;
+	void assignValue(LLSD& data, const LLSD::URI& value) const;
+	//@}
+
+	/**
+	 * @brief Drop the values remembered for sharing at the end of a parse.
+	 */
+	void clearSharedValues() const;
+
 protected:
 	/**
 	 * @brief boolean to set if byte counts should be checked during parsing.
@@ -211,6 +245,14 @@ protected:
 	 * @brief Use line-based reading to get text
 	 */
 	bool mParseLines;
+
+private:
+	struct SharedValues;
+
+	/**
+	 * @brief Values seen so far in this parse, NULL unless sharing is on.
+	 */
+	mutable SharedValues* mSharedValues;
 };
 
 /** 
@@ -824,6 +866,17 @@ public:
 		(void)p->parse(str, sd, max_bytes, max_depth);
 		return sd;
 	}
+
+	/**
+	 * @brief Parse binary LLSD straight out of a memory buffer.
+	 *
+	 * Accepts the same format as the istream version without copying
+	 * buf into a stream first. The buffer size is the byte limit.
+	 * @param bytes_read[out] If not NULL, how much of buf was consumed.
+	 * @return Returns the number of LLSD objects parsed into sd, or
+	 * LLSDParser::PARSE_FAILURE.
+	 */
+	static S32 fromBinary(LLSD& sd, const U8* buf, S32 size, S32 max_depth = -1, S32* bytes_read = NULL);
 };
 
 class LL_COMMON_API LLUZipHelper : public LLRefCount
@@ -839,6 +892,7 @@ public:
     } EZipRresult;
     // return OK or reason for failure
     static EZipRresult unzip_llsd(LLSD& data, std::istream& is, S32 size);
+    static EZipRresult unzip_llsd(LLSD& data, const U8* in, S32 size);
 };
 
 //dirty little zip functions -- yell at davep
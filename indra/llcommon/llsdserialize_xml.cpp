@@ -250,7 +250,7 @@ std::string LLSDXMLFormatter::escapeString(const std::string& in)
 class LLSDXMLParser::Impl
 {
 public:
-	Impl(bool emit_errors);
+	Impl(const LLSDXMLParser& owner, bool emit_errors);
 	~Impl();
 	
 	S32 parse(std::istream& input, LLSD& data);
@@ -294,6 +294,7 @@ private:
 	
 	static const XML_Char* findAttribute(const XML_Char* name, const XML_Char** pairs);
 	
+	const LLSDXMLParser& mOwner;	// for value sharing
 	bool mEmitErrors;
 
 	XML_Parser	mParser;
@@ -316,8 +317,8 @@ private:
 };
 
 
-LLSDXMLParser::Impl::Impl(bool emit_errors)
-	: mEmitErrors(emit_errors)
+LLSDXMLParser::Impl::Impl(const LLSDXMLParser& owner, bool emit_errors)
+	: mOwner(owner), mEmitErrors(emit_errors)
 {
 	mParser = XML_ParserCreate(NULL);
 	reset();
@@ -718,7 +719,7 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
 			break;
 		
 		case ELEMENT_BOOL:
-			value = (mCurrentContent == "true" || mCurrentContent == "1");
+			mOwner.assignValue(value, (LLSD::Boolean)(mCurrentContent == "true" || mCurrentContent == "1"));
 			break;
 		
 		case ELEMENT_INTEGER:
@@ -727,18 +728,18 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
 				// sscanf okay here with different locales - ints don't change for different locale settings like floats do.
 				if ( sscanf(mCurrentContent.c_str(), "%d", &i ) == 1 )
 				{	// See if sscanf works - it's faster
-					value = i;
+					mOwner.assignValue(value, (LLSD::Integer)i);
 				}
 				else
 				{
-					value = LLSD(mCurrentContent).asInteger();
+					mOwner.assignValue(value, LLSD(mCurrentContent).asInteger());
 				}
 			}
 			break;
 		
 		case ELEMENT_REAL:
 			{
-				value = LLSD(mCurrentContent).asReal();
+				mOwner.assignValue(value, LLSD(mCurrentContent).asReal());
 				// removed since this breaks when locale has decimal separator that isn't '.'
 				// investigated changing local to something compatible each time but deemed higher
 				// risk that just using LLSD.asReal() each time.
@@ -755,19 +756,19 @@ void LLSDXMLParser::Impl::endElementHandler(const XML_Char* name)
 			break;
 		
 		case ELEMENT_STRING:
-			value = mCurrentContent;
+			mOwner.assignValue(value, mCurrentContent);
 			break;
 		
 		case ELEMENT_UUID:
-			value = LLSD(mCurrentContent).asUUID();
+			mOwner.assignValue(value, LLUUID(mCurrentContent));
 			break;
 		
 		case ELEMENT_DATE:
-			value = LLSD(mCurrentContent).asDate();
+			mOwner.assignValue(value, LLDate(mCurrentContent));
 			break;
 		
 		case ELEMENT_URI:
-			value = LLSD(mCurrentContent).asURI();
+			mOwner.assignValue(value, LLURI(mCurrentContent));
 			break;
 		
 		case ELEMENT_BINARY:
@@ -902,7 +903,7 @@ LLSDXMLParser::Impl::Element LLSDXMLParser::Impl::readElement(const XML_Char* na
 /**
  * LLSDXMLParser
  */
-LLSDXMLParser::LLSDXMLParser(bool emit_errors /* = true */) : impl(* new Impl(emit_errors))
+LLSDXMLParser::LLSDXMLParser(bool emit_errors /* = true */) : impl(* new Impl(*this, emit_errors))
 {
 }
 
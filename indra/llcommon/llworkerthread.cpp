@@ -34,8 +34,8 @@
 //============================================================================
 // Run on MAIN thread
 
-LLWorkerThread::LLWorkerThread(const std::string& name, bool threaded, bool should_pause) :
-	LLQueuedThread(name, threaded, should_pause)
+LLWorkerThread::LLWorkerThread(const std::string& name, bool threaded, bool should_pause, S32 num_threads) :
+	LLQueuedThread(name, threaded, should_pause, num_threads)
 {
 	mDeleteMutex = new LLMutex(NULL);
 
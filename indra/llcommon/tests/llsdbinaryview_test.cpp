@@ -0,0 +1,202 @@
+/**
+ * @file   llsdbinaryview_test.cpp
+ * @brief  LLSDBinaryView unit tests
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <sstream>
+
+#include "../llsd.h"
+#include "../llsdserialize.h"
+#include "../llsdbinaryview.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct binary_view_test
+	{
+		binary_view_test()
+		{
+			mDoc["name"] = "mesh";
+			mDoc["version"] = 3;
+			mDoc["scale"] = 0.25;
+			mDoc["visible"] = true;
+			mDoc["id"] = LLUUID("6a3c1c9e-2ab4-4fe0-8c39-bf5b9f2a6c11");
+			mDoc["data"] = LLSD::Binary(5, 7);
+			LLSD lod;
+			lod["offset"] = 0;
+			lod["size"] = 100;
+			mDoc["lods"].append(lod);
+			lod["offset"] = 100;
+			lod["size"] = 50;
+			mDoc["lods"].append(lod);
+			mDoc["lods"].append(LLSD());
+			mDoc["empty"] = LLSD::emptyMap();
+
+			std::ostringstream ostr;
+			LLSDSerialize::toBinary(mDoc, ostr);
+			mBuffer = ostr.str();
+		}
+
+		LLSDBinaryView view(S32 size = -1) const
+		{
+			return LLSDBinaryView((const U8*)mBuffer.data(),
+								  size < 0 ? mBuffer.size() : size);
+		}
+
+		LLSD mDoc;
+		std::string mBuffer;
+	};
+	typedef test_group<binary_view_test> binary_view_test_t;
+	typedef binary_view_test_t::object binary_view_object_t;
+	tut::binary_view_test_t tut_binary_view_test("LLSDBinaryView");
+
+	template<> template<>
+	void binary_view_object_t::test<1>()
+	{
+		set_test_name("scalar lookups");
+		LLSDBinaryView doc(view());
+		ensure("map", doc.isMap());
+		ensure_equals("size", doc.size(), mDoc.size());
+		ensure_equals("string", doc["name"].asString(), std::string("mesh"));
+		ensure_equals("integer", doc["version"].asInteger(), 3);
+		ensure_equals("real", doc["scale"].asReal(), 0.25);
+		ensure("boolean", doc["visible"].asBoolean());
+		ensure_equals("uuid", doc["id"].asUUID(), mDoc["id"].asUUID());
+		ensure("binary", doc["data"].asBinary() == mDoc["data"].asBinary());
+		ensure_equals("converted", doc["version"].asString(), std::string("3"));
+		ensure("missing", doc["nope"].isUndefined());
+		ensure("has", doc.has("scale") && !doc.has("nope"));
+	}
+
+	template<> template<>
+	void binary_view_object_t::test<2>()
+	{
+		set_test_name("nested containers");
+		LLSDBinaryView lods(view()["lods"]);
+		ensure("array", lods.isArray());
+		ensure_equals("array size", lods.size(), 3);
+		ensure_equals("nested", lods[1]["offset"].asInteger(), 100);
+		ensure("undef element", lods[2].isUndefined());
+		ensure("out of range", lods[3].isUndefined());
+		ensure("not a map", lods["offset"].isUndefined());
+		ensure_equals("empty map", view()["empty"].size(), 0);
+		ensure_equals("subtree", lods.asLLSD(), mDoc["lods"]);
+		ensure_equals("whole", view().asLLSD(), mDoc);
+		ensure_equals("encoded size", view().encodedSize(), (S32)mBuffer.size());
+	}
+
+	template<> template<>
+	void binary_view_object_t::test<3>()
+	{
+		set_test_name("map iteration");
+		LLSDBinaryView doc(view());
+		LLSD::map_const_iterator expected = mDoc.beginMap();
+		S32 count = 0;
+		for (LLSDBinaryView::map_const_iterator it = doc.beginMap(); it != doc.endMap(); ++it, ++expected)
+		{
+			ensure("too many keys", expected != mDoc.endMap());
+			ensure_equals("key", it.key(), expected->first);
+			ensure_equals("value", it.value().asLLSD(), expected->second);
+			++count;
+		}
+		ensure_equals("count", count, mDoc.size());
+		ensure("empty", view()["empty"].beginMap() == view()["empty"].endMap());
+	}
+
+	template<> template<>
+	void binary_view_object_t::test<4>()
+	{
+		set_test_name("notation style keys and strings");
+		// {'a\x41':"v\n"} with a 'k' key after it
+		static const char raw[] = "{\0\0\0\x02" "'a\\x41'" "\"v\\n\"" "k\0\0\0\x01" "b" "i\0\0\0\x05" "}";
+		std::string buf(raw, sizeof(raw) - 1);
+		LLSDBinaryView doc((const U8*)buf.data(), buf.size());
+		ensure_equals("escaped key", doc["aA"].asString(), std::string("v\n"));
+		ensure_equals("plain key", doc["b"].asInteger(), 5);
+		ensure_equals("iterated key", doc.beginMap().key(), std::string("aA"));
+	}
+
+	template<> template<>
+	void binary_view_object_t::test<5>()
+	{
+		set_test_name("truncated buffers");
+		// Every prefix of the document must be safe to read from.
+		for (S32 len = 0; len < (S32)mBuffer.size(); ++len)
+		{
+			LLSDBinaryView doc(view(len));
+			doc["lods"][1]["size"].asInteger();
+			doc["name"].asString();
+			doc["id"].asUUID();
+			doc["data"].asBinary();
+			for (LLSDBinaryView::map_const_iterator it = doc.beginMap(); it != doc.endMap(); ++it)
+			{
+				it.key();
+			}
+			ensure_equals("truncated size", doc.encodedSize(), 0);
+		}
+		ensure("empty view", LLSDBinaryView().isUndefined());
+	}
+
+	template<> template<>
+	void binary_view_object_t::test<6>()
+	{
+		set_test_name("model cache layout");
+		// Same shape LLModelLoader::loadFromSLM() reads: mesh assets stored
+		// as strings with arbitrary bytes in them, plus small instance maps.
+		LLSD slm;
+		slm["version"] = 3;
+		slm["name"] = "chair";
+		for (S32 i = 0; i < 3; ++i)
+		{
+			std::string mesh(1000 * (i + 1), '\0');
+			for (size_t j = 0; j < mesh.size(); ++j)
+			{
+				mesh[j] = (char)(j * 31 + i);
+			}
+			slm["mesh"][i] = mesh;
+			LLSD instance;
+			instance["mesh_id"] = i;
+			instance["label"] = "part";
+			slm["instance"][i] = instance;
+		}
+		std::ostringstream ostr;
+		LLSDSerialize::toBinary(slm, ostr);
+		std::string buf(ostr.str());
+
+		LLSDBinaryView doc((const U8*)buf.data(), buf.size());
+		ensure_equals("version", doc["version"].asInteger(), 3);
+		ensure_equals("name", doc["name"].asString(), std::string("chair"));
+		LLSDBinaryView mesh(doc["mesh"]);
+		ensure_equals("mesh count", mesh.size(), 3);
+		for (S32 i = 0; i < mesh.size(); ++i)
+		{
+			ensure("mesh bytes", mesh[i].asString() == slm["mesh"][i].asString());
+			ensure_equals("instance", doc["instance"][i].asLLSD(), slm["instance"][i]);
+		}
+		ensure("missing key", doc["nope"].asString().empty());
+	}
+}
@@ -25,7 +25,7 @@
  * $/LicenseInfo$
  */
 
-
+#define LLSD_DEBUG_INFO
 #include "linden_common.h"
 
 #if LL_WINDOWS
@@ -983,6 +983,25 @@ namespace tut
 	{
 	public:
 		TestLLSDBinaryParsing() {}
+
+		// Every binary case is also run through the memory buffer parser,
+		// which must agree with the stream parser.
+		void ensureParse(
+			const std::string& msg,
+			const std::string& in,
+			const LLSD& expected_value,
+			S32 expected_count)
+		{
+			TestLLSDParsing<LLSDBinaryParser>::ensureParse(msg, in, expected_value, expected_count);
+
+			LLSD parsed_result;
+			S32 parsed_count = LLSDSerialize::fromBinary(
+				parsed_result, (const U8*)in.data(), in.size());
+			std::string buffer_msg(msg);
+			buffer_msg += " (buffer)";
+			ensure_equals(buffer_msg.c_str(), parsed_result, expected_value);
+			ensure_equals(buffer_msg + " (count)", parsed_count, expected_count);
+		}
 	};
 
 	typedef tut::test_group<TestLLSDBinaryParsing> TestLLSDBinaryParsingGroup;
@@ -1333,6 +1352,22 @@ namespace tut
 				count2,
 				count1);
 
+			// and straight out of the serialized buffer
+			std::string bin_str(str1.str());
+			LLSD actual_value_buf;
+			S32 count_buf = LLSDSerialize::fromBinary(
+				actual_value_buf,
+				(const U8*)bin_str.data(),
+				bin_str.size());
+			ensure_equals(
+				"ensureBinaryAndNotation buffer count",
+				count_buf,
+				count1);
+			ensure_equals(
+				(msg + " (buffer)").c_str(),
+				actual_value_buf,
+				input);
+
 			// to notation and back again
 			std::stringstream str2;
 			S32 count3 = LLSDSerialize::toNotation(actual_value_bin, str2);
@@ -1506,6 +1541,107 @@ namespace tut
 		ensureBinaryAndXML("map", test);
 	}
 
+	template<> template<> 
+	void TestLLSDCompatibleObject::test<9>()
+	{
+		set_test_name("shared values");
+		LLSD test;
+		for (S32 i = 0; i < 20; ++i)
+		{
+			LLSD entry;
+			entry["name"] = "repeated";
+			entry["id"] = LLUUID("6a3c1c9e-2ab4-4fe0-8c39-bf5b9f2a6c11");
+			entry["index"] = i % 2;
+			entry["scale"] = 0.5;
+			entry["flag"] = true;
+			entry["when"] = LLDate(1234.0);
+			entry["where"] = LLURI("http://sl.com");
+			test.append(entry);
+		}
+
+		std::ostringstream bin_out, notation_out, xml_out;
+		LLSDSerialize::toBinary(test, bin_out);
+		LLSDSerialize::toNotation(test, notation_out);
+		LLSDSerialize::toXML(test, xml_out);
+		std::string docs[3] = { bin_out.str(), notation_out.str(), xml_out.str() };
+		LLPointer<LLSDParser> parsers[3] =
+		{
+			new LLSDBinaryParser, new LLSDNotationParser, new LLSDXMLParser
+		};
+		for (S32 i = 0; i < 3; ++i)
+		{
+			std::istringstream plain_in(docs[i]);
+			U32 start = llsd::allocationCount();
+			LLSD plain;
+			parsers[i]->parse(plain_in, plain, LLSDSerialize::SIZE_UNLIMITED);
+			U32 plain_count = llsd::allocationCount() - start;
+
+			parsers[i]->reset();
+			parsers[i]->setShareValues(true);
+			std::istringstream shared_in(docs[i]);
+			start = llsd::allocationCount();
+			LLSD shared;
+			parsers[i]->parse(shared_in, shared, LLSDSerialize::SIZE_UNLIMITED);
+			U32 shared_count = llsd::allocationCount() - start;
+
+			ensure_equals("plain parse", plain, test);
+			ensure_equals("shared parse", shared, test);
+			ensure("fewer allocations", shared_count < plain_count);
+
+			// Writing through one shared value leaves the others alone.
+			shared[0]["name"] = "changed";
+			ensure_equals("copy on write", shared[1]["name"].asString(), std::string("repeated"));
+		}
+	}
+
+	template<> template<>
+	void TestLLSDCompatibleObject::test<10>()
+	{
+		set_test_name("unzip_llsd across windows");
+		// Mesh style blocks, big enough that values straddle the
+		// windows unzip_llsd() parses in.
+		LLSD big = LLSD::emptyArray();
+		for (S32 face = 0; face < 3; ++face)
+		{
+			std::vector<U8> positions(150000 + face);
+			for (size_t i = 0; i < positions.size(); ++i)
+			{
+				positions[i] = (U8)((i * 7919) >> (i & 3));
+			}
+			LLSD entry;
+			entry["Position"] = positions;
+			entry["Name"] = std::string(70000 + face, 'a' + face);
+			entry["Index"] = face;
+			big.append(entry);
+		}
+		LLSD small;
+		small["Index"] = 7;
+		std::string big_zip = zip_llsd(big);
+		std::string small_zip = zip_llsd(small);
+
+		LLSD out;
+		ensure_equals("buffer result", LLUZipHelper::unzip_llsd(out,
+			(const U8*)big_zip.data(), big_zip.size()), LLUZipHelper::ZR_OK);
+		ensure_equals("buffer value", out, big);
+
+		// Each block takes exactly its size off the stream.
+		std::istringstream both(big_zip + small_zip + "end");
+		LLSD out_big, out_small;
+		ensure_equals("stream result 1", LLUZipHelper::unzip_llsd(out_big, both, big_zip.size()),
+			LLUZipHelper::ZR_OK);
+		ensure_equals("stream result 2", LLUZipHelper::unzip_llsd(out_small, both, small_zip.size()),
+			LLUZipHelper::ZR_OK);
+		ensure_equals("stream value 1", out_big, big);
+		ensure_equals("stream value 2", out_small, small);
+		std::string rest;
+		both >> rest;
+		ensure_equals("stream position", rest, std::string("end"));
+
+		LLSD truncated;
+		ensure("truncated fails", LLUZipHelper::unzip_llsd(truncated,
+			(const U8*)big_zip.data(), big_zip.size() / 2) != LLUZipHelper::ZR_OK);
+	}
+
     struct TestPythonCompatible
     {
         TestPythonCompatible():
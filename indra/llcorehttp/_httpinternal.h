@@ -96,8 +96,10 @@
 // requests by priority, instead it's first-come-first-served.
 // Reprioritization requests have the side-effect of then
 // putting the modified request at the back of the ready queue.
+// If '0', higher priority values are issued first and equal
+// priorities are first-come-first-served.
 
-#define	LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY		1
+#define	LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY		0
 
 
 namespace LLCore
@@ -153,6 +155,10 @@ const int HTTP_CONNECTION_LIMIT_MAX = 256;
 const long HTTP_PIPELINING_DEFAULT = 0L;
 const long HTTP_PIPELINING_MAX = 20L;
 
+// Largest response body given a single contiguous block up front
+// from its Content-Length.  Bigger bodies grow block by block.
+const size_t HTTP_REPLY_RESERVE_MAX = 16 * 1024 * 1024;
+
 // Miscellaneous defaults
 const bool HTTP_USE_RETRY_AFTER_DEFAULT = true;
 const long HTTP_THROTTLE_RATE_DEFAULT = 0L;
@@ -163,6 +169,11 @@ const long HTTP_THROTTLE_RATE_DEFAULT = 0L;
 // request, ready and active queues.
 const int HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS = 2;
 
+// Longest the worker thread waits for socket activity when
+// only active transfers remain.  Sockets, libcurl timeouts
+// and new requests all end the wait early.
+const int HTTP_SERVICE_LOOP_WAIT_MAX_MS = 100;
+
 // Block allocation size (a tuning parameter) is found
 // in bufferarray.h.
 
@@ -32,6 +32,7 @@
 #include "_httppolicy.h"
 
 #include "llhttpconstants.h"
+#include "lltimer.h"
 
 namespace
 {
@@ -76,6 +77,19 @@ HttpLibcurl::~HttpLibcurl()
 }
 
 
+// static
+bool HttpLibcurl::canMultiplex()
+{
+#if defined(CURLPIPE_MULTIPLEX) && LIBCURL_VERSION_NUM >= 0x072f00
+	static const bool multiplex(0 != (curl_version_info(CURLVERSION_NOW)->features
+									  & CURL_VERSION_HTTP2));
+	return multiplex;
+#else
+	return false;
+#endif
+}
+
+
 void HttpLibcurl::shutdown()
 {
 	while (! mActiveOps.empty())
@@ -211,6 +225,77 @@ HttpService::ELoopSpeed HttpLibcurl::processTransport()
 }
 
 
+void HttpLibcurl::waitForActivity(curl_socket_t wake_socket, long max_wait_ms)
+{
+	fd_set read_fds, write_fds, exc_fds;
+	FD_ZERO(&read_fds);
+	FD_ZERO(&write_fds);
+	FD_ZERO(&exc_fds);
+	int max_fd(-1);
+	long timeout_ms(max_wait_ms);
+
+	bool can_wake(CURL_SOCKET_BAD != wake_socket);
+#if ! LL_WINDOWS
+	// A POSIX fd_set only holds descriptors below FD_SETSIZE
+	// (libcurl's own sockets are checked by curl_multi_fdset()).
+	if (can_wake && int(wake_socket) >= FD_SETSIZE)
+	{
+		LL_WARNS_ONCE(LOG_CORE) << "Wake socket " << wake_socket
+								 << " is past FD_SETSIZE, polling instead" << LL_ENDL;
+		can_wake = false;
+	}
+#endif
+
+	if (! can_wake)
+	{
+		// New requests can't interrupt the wait, don't sleep
+		// past the old polling interval.
+		timeout_ms = (std::min)(timeout_ms, long(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS));
+	}
+	else
+	{
+		FD_SET(wake_socket, &read_fds);
+		max_fd = int(wake_socket);
+	}
+
+	for (int policy_class(0); policy_class < mPolicyCount; ++policy_class)
+	{
+		if (! mMultiHandles[policy_class] || ! mActiveHandles[policy_class])
+		{
+			continue;
+		}
+
+		int class_max_fd(-1);
+		curl_multi_fdset(mMultiHandles[policy_class], &read_fds, &write_fds, &exc_fds, &class_max_fd);
+		max_fd = (std::max)(max_fd, class_max_fd);
+
+		long class_timeout(-1);
+		if (CURLM_OK == curl_multi_timeout(mMultiHandles[policy_class], &class_timeout)
+			&& class_timeout >= 0)
+		{
+			timeout_ms = (std::min)(timeout_ms, class_timeout);
+		}
+	}
+
+	if (timeout_ms <= 0)
+	{
+		return;
+	}
+	if (max_fd < 0)
+	{
+		// Nothing to select on (libcurl may be resolving a name
+		// in a thread), just wait out the timeout.
+		ms_sleep(timeout_ms);
+		return;
+	}
+
+	struct timeval timeout;
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_usec = (timeout_ms % 1000) * 1000;
+	select(max_fd + 1, &read_fds, &write_fds, &exc_fds, &timeout);
+}
+
+
 // Caller has provided us with a ref count on op.
 void HttpLibcurl::addOp(const HttpOpRequest::ptr_t &op)
 {
@@ -477,10 +562,18 @@ void HttpLibcurl::policyUpdated(int policy_class)
 
 		if (options.mPipelining > 1)
 		{
-			// We'll try to do pipelining on this multihandle
+			// We'll try to do pipelining on this multihandle,
+			// multiplexing instead where the server speaks HTTP/2.
+			long pipelining(1L);
+#if defined(CURLPIPE_MULTIPLEX)
+			if (canMultiplex())
+			{
+				pipelining = CURLPIPE_HTTP1 | CURLPIPE_MULTIPLEX;
+			}
+#endif
 			check_curl_multi_setopt(multi_handle,
 									 CURLMOPT_PIPELINING,
-									 1L);
+									 pipelining);
 			check_curl_multi_setopt(multi_handle,
 									 CURLMOPT_MAX_PIPELINE_LENGTH,
 									 long(options.mPipelining));
@@ -77,6 +77,15 @@ public:
 	/// Threading:  called by worker thread.
 	HttpService::ELoopSpeed processTransport();
 
+	/// Block until libcurl has socket activity on an active
+	/// request, one of libcurl's own timeouts comes due,
+	/// @wake_socket becomes readable or @max_wait_ms passes,
+	/// whichever is first.  Replaces a fixed sleep between
+	/// calls to @processTransport.
+	///
+	/// Threading:  called by worker thread.
+	void waitForActivity(curl_socket_t wake_socket, long max_wait_ms);
+
 	/// Add request to the active list.  Caller is expected to have
 	/// provided us with a reference count on the op to hold the
 	/// request.  (No additional references will be added.)
@@ -126,6 +135,14 @@ public:
 	/// Threading:  called by worker thread.
 	void policyUpdated(int policy_class);
 
+	/// True if the libcurl we're running against can multiplex
+	/// requests over HTTP/2.  Pipelined policy classes then ask
+	/// for HTTP/2 and fall back to HTTP/1.1 pipelining for servers
+	/// that don't offer it.
+	///
+	/// Threading:  callable by any thread.
+	static bool canMultiplex();
+
 	/// Allocate a curl handle for caller.  May be freed using
 	/// either the freeHandle() method or calling curl_easy_cleanup()
 	/// directly.
@@ -153,6 +153,8 @@ HttpOpRequest::HttpOpRequest()
 	  mPolicyRetryLimit(HTTP_RETRY_COUNT_DEFAULT),
 	  mPolicyMinRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MIN_DEFAULT)),
 	  mPolicyMaxRetryBackoff(HttpTime(HTTP_RETRY_BACKOFF_MAX_DEFAULT)),
+	  mPolicyReadyIndex(-1),
+	  mPolicyReadySequence(0),
 	  mCallbackSSLVerify(NULL)
 {
 	// *NOTE:  As members are added, retry initialization/cleanup
@@ -735,12 +737,17 @@ HttpStatus HttpOpRequest::prepareRequest(HttpService * service)
 		// xfer_timeout *= cpolicy.mPipelining;
 		xfer_timeout *= 2L;
 
-		// Also try requesting HTTP/2.
-/******************************/
-		// but for test purposes, only if overriding VIEWERASSET
-		if (getenv("VIEWERASSET"))
-/******************************/
-		check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_0);
+		// Also try HTTP/2.  ALPN picks it only when the server offers
+		// it, otherwise we stay on HTTP/1.1 pipelining.  PIPEWAIT has
+		// new requests wait for a connection they can multiplex onto
+		// rather than opening another one.
+#if LIBCURL_VERSION_NUM >= 0x072f00
+		if (HttpLibcurl::canMultiplex())
+		{
+			check_curl_easy_setopt(mCurlHandle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+			check_curl_easy_setopt(mCurlHandle, CURLOPT_PIPEWAIT, 1L);
+		}
+#endif
 	}
 	// *DEBUG:  Enable following override for timeout handling and "[curl:bugs] #1420" tests
     //if (cpolicy.mPipelining)
@@ -780,6 +787,16 @@ size_t HttpOpRequest::writeCallback(void * data, size_t size, size_t nmemb, void
 	if (! op->mReplyBody)
 	{
 		op->mReplyBody = new BufferArray();
+
+		// When the length is known, keep the body in one block so
+		// consumers can use it in place (BufferArray::contiguousData()).
+		double length(-1.0);
+		if (CURLE_OK == curl_easy_getinfo(op->mCurlHandle, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &length)
+			&& length > 0.0
+			&& length <= double(HTTP_REPLY_RESERVE_MAX))
+		{
+			op->mReplyBody->reserve(size_t(length));
+		}
 	}
 	const size_t req_size(size * nmemb);
 	const size_t write_size(op->mReplyBody->append(static_cast<char *>(data), req_size));
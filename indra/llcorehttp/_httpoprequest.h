@@ -38,6 +38,7 @@
 
 #include "httpcommon.h"
 #include "httprequest.h"
+#include "_httpinternal.h"
 #include "_httpoperation.h"
 #include "_refcounted.h"
 
@@ -235,6 +236,8 @@ public:
 	int					mPolicyRetryLimit;
 	HttpTime			mPolicyMinRetryBackoff; // initial delay between retries (mcs)
 	HttpTime			mPolicyMaxRetryBackoff;
+	int					mPolicyReadyIndex;		// Position in HttpReadyQueue, -1 if not queued
+	U64					mPolicyReadySequence;	// Arrival order in HttpReadyQueue
 };  // end class HttpOpRequest
 
 
@@ -242,12 +245,22 @@ public:
 /// HttpOpRequestCompare isn't an operation but a uniform comparison
 /// functor for STL containers that order by priority.  Mainly
 /// used for the ready queue container but defined here.
+///
+/// Follows the std::priority_queue convention:  returns true if
+/// lhs should be issued after rhs.  Higher priority values go
+/// first and equal priorities are served in arrival order.
 class HttpOpRequestCompare
 {
 public:
-	bool operator()(const HttpOpRequest * lhs, const HttpOpRequest * rhs)
+	bool operator()(const HttpOpRequest::ptr_t & lhs, const HttpOpRequest::ptr_t & rhs) const
 		{
-			return lhs->mReqPriority > rhs->mReqPriority;
+#if ! LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
+			if (lhs->mReqPriority != rhs->mReqPriority)
+			{
+				return lhs->mReqPriority < rhs->mReqPriority;
+			}
+#endif
+			return lhs->mPolicyReadySequence > rhs->mPolicyReadySequence;
 		}
 };  // end class HttpOpRequestCompare
 
@@ -33,6 +33,8 @@
 #include "_httplibcurl.h"
 #include "_httppolicyclass.h"
 
+#include <algorithm>
+
 #include "lltimer.h"
 #include "httpstats.h"
 
@@ -333,68 +335,47 @@ HttpService::ELoopSpeed HttpPolicy::processReadyQueue()
 
 bool HttpPolicy::changePriority(HttpHandle handle, HttpRequest::priority_t priority)
 {
-	for (int policy_class(0); policy_class < mClasses.size(); ++policy_class)
+	// We don't look in the retry queue because a priority change there
+	// is meaningless.  The request will be issued based on retry
+	// intervals not priority value, which is now moot.
+	HttpOpRequest::ptr_t op(HttpOperation::fromHandle<HttpOpRequest>(handle));
+	if (! op || op->mReqPolicy >= mClasses.size())
 	{
-		ClassState & state(*mClasses[policy_class]);
-		// We don't scan retry queue because a priority change there
-		// is meaningless.  The request will be issued based on retry
-		// intervals not priority value, which is now moot.
-		
-		// Scan ready queue for requests that match policy
-		HttpReadyQueue::container_type & c(state.mReadyQueue.get_container());
-		for (HttpReadyQueue::container_type::iterator iter(c.begin()); c.end() != iter;)
-		{
-			HttpReadyQueue::container_type::iterator cur(iter++);
-
-			if ((*cur)->getHandle() == handle)
-			{
-				HttpOpRequest::ptr_t op(*cur);
-				c.erase(cur);									// All iterators are now invalidated
-				op->mReqPriority = priority;
-				state.mReadyQueue.push(op);						// Re-insert using adapter class
-				return true;
-			}
-		}
+		return false;
 	}
-	
-	return false;
+
+	// The ready queue knows where the request sits, no scan needed
+	return mClasses[op->mReqPolicy]->mReadyQueue.reprioritize(op, priority);
 }
 
 
 bool HttpPolicy::cancel(HttpHandle handle)
 {
-	for (int policy_class(0); policy_class < mClasses.size(); ++policy_class)
+	HttpOpRequest::ptr_t op(HttpOperation::fromHandle<HttpOpRequest>(handle));
+	if (! op || op->mReqPolicy >= mClasses.size())
 	{
-		ClassState & state(*mClasses[policy_class]);
-
-		// Scan retry queue
-		HttpRetryQueue::container_type & c1(state.mRetryQueue.get_container());
-		for (HttpRetryQueue::container_type::iterator iter(c1.begin()); c1.end() != iter;)
-		{
-			HttpRetryQueue::container_type::iterator cur(iter++);
+		return false;
+	}
+	ClassState & state(*mClasses[op->mReqPolicy]);
 
-			if ((*cur)->getHandle() == handle)
-			{
-				HttpOpRequest::ptr_t op(*cur);
-				c1.erase(cur);									// All iterators are now invalidated
-				op->cancel();
-				return true;
-			}
-		}
-		
-		// Scan ready queue
-		HttpReadyQueue::container_type & c2(state.mReadyQueue.get_container());
-		for (HttpReadyQueue::container_type::iterator iter(c2.begin()); c2.end() != iter;)
+	// Ready queue first, it's where nearly all waiting requests are
+	if (state.mReadyQueue.remove(op))
+	{
+		op->cancel();
+		return true;
+	}
+	
+	// Scan retry queue
+	HttpRetryQueue::container_type & c1(state.mRetryQueue.get_container());
+	for (HttpRetryQueue::container_type::iterator iter(c1.begin()); c1.end() != iter; ++iter)
+	{
+		if (*iter == op)
 		{
-			HttpReadyQueue::container_type::iterator cur(iter++);
-
-			if ((*cur)->getHandle() == handle)
-			{
-				HttpOpRequest::ptr_t op(*cur);
-				c2.erase(cur);									// All iterators are now invalidated
-				op->cancel();
-				return true;
-			}
+			c1.erase(iter);
+			// Erasing from the middle breaks heap order, restore it
+			std::make_heap(c1.begin(), c1.end(), HttpOpRetryCompare());
+			op->cancel();
+			return true;
 		}
 	}
 	
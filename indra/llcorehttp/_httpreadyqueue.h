@@ -28,7 +28,7 @@
 #define	_LLCORE_HTTP_READY_QUEUE_H_
 
 
-#include <queue>
+#include <vector>
 
 #include "_httpinternal.h"
 #include "_httpoprequest.h"
@@ -37,84 +37,182 @@
 namespace LLCore
 {
 
-/// HttpReadyQueue provides a simple priority queue for HttpOpRequest objects.
+/// HttpReadyQueue provides a priority queue for HttpOpRequest objects.
 ///
-/// This uses the priority_queue adaptor class to provide the queue
-/// as well as the ordering scheme while allowing us access to the
-/// raw container if we follow a few simple rules.  One of the more
-/// important of those rules is that any iterator becomes invalid
-/// on element erasure.  So pay attention.
+/// This is a binary heap ordered by HttpOpRequestCompare that
+/// records each request's position in the request itself
+/// (mPolicyReadyIndex).  That lets a priority change or a
+/// cancel find and fix up a queued request in O(log n) rather
+/// than scanning and rebuilding the queue, which matters when
+/// the texture and mesh fetchers keep hundreds of requests
+/// queued and reprioritize them as the camera moves.
 ///
-/// If LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY tests true, the class
-/// implements a std::priority_queue interface but on std::deque
-/// behavior to eliminate sensitivity to priority.  In the future,
-/// this will likely become the only behavior or it may become
-/// a run-time election.
+/// Requests of equal priority are served first-come-first-served.
+/// If LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY tests true, priority
+/// is ignored entirely and a reprioritization moves the request
+/// to the back of the queue.
+///
+/// A request may be in at most one ready queue at a time.
 ///
 /// Threading:  not thread-safe.  Expected to be used entirely by
 /// a single thread, typically a worker thread of some sort.
 
-#if LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
-
-typedef std::deque<HttpOpRequest::ptr_t> HttpReadyQueueBase;
-
-#else
-
-typedef std::priority_queue<HttpOpRequest::ptr_t,
-							std::deque<HttpOpRequest::ptr_t>,
-							LLCore::HttpOpRequestCompare> HttpReadyQueueBase;
-
-#endif // LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
-
-class HttpReadyQueue : public HttpReadyQueueBase
+class HttpReadyQueue
 {
 public:
+	typedef std::vector<HttpOpRequest::ptr_t> container_type;
+	typedef container_type::size_type size_type;
+	
 	HttpReadyQueue()
-		: HttpReadyQueueBase()
+		: mNextSequence(0)
 		{}
 	
 	~HttpReadyQueue()
-		{}
+		{
+			clear();
+		}
 	
 protected:
 	HttpReadyQueue(const HttpReadyQueue &);		// Not defined
 	void operator=(const HttpReadyQueue &);		// Not defined
 
 public:
+	bool empty() const
+		{
+			return mHeap.empty();
+		}
 
-#if LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
-	// Types and methods needed to make a std::deque look
-	// more like a std::priority_queue, at least for our
-	// purposes.
-	typedef HttpReadyQueueBase container_type;
+	size_type size() const
+		{
+			return mHeap.size();
+		}
 	
-	const_reference top() const
+	const HttpOpRequest::ptr_t & top() const
 		{
-			return front();
+			return mHeap.front();
 		}
 
+	void push(const HttpOpRequest::ptr_t & op)
+		{
+			op->mPolicyReadySequence = mNextSequence++;
+			mHeap.push_back(op);
+			op->mPolicyReadyIndex = int(mHeap.size() - 1);
+			siftUp(mHeap.size() - 1);
+		}
+	
 	void pop()
 		{
-			pop_front();
+			HttpOpRequest::ptr_t op(mHeap.front());
+			remove(op);
 		}
 
-	void push(const value_type & v)
+	bool contains(const HttpOpRequest::ptr_t & op) const
 		{
-			push_back(v);
+			const int index(op->mPolicyReadyIndex);
+			return index >= 0 && index < int(mHeap.size()) && mHeap[index] == op;
 		}
 	
-#endif // LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
+	/// Take a request out of the queue wherever it is.
+	/// Returns false if the request wasn't in this queue.
+	bool remove(const HttpOpRequest::ptr_t & op)
+		{
+			if (! contains(op))
+			{
+				return false;
+			}
+			const size_type index(op->mPolicyReadyIndex);
+			op->mPolicyReadyIndex = -1;
+
+			HttpOpRequest::ptr_t last(mHeap.back());
+			mHeap.pop_back();
+			if (index < mHeap.size())
+			{
+				place(index, last);
+				siftDown(siftUp(index));
+			}
+			return true;
+		}
+
+	/// Change a queued request's priority and restore heap order.
+	/// Returns false if the request wasn't in this queue.
+	bool reprioritize(const HttpOpRequest::ptr_t & op, HttpRequest::priority_t priority)
+		{
+			if (! contains(op))
+			{
+				return false;
+			}
+			op->mReqPriority = priority;
+#if LLCORE_HTTP_READY_QUEUE_IGNORES_PRIORITY
+			op->mPolicyReadySequence = mNextSequence++;
+#endif
+			siftDown(siftUp(op->mPolicyReadyIndex));
+			return true;
+		}
+
+	void clear()
+		{
+			for (container_type::iterator it(mHeap.begin()); mHeap.end() != it; ++it)
+			{
+				(*it)->mPolicyReadyIndex = -1;
+			}
+			mHeap.clear();
+		}
 	
 	const container_type & get_container() const
 		{
-			return *this;
+			return mHeap;
 		}
 
-	container_type & get_container()
+protected:
+	void place(size_type index, const HttpOpRequest::ptr_t & op)
 		{
-			return *this;
+			mHeap[index] = op;
+			op->mPolicyReadyIndex = int(index);
 		}
 	
+	size_type siftUp(size_type index)
+		{
+			HttpOpRequest::ptr_t op(mHeap[index]);
+			while (index > 0)
+			{
+				const size_type parent((index - 1) / 2);
+				if (! mCompare(mHeap[parent], op))
+				{
+					break;
+				}
+				place(index, mHeap[parent]);
+				index = parent;
+			}
+			place(index, op);
+			return index;
+		}
+
+	size_type siftDown(size_type index)
+		{
+			const size_type count(mHeap.size());
+			HttpOpRequest::ptr_t op(mHeap[index]);
+			for (size_type child(2 * index + 1); child < count; child = 2 * index + 1)
+			{
+				if (child + 1 < count && mCompare(mHeap[child], mHeap[child + 1]))
+				{
+					++child;
+				}
+				if (! mCompare(op, mHeap[child]))
+				{
+					break;
+				}
+				place(index, mHeap[child]);
+				index = child;
+			}
+			place(index, op);
+			return index;
+		}
+	
+protected:
+	container_type			mHeap;
+	HttpOpRequestCompare	mCompare;
+	U64						mNextSequence;
+	
 }; // end class HttpReadyQueue
 
 
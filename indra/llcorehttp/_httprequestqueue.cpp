@@ -29,6 +29,20 @@
 #include "_httpoperation.h"
 #include "_mutex.h"
 
+#if ! LL_WINDOWS
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+static const char * const LOG_CORE("CoreHttp");
+
+} // end anonymous namespace
+
 
 using namespace LLCoreInt;
 
@@ -40,7 +54,9 @@ HttpRequestQueue * HttpRequestQueue::sInstance(NULL);
 
 HttpRequestQueue::HttpRequestQueue()
 	: RefCounted(true),
-	  mQueueStopped(false)
+	  mQueueStopped(false),
+	  mWakeRecv(CURL_SOCKET_BAD),
+	  mWakeSend(CURL_SOCKET_BAD)
 {
 }
 
@@ -48,6 +64,7 @@ HttpRequestQueue::HttpRequestQueue()
 HttpRequestQueue::~HttpRequestQueue()
 {
     mQueue.clear();
+	closeWakeSocket();
 }
 
 
@@ -81,6 +98,10 @@ HttpStatus HttpRequestQueue::addOp(const HttpRequestQueue::opPtr_t &op)
 		}
 		wake = mQueue.empty();
 		mQueue.push_back(op);
+		if (wake)
+		{
+			signalWakeSocket();
+		}
 	}
 	if (wake)
 	{
@@ -149,7 +170,97 @@ void HttpRequestQueue::stopQueue()
 
 		mQueueStopped = true;
 		wakeAll();
+		signalWakeSocket();
+	}
+}
+
+
+void HttpRequestQueue::openWakeSocket()
+{
+	HttpScopedLock lock(mQueueMutex);
+
+	if (CURL_SOCKET_BAD != mWakeRecv)
+	{
+		return;
+	}
+
+	// A connected pair of loopback UDP sockets rather than a pipe
+	// so that the read end works with select() on every platform.
+	mWakeRecv = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	mWakeSend = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	curl_socklen_t addr_len(sizeof(addr));
+
+	if (CURL_SOCKET_BAD == mWakeRecv
+		|| CURL_SOCKET_BAD == mWakeSend
+		|| bind(mWakeRecv, (struct sockaddr *) &addr, sizeof(addr))
+		|| getsockname(mWakeRecv, (struct sockaddr *) &addr, &addr_len)
+		|| connect(mWakeSend, (struct sockaddr *) &addr, sizeof(addr)))
+	{
+		LL_WARNS(LOG_CORE) << "Unable to create request queue wake socket, "
+						   << "HTTP worker will poll."
+						   << LL_ENDL;
+		closeWakeSocket();
+		return;
+	}
+
+	// Neither end may ever block.  A full send buffer already
+	// means a wakeup is pending.
+#if LL_WINDOWS
+	u_long non_blocking(1);
+	ioctlsocket(mWakeRecv, FIONBIO, &non_blocking);
+	ioctlsocket(mWakeSend, FIONBIO, &non_blocking);
+#else
+	fcntl(mWakeRecv, F_SETFL, fcntl(mWakeRecv, F_GETFL) | O_NONBLOCK);
+	fcntl(mWakeSend, F_SETFL, fcntl(mWakeSend, F_GETFL) | O_NONBLOCK);
+#endif
+}
+
+
+void HttpRequestQueue::drainWakeSocket()
+{
+	if (CURL_SOCKET_BAD == mWakeRecv)
+	{
+		return;
+	}
+
+	char buffer[64];
+	while (recv(mWakeRecv, buffer, sizeof(buffer), 0) > 0)
+		;
+}
+
+
+// Threading:  caller holds mQueueMutex.
+void HttpRequestQueue::signalWakeSocket()
+{
+	if (CURL_SOCKET_BAD != mWakeSend)
+	{
+		const char wake(1);
+		send(mWakeSend, &wake, sizeof(wake), 0);
+	}
+}
+
+
+void HttpRequestQueue::closeWakeSocket()
+{
+	curl_socket_t sockets[2] = { mWakeRecv, mWakeSend };
+	for (int i(0); i < 2; ++i)
+	{
+		if (CURL_SOCKET_BAD != sockets[i])
+		{
+#if LL_WINDOWS
+			closesocket(sockets[i]);
+#else
+			close(sockets[i]);
+#endif
+		}
 	}
+	mWakeRecv = mWakeSend = CURL_SOCKET_BAD;
 }
 
 
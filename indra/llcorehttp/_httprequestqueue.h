@@ -125,6 +125,33 @@ public:
 	///
 	/// Threading:  callable by any thread.
 	void stopQueue();
+
+	/// Create the wake socket returned by @getWakeSocket.  Done
+	/// once networking is initialized, before the worker starts.
+	///
+	/// Threading:  callable by init thread.
+	void openWakeSocket();
+
+	/// Socket that becomes readable when @addOp puts an operation
+	/// on an empty queue or the queue is stopped.  Lets the worker
+	/// wait in select() on libcurl's sockets and still see new
+	/// requests right away.  CURL_SOCKET_BAD if it couldn't be
+	/// created, callers should then poll as before.
+	///
+	/// Threading:  callable by worker thread.
+	curl_socket_t getWakeSocket() const
+		{
+			return mWakeRecv;
+		}
+
+	/// Discard pending wakeups on the wake socket.
+	///
+	/// Threading:  callable by worker thread.
+	void drainWakeSocket();
+
+protected:
+	void signalWakeSocket();
+	void closeWakeSocket();
 	
 protected:
 	static HttpRequestQueue *			sInstance;
@@ -134,6 +161,8 @@ protected:
 	LLCoreInt::HttpMutex				mQueueMutex;
 	LLCoreInt::HttpConditionVariable	mQueueCV;
 	bool								mQueueStopped;
+	curl_socket_t						mWakeRecv;		// Loopback UDP pair, see @getWakeSocket
+	curl_socket_t						mWakeSend;
 	
 }; // end class HttpRequestQueue
 
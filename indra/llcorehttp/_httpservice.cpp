@@ -201,6 +201,7 @@ void HttpService::startThread()
 	// Push current policy definitions, enable policy & transport components
 	mPolicy->start();
 	mTransport->start(mLastPolicy + 1);
+	mRequestQueue->openWakeSocket();
 
 	mThread = new LLCoreInt::HttpThread(boost::bind(&HttpService::threadRun, this, _1));
 	sState = RUNNING;
@@ -299,17 +300,24 @@ void HttpService::threadRun(LLCoreInt::HttpThread * thread)
 		    loop = processRequestQueue(loop);
 
 		    // Process ready queue issuing new requests as needed
-		    ELoopSpeed new_loop = mPolicy->processReadyQueue();
-		    loop = (std::min)(loop, new_loop);
+		    const ELoopSpeed policy_loop(mPolicy->processReadyQueue());
+		    loop = (std::min)(loop, policy_loop);
 		
 		    // Give libcurl some cycles
-		    new_loop = mTransport->processTransport();
+		    ELoopSpeed new_loop = mTransport->processTransport();
 		    loop = (std::min)(loop, new_loop);
 		
-		    // Determine whether to spin, sleep briefly or sleep for next request
+		    // Determine whether to spin, wait briefly or sleep for next request.
+		    // Waits end early on socket activity or a new request.  Queued
+		    // retries and throttled requests run on timers, so keep the old
+		    // polling interval while the policy layer has any.
 		    if (REQUEST_SLEEP != loop)
 		    {
-			    ms_sleep(HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS);
+			    mTransport->waitForActivity(mRequestQueue->getWakeSocket(),
+											NORMAL == policy_loop
+											? HTTP_SERVICE_LOOP_SLEEP_NORMAL_MS
+											: HTTP_SERVICE_LOOP_WAIT_MAX_MS);
+			    mRequestQueue->drainWakeSocket();
 		    }
         }
         catch (const LLContinueError&)
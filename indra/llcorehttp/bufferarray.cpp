@@ -28,6 +28,10 @@
 #include "llexception.h"
 #include "llmemory.h"
 
+#include <new>
+
+#include "_mutex.h"
+
 
 // BufferArray is a list of chunks, each a BufferArray::Block, of contiguous
 // data presented as a single array.  Chunks are at least BufferArray::BLOCK_ALLOC_SIZE
@@ -40,6 +44,53 @@
 // all take position arguments.  Single write/shared read isn't supported
 // directly and any such attempts have to be serialized outside of this
 // implementation.
+//
+// Block memory comes from a pool shared by all instances.  Sizes are
+// rounded up to one of a few classes, powers of two multiples of
+// BLOCK_ALLOC_SIZE, and released blocks are kept for reuse up to the
+// pool limit.  Larger blocks always go straight to the heap.
+
+namespace
+{
+
+// Classes are BLOCK_ALLOC_SIZE << 0 .. BLOCK_ALLOC_SIZE << (count - 1)
+const int POOL_CLASS_COUNT = 5;
+
+struct BlockPool
+{
+	BlockPool()
+		: mLimit(0)
+		{
+			memset(&mStats, 0, sizeof(mStats));
+		}
+
+	LLCoreInt::HttpMutex				mMutex;
+	std::vector<char *>					mFree[POOL_CLASS_COUNT];
+	size_t								mLimit;
+	LLCore::BufferArray::PoolStats		mStats;
+};
+
+BlockPool & get_pool()
+{
+	static BlockPool pool;
+	return pool;
+}
+
+// Returns the size class for a block of 'len' bytes, -1 if too large
+int get_pool_class(size_t len)
+{
+	for (int pool_class(0); pool_class < POOL_CLASS_COUNT; ++pool_class)
+	{
+		if (len <= (LLCore::BufferArray::BLOCK_ALLOC_SIZE << pool_class))
+		{
+			return pool_class;
+		}
+	}
+	return -1;
+}
+
+} // end anonymous namespace
+
 
 namespace LLCore
 {
@@ -51,25 +102,18 @@ namespace LLCore
 
 class BufferArray::Block
 {
-public:
-	~Block();
-
-	void operator delete(void *);
-	void operator delete(void *, size_t len);
-
 protected:
 	Block(size_t len);
+	~Block();
 
 	Block(const Block &);						// Not defined
 	void operator=(const Block &);				// Not defined
 
-	// Allocate the block with the additional space for the
-	// buffered data at the end of the object.
-	void * operator new(size_t len, size_t addl_len);
-	
 public:
-	// Only public entry to get a block.
+	// Only public entries to get and release a block.  The
+	// block may be larger than asked for, see mAlloced.
 	static Block * alloc(size_t len);
+	static void free(Block * block);
 
 public:
 	size_t mUsed;
@@ -103,7 +147,7 @@ BufferArray::~BufferArray()
 		 it != mBlocks.end();
 		 ++it)
 	{
-		delete *it;
+		Block::free(*it);
 		*it = NULL;
 	}
 	mBlocks.clear();
@@ -177,6 +221,7 @@ void * BufferArray::appendBufferAlloc(size_t len)
 		mBlocks.reserve(mBlocks.size() + 5);
 	}
 	Block * block = Block::alloc((std::max)(BLOCK_ALLOC_SIZE, len));
+	memset(block->mData, 0, len);
 	block->mUsed = len;
 	mBlocks.push_back(block);
 	mLen += len;
@@ -184,6 +229,49 @@ void * BufferArray::appendBufferAlloc(size_t len)
 }
 
 
+void BufferArray::reserve(size_t len)
+{
+	if (! mBlocks.empty())
+	{
+		const Block & last(*mBlocks.back());
+		if (last.mAlloced - last.mUsed >= len)
+		{
+			// Already fits
+			return;
+		}
+	}
+	if (mBlocks.size() >= mBlocks.capacity())
+	{
+		mBlocks.reserve(mBlocks.size() + 5);
+	}
+	// An empty block, append() will fill it
+	mBlocks.push_back(Block::alloc((std::max)(BLOCK_ALLOC_SIZE, len)));
+}
+
+
+char * BufferArray::contiguousData(size_t pos, size_t len)
+{
+	if (pos + len > mLen)
+	{
+		return NULL;
+	}
+	size_t offset(0);
+	const int block(findBlock(pos, &offset));
+	if (block < 0)
+	{
+		return NULL;
+	}
+
+	Block & b(*mBlocks[block]);
+	if (b.mUsed - offset < len)
+	{
+		// Spans blocks
+		return NULL;
+	}
+	return &b.mData[offset];
+}
+
+
 size_t BufferArray::read(size_t pos, void * dst, size_t len)
 {
 	char * c_dst(static_cast<char *>(dst));
@@ -326,9 +414,7 @@ bool BufferArray::getBlockStartEnd(int block, const char ** start, const char **
 BufferArray::Block::Block(size_t len)
 	: mUsed(0),
 	  mAlloced(len)
-{
-	memset(mData, 0, len);
-}
+{}
 			
 
 BufferArray::Block::~Block()
@@ -338,30 +424,115 @@ BufferArray::Block::~Block()
 }
 
 
-void * BufferArray::Block::operator new(size_t len, size_t addl_len)
+BufferArray::Block * BufferArray::Block::alloc(size_t len)
 {
-	void * mem = new char[len + addl_len + sizeof(void *)];
-	return mem;
+	const int pool_class(get_pool_class(len));
+	if (pool_class >= 0)
+	{
+		len = BLOCK_ALLOC_SIZE << pool_class;
+	}
+
+	char * mem(NULL);
+	{
+		BlockPool & pool(get_pool());
+		LLCoreInt::HttpScopedLock lock(pool.mMutex);
+
+		++pool.mStats.mBlockAllocs;
+		if (pool_class >= 0 && ! pool.mFree[pool_class].empty())
+		{
+			mem = pool.mFree[pool_class].back();
+			pool.mFree[pool_class].pop_back();
+			pool.mStats.mPooledBytes -= len;
+			++pool.mStats.mPoolHits;
+		}
+		else
+		{
+			pool.mStats.mHeapBytes += len;
+		}
+	}
+
+	if (! mem)
+	{
+		// Additional space for the buffered data at the end of the object
+		mem = new char[sizeof(Block) + len];
+	}
+	return new (mem) Block(len);
 }
 
 
-void BufferArray::Block::operator delete(void * mem)
+void BufferArray::Block::free(Block * block)
 {
-	char * cmem = static_cast<char *>(mem);
-	delete [] cmem;
+	if (! block)
+	{
+		return;
+	}
+
+	const size_t len(block->mAlloced);
+	const int pool_class(get_pool_class(len));
+	block->~Block();
+	char * mem(reinterpret_cast<char *>(block));
+	
+	if (pool_class >= 0 && len == (BLOCK_ALLOC_SIZE << pool_class))
+	{
+		BlockPool & pool(get_pool());
+		LLCoreInt::HttpScopedLock lock(pool.mMutex);
+
+		if (pool.mStats.mPooledBytes + len <= pool.mLimit)
+		{
+			pool.mFree[pool_class].push_back(mem);
+			pool.mStats.mPooledBytes += len;
+			return;
+		}
+	}
+	delete [] mem;
 }
 
 
-void BufferArray::Block::operator delete(void * mem, size_t)
+// static
+void BufferArray::setPoolLimit(size_t bytes)
 {
-	operator delete(mem);
+	std::vector<char *> released;
+	{
+		BlockPool & pool(get_pool());
+		LLCoreInt::HttpScopedLock lock(pool.mMutex);
+
+		pool.mLimit = bytes;
+		for (int pool_class(POOL_CLASS_COUNT - 1);
+			 pool_class >= 0 && pool.mStats.mPooledBytes > pool.mLimit;
+			 --pool_class)
+		{
+			std::vector<char *> & free_list(pool.mFree[pool_class]);
+			while (! free_list.empty() && pool.mStats.mPooledBytes > pool.mLimit)
+			{
+				released.push_back(free_list.back());
+				free_list.pop_back();
+				pool.mStats.mPooledBytes -= BLOCK_ALLOC_SIZE << pool_class;
+			}
+		}
+		if (! pool.mLimit)
+		{
+			// Give back the free list storage as well
+			for (int pool_class(0); pool_class < POOL_CLASS_COUNT; ++pool_class)
+			{
+				std::vector<char *>().swap(pool.mFree[pool_class]);
+			}
+		}
+	}
+
+	for (std::vector<char *>::iterator it(released.begin()); released.end() != it; ++it)
+	{
+		delete [] *it;
+	}
 }
 
 
-BufferArray::Block * BufferArray::Block::alloc(size_t len)
+// static
+void BufferArray::getPoolStats(PoolStats & stats)
 {
-	Block * block = new (len) Block(len);
-	return block;
+	BlockPool & pool(get_pool());
+	LLCoreInt::HttpScopedLock lock(pool.mMutex);
+
+	stats = pool.mStats;
 }
 	
 
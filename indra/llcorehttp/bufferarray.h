@@ -59,10 +59,14 @@ class BufferArrayStreamBuf;
 /// write and append operations and beyond which the current position
 /// cannot be set.
 ///
-/// Threading:  not thread-safe
+/// Threading:  not thread-safe.  The block pool behind all instances
+/// is thread-safe.
 ///
 /// Allocation:  Refcounted, heap only.  Caller of the constructor
-/// is given a single refcount.
+/// is given a single refcount.  Blocks come from a size-classed
+/// pool shared by all instances once @see setPoolLimit() has been
+/// given a non-zero limit.  Otherwise every block is a fresh heap
+/// allocation.
 ///
 class BufferArray : public LLCoreInt::RefCounted
 {
@@ -104,6 +108,19 @@ public:
 	///					of BufferArray of 'len' size.
 	void * appendBufferAlloc(size_t len);
 
+	/// Makes sure the next 'len' bytes appended land in a
+	/// single block so they can later be used in place with
+	/// @see contiguousData().  Doesn't change the size.
+	void reserve(size_t len);
+
+	/// Returns a pointer to 'len' bytes of data starting at
+	/// 'pos' if they are stored contiguously, NULL otherwise
+	/// or if the range extends beyond the data.  Lets a
+	/// consumer use a body in place rather than copying it
+	/// out with @see read().  The pointer is valid until the
+	/// instance is modified or released.
+	char * contiguousData(size_t pos, size_t len);
+
 	/// Current count of bytes in BufferArray instance.
 	size_t size() const
 		{
@@ -120,6 +137,25 @@ public:
 	/// append data when current position is equal to the
 	/// size of the instance or do a mix of both.
 	size_t write(size_t pos, const void * src, size_t len);
+
+	/// Block pool counters, totals since startup.
+	struct PoolStats
+	{
+		U64		mBlockAllocs;		// Blocks handed out
+		U64		mPoolHits;			// ... of which were reused from the pool
+		U64		mHeapBytes;			// Bytes newly allocated from the heap
+		size_t	mPooledBytes;		// Bytes currently held in the pool
+	};
+
+	/// Sets the most memory the block pool may hold on to
+	/// for reuse.  0, the default, disables pooling and frees
+	/// anything currently pooled.
+	///
+	/// Threading:  callable by any thread.
+	static void setPoolLimit(size_t bytes);
+
+	/// Threading:  callable by any thread.
+	static void getPoolStats(PoolStats & stats);
 	
 protected:
 	int findBlock(size_t pos, size_t * ret_offset);
@@ -45,6 +45,8 @@ void HTTPStats::resetStats()
     mDataDown.reset();
     mDataUp.reset();
     mRequests = 0;
+    BufferArray::getPoolStats(mPoolBase);
+    mPoolTimer.reset();
 }
 
 
@@ -94,6 +96,18 @@ void HTTPStats::dumpStats()
     out << "Data Recv: " << byte_count_converter(mDataDown.getSum()) << "   (" << mDataDown.getSum() << ")" << std::endl;
     out << "Total requests: " << mRequests << "(request objects created)" << std::endl;
     out << std::endl;
+
+    BufferArray::PoolStats pool;
+    BufferArray::getPoolStats(pool);
+    const U64 blocks(pool.mBlockAllocs - mPoolBase.mBlockAllocs);
+    const U64 hits(pool.mPoolHits - mPoolBase.mPoolHits);
+    const F32 heap_bytes(F32(pool.mHeapBytes - mPoolBase.mHeapBytes));
+    const F32 seconds(llmax(mPoolTimer.getElapsedTimeF32().value(), 1.f));
+    out << "Body blocks: " << blocks << " allocated, " << hits << " reused from pool" << std::endl;
+    out << "Heap allocated: " << byte_count_converter(heap_bytes) << "   ("
+        << byte_count_converter(heap_bytes / seconds) << "/s)" << std::endl;
+    out << "Pool held: " << byte_count_converter(F32(pool.mPooledBytes)) << std::endl;
+    out << std::endl;
     out << "Result Codes:" << std::endl << "--- -----" << std::endl;
 
     for (std::map<S32, S32>::iterator it = mResutCodes.begin(); it != mResutCodes.end(); ++it)
@@ -32,6 +32,8 @@
 #include "llstatsaccumulator.h"
 #include "llsingleton.h"
 #include "llsd.h"
+#include "lltimer.h"
+#include "bufferarray.h"
 
 namespace LLCore
 {
@@ -67,6 +69,10 @@ namespace LLCore
         S32              mRequests;
 
         std::map<S32, S32> mResutCodes;
+
+        // Response body block pool counters at the last reset
+        BufferArray::PoolStats mPoolBase;
+        LLTimer          mPoolTimer;
     };
 
 
@@ -426,6 +426,92 @@ void BufferArrayTestObjectType::test<8>()
 	ensure("All memory released", mMemTotal == GetMemTotal());
 }
 
+template <> template <>
+void BufferArrayTestObjectType::test<9>()
+{
+	set_test_name("BufferArray reserve and contiguousData");
+
+	// record the total amount of dynamically allocated memory
+	mMemTotal = GetMemTotal();
+
+	// create a new ref counted object with an implicit reference
+	BufferArray * ba = new BufferArray();
+
+	// Reserve more than a block and append in small pieces
+	const size_t body_len(3 * BufferArray::BLOCK_ALLOC_SIZE);
+	ba->reserve(body_len);
+	ensure("Reserve doesn't change size", 0 == ba->size());
+	char str1[] = "abcdefghij";
+	size_t str1_len(strlen(str1));
+	for (size_t i(0); i < body_len / str1_len; ++i)
+	{
+		ba->append(str1, str1_len);
+	}
+	const size_t len(ba->size());
+
+	char * data(ba->contiguousData(0, len));
+	ensure("Whole body contiguous", NULL != data);
+	ensure("Contiguous content correct", 0 == strncmp(data + len - str1_len, str1, str1_len));
+	ensure("Offset range correct", data + 5 == ba->contiguousData(5, 20));
+	ensure("Range beyond data rejected", NULL == ba->contiguousData(1, len));
+
+	// Without a reservation, a body spanning blocks isn't contiguous
+	BufferArray * ba2 = new BufferArray();
+	for (size_t i(0); i < body_len / str1_len; ++i)
+	{
+		ba2->append(str1, str1_len);
+	}
+	ensure("Spanning body not contiguous", NULL == ba2->contiguousData(0, ba2->size()));
+	ensure("Range within a block contiguous", NULL != ba2->contiguousData(0, str1_len));
+
+	// release the implicit references, causing the objects to be released
+	ba->release();
+	ba2->release();
+
+	// make sure we didn't leak any memory
+	ensure("All memory released", mMemTotal == GetMemTotal());
+}
+
+template <> template <>
+void BufferArrayTestObjectType::test<10>()
+{
+	set_test_name("BufferArray block pool reuse");
+
+	// record the total amount of dynamically allocated memory
+	mMemTotal = GetMemTotal();
+
+	BufferArray::PoolStats before;
+	BufferArray::getPoolStats(before);
+	BufferArray::setPoolLimit(4 * BufferArray::BLOCK_ALLOC_SIZE);
+
+	char str1[] = "abcdefghij";
+	size_t str1_len(strlen(str1));
+	char buffer[256];
+	for (int i(0); i < 10; ++i)
+	{
+		BufferArray * ba = new BufferArray();
+		ba->append(str1, str1_len);
+		memset(buffer, 'X', sizeof(buffer));
+		ensure("Read content correct", str1_len == ba->read(0, buffer, sizeof(buffer))
+			   && 0 == strncmp(buffer, str1, str1_len));
+		ba->release();
+	}
+
+	BufferArray::PoolStats after;
+	BufferArray::getPoolStats(after);
+	ensure("Blocks allocated", 10 == after.mBlockAllocs - before.mBlockAllocs);
+	ensure("Blocks reused", 9 == after.mPoolHits - before.mPoolHits);
+	ensure("Block pooled", BufferArray::BLOCK_ALLOC_SIZE == after.mPooledBytes);
+
+	// Turning the pool off gives everything back
+	BufferArray::setPoolLimit(0);
+	BufferArray::getPoolStats(after);
+	ensure("Pool empty", 0 == after.mPooledBytes);
+
+	// make sure we didn't leak any memory
+	ensure("All memory released", mMemTotal == GetMemTotal());
+}
+
 }  // end namespace tut
 
 
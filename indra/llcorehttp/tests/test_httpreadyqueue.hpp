@@ -0,0 +1,222 @@
+/**
+ * @file test_httpreadyqueue.hpp
+ * @brief unit tests for the LLCore::HttpReadyQueue priority queue
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+#ifndef TEST_LLCORE_HTTP_READYQUEUE_H_
+#define TEST_LLCORE_HTTP_READYQUEUE_H_
+
+#include "_httpreadyqueue.h"
+
+#include <algorithm>
+#include <vector>
+
+
+using namespace LLCore;
+
+
+namespace tut
+{
+
+struct HttpReadyqueueTestData
+{
+	// the test objects inherit from this so the member functions and variables
+	// can be referenced directly inside of the test functions.
+	std::vector<HttpOpRequest::ptr_t> makeOps(int count)
+		{
+			std::vector<HttpOpRequest::ptr_t> ops;
+			for (int i(0); i < count; ++i)
+			{
+				ops.push_back(HttpOpRequest::ptr_t(new HttpOpRequest()));
+			}
+			return ops;
+		}
+
+	// Every queued request must know its own heap slot and every
+	// other request must say it isn't queued.
+	void checkIndices(const HttpReadyQueue & rq,
+					  const std::vector<HttpOpRequest::ptr_t> & ops,
+					  const std::vector<bool> & queued)
+		{
+			const HttpReadyQueue::container_type & heap(rq.get_container());
+			for (size_t i(0); i < heap.size(); ++i)
+			{
+				ensure("Index matches heap slot", heap[i]->mPolicyReadyIndex == int(i));
+			}
+			size_t count(0);
+			for (size_t i(0); i < ops.size(); ++i)
+			{
+				ensure("Queued matches model", rq.contains(ops[i]) == queued[i]);
+				ensure("Unqueued index cleared", queued[i] || ops[i]->mPolicyReadyIndex == -1);
+				count += queued[i] ? 1 : 0;
+			}
+			ensure("Size matches model", rq.size() == count);
+		}
+};
+
+typedef test_group<HttpReadyqueueTestData> HttpReadyqueueTestGroupType;
+typedef HttpReadyqueueTestGroupType::object HttpReadyqueueTestObjectType;
+HttpReadyqueueTestGroupType HttpReadyqueueTestGroup("HttpReadyqueue Tests");
+
+template <> template <>
+void HttpReadyqueueTestObjectType::test<1>()
+{
+	set_test_name("HttpReadyQueue orders by priority then arrival");
+
+	std::vector<HttpOpRequest::ptr_t> ops(makeOps(6));
+	const HttpRequest::priority_t priorities[] = { 5, 10, 5, 1, 10, 5 };
+	const int expected[] = { 1, 4, 0, 2, 5, 3 };
+
+	HttpReadyQueue rq;
+	for (int i(0); i < 6; ++i)
+	{
+		ops[i]->mReqPriority = priorities[i];
+		rq.push(ops[i]);
+	}
+	ensure("Six queued", rq.size() == 6);
+
+	for (int i(0); i < 6; ++i)
+	{
+		ensure("Issued in order", rq.top() == ops[expected[i]]);
+		rq.pop();
+		ensure("Popped request not queued", ops[expected[i]]->mPolicyReadyIndex == -1);
+	}
+	ensure("Queue drained", rq.empty());
+}
+
+template <> template <>
+void HttpReadyqueueTestObjectType::test<2>()
+{
+	set_test_name("HttpReadyQueue reprioritize and remove");
+
+	std::vector<HttpOpRequest::ptr_t> ops(makeOps(4));
+	HttpReadyQueue rq;
+	for (int i(0); i < 4; ++i)
+	{
+		ops[i]->mReqPriority = 10 * (i + 1);
+		rq.push(ops[i]);
+	}
+	ensure("Highest first", rq.top() == ops[3]);
+
+	ensure("Reprioritize queued", rq.reprioritize(ops[0], 100));
+	ensure("Raised to top", rq.top() == ops[0]);
+	ensure("Priority stored", ops[0]->mReqPriority == 100);
+
+	ensure("Remove queued", rq.remove(ops[3]));
+	ensure("Removed not queued", ! rq.contains(ops[3]));
+	ensure("Remove twice fails", ! rq.remove(ops[3]));
+	ensure("Reprioritize unqueued fails", ! rq.reprioritize(ops[3], 1));
+
+	const int expected[] = { 0, 2, 1 };
+	for (int i(0); i < 3; ++i)
+	{
+		ensure("Remaining order", rq.top() == ops[expected[i]]);
+		rq.pop();
+	}
+	ensure("Queue drained", rq.empty());
+}
+
+template <> template <>
+void HttpReadyqueueTestObjectType::test<3>()
+{
+	set_test_name("HttpReadyQueue churn");
+
+	// Texture fetch style load:  a few thousand queued requests
+	// reprioritized, cancelled and requeued as the camera moves
+	// while the top is drained.  A plain list of what should be
+	// queued is kept alongside and the heap must agree with it.
+	const int QUEUED = 4000;
+	const int ROUNDS = 20000;
+	std::vector<HttpOpRequest::ptr_t> ops(makeOps(QUEUED));
+	std::vector<bool> queued(QUEUED, false);
+
+	HttpReadyQueue rq;
+	for (int i(0); i < QUEUED; ++i)
+	{
+		ops[i]->mReqPriority = (i * 7919) % 1000;
+		rq.push(ops[i]);
+		queued[i] = true;
+	}
+
+	U32 seed(1);
+	for (int i(0); i < ROUNDS; ++i)
+	{
+		seed = seed * 1103515245U + 12345U;
+		const int which((seed >> 8) % QUEUED);
+		const HttpOpRequest::ptr_t & op(ops[which]);
+		if (0 == i % 7)
+		{
+			ensure("Remove matches model", rq.remove(op) == queued[which]);
+			queued[which] = false;
+		}
+		else if (rq.reprioritize(op, (seed >> 4) % 1000))
+		{
+			ensure("Reprioritized a queued request", queued[which]);
+		}
+		else
+		{
+			ensure("Reprioritize failed on an unqueued request", ! queued[which]);
+			op->mReqPriority = (seed >> 4) % 1000;
+			rq.push(op);
+			queued[which] = true;
+		}
+		if (0 == i % 4)
+		{
+			const HttpOpRequest::ptr_t top(rq.top());
+			rq.pop();
+			const int popped(std::find(ops.begin(), ops.end(), top) - ops.begin());
+			ensure("Popped a queued request", queued[popped]);
+			queued[popped] = false;
+			ensure("Top is highest", rq.empty() || ! HttpOpRequestCompare()(top, rq.top()));
+		}
+		if (0 == i % 1000)
+		{
+			checkIndices(rq, ops, queued);
+		}
+	}
+	checkIndices(rq, ops, queued);
+
+	// Draining must give the queued requests in comparator order.
+	std::vector<HttpOpRequest::ptr_t> expected;
+	for (int i(0); i < QUEUED; ++i)
+	{
+		if (queued[i])
+		{
+			expected.push_back(ops[i]);
+		}
+	}
+	std::sort(expected.begin(), expected.end(), HttpOpRequestCompare());
+	while (! expected.empty())
+	{
+		ensure("Drained in priority order", rq.top() == expected.back());
+		rq.pop();
+		ensure("Popped request not queued", expected.back()->mPolicyReadyIndex == -1);
+		expected.pop_back();
+	}
+	ensure("Queue drained", rq.empty());
+}
+
+}  // end namespace tut
+
+
+#endif  // TEST_LLCORE_HTTP_READYQUEUE_H_
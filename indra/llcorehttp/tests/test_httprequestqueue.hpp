@@ -182,6 +182,46 @@ void HttpRequestqueueTestObjectType::test<4>()
 	ensure("All memory returned", mMemTotal == GetMemTotal());
 }
 
+template <> template <>
+void HttpRequestqueueTestObjectType::test<5>()
+{
+	set_test_name("HttpRequestQueue wake socket");
+
+	HttpRequestQueue::init();
+
+	HttpRequestQueue * rq = HttpRequestQueue::instanceOf();
+	rq->openWakeSocket();
+	curl_socket_t wake(rq->getWakeSocket());
+	ensure("Wake socket created", CURL_SOCKET_BAD != wake);
+
+	struct timeval timeout = { 0, 0 };
+	fd_set read_fds;
+	FD_ZERO(&read_fds);
+	FD_SET(wake, &read_fds);
+	ensure("Quiet before any request", 0 == select(int(wake) + 1, &read_fds, NULL, NULL, &timeout));
+
+	HttpOperation::ptr_t op (new HttpOpNull());
+	rq->addOp(op);		// transfer my refcount
+	op.reset();
+
+	timeout.tv_sec = 1;
+	FD_ZERO(&read_fds);
+	FD_SET(wake, &read_fds);
+	ensure("Readable after addOp", 1 == select(int(wake) + 1, &read_fds, NULL, NULL, &timeout));
+
+	rq->drainWakeSocket();
+	timeout.tv_sec = 0;
+	FD_ZERO(&read_fds);
+	FD_SET(wake, &read_fds);
+	ensure("Quiet after drain", 0 == select(int(wake) + 1, &read_fds, NULL, NULL, &timeout));
+
+	op = rq->fetchOp(false);
+	ensure("Request still queued", bool(op));
+	op.reset();
+
+	HttpRequestQueue::term();
+}
+
 }  // end namespace tut
 
 
@@ -32,8 +32,9 @@
 //----------------------------------------------------------------------------
 
 // MAIN THREAD
-LLImageDecodeThread::LLImageDecodeThread(bool threaded)
-	: LLQueuedThread("imagedecode", threaded)
+// Decode requests only touch their own images, so they can be spread over num_threads threads.
+LLImageDecodeThread::LLImageDecodeThread(bool threaded, S32 num_threads)
+	: LLQueuedThread("imagedecode", threaded, false, num_threads)
 {
 	mCreationMutex = new LLMutex(getAPRPool());
 }
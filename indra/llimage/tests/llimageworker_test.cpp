@@ -244,6 +244,42 @@ namespace tut
 		ensure("LLImageDecodeThread: threaded work unit not processed", done == true);
 	}
 
+	template<> template<>
+	void imagedecodethread_object_t::test<3>()
+	{
+		// Test a *threaded* instance of the class running on several threads
+		const S32 NUM_THREADS = 4;
+		const S32 NUM_REQUESTS = 16;
+		mThread = new LLImageDecodeThread(true, NUM_THREADS);
+		ensure("LLImageDecodeThread: multi threaded constructor failed", mThread != NULL);
+		ensure_equals("LLImageDecodeThread: multi threaded thread count incorrect", mThread->getNumThreads(), NUM_THREADS);
+		bool done[NUM_REQUESTS];
+		for (S32 i = 0; i < NUM_REQUESTS; i++)
+		{
+			done[i] = false;
+			LLImageDecodeThread::handle_t decodeHandle = mThread->decodeImage(NULL, LLQueuedThread::PRIORITY_NORMAL, 0, FALSE, new responder_test(&done[i]));
+			ensure("LLImageDecodeThread: multi threaded decodeImage(), returned handle is null", decodeHandle != 0);
+		}
+		// Ask the thread to update: creates the work requests and wakes up all the threads
+		mThread->update(1);
+		const U32 INCREMENT_TIME = 500;				// 500 milliseconds
+		const U32 MAX_TIME = 20 * INCREMENT_TIME;	// Do the loop 20 times max, i.e. wait 10 seconds but no more
+		U32 total_time = 0;
+		S32 done_count = 0;
+		while ((done_count < NUM_REQUESTS) && (total_time < MAX_TIME))
+		{
+			ms_sleep(INCREMENT_TIME);
+			total_time += INCREMENT_TIME;
+			done_count = 0;
+			for (S32 i = 0; i < NUM_REQUESTS; i++)
+			{
+				done_count += done[i] ? 1 : 0;
+			}
+		}
+		// Verifies that every responder has been called exactly once
+		ensure_equals("LLImageDecodeThread: multi threaded work units not processed", done_count, NUM_REQUESTS);
+	}
+
 	// ---------------------------------------------------------------------------------------
 	// Test the LLImageDecodeThread::ImageRequest interface
 	// ---------------------------------------------------------------------------------------
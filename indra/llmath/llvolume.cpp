@@ -2727,6 +2727,12 @@ void LLVolume::copyVolumeFaces(const LLVolume* volume)
 	mSculptLevel = 0;
 }
 
+void LLVolume::swapVolumeFaces(LLVolume* volume)
+{
+	mVolumeFaces.swap(volume->mVolumeFaces);
+	mSculptLevel = 0;
+}
+
 bool LLVolume::cacheOptimize()
 {
 	for (S32 i = 0; i < mVolumeFaces.size(); ++i)
@@ -139,6 +139,11 @@ public:
 	const LLMatrix4&    getWorldMatrix() const      { return mWorldMatrix; }
 	void setWorldMatrix (const LLMatrix4& mat)   { mWorldMatrix = mat; }
 
+	// For callers composing the world transform themselves, setting all
+	// three leaves the same state as updateMatrix(FALSE).
+	LLMatrix4&			getWorldMatrixRw()			{ return mWorldMatrix; }
+	void setWorldPositionRotation(const LLVector3& pos, const LLQuaternion& rot) { mWorldPosition = pos; mWorldRotation = rot; }
+
 	void init()
 	{
 		mWorldMatrix.setIdentity();
@@ -29,6 +29,7 @@
 #include "llavatarnamecache.h"
 
 #include "llcachename.h"		// we wrap this system
+#include "llfile.h"
 #include "llframetimer.h"
 #include "llsd.h"
 #include "llsdserialize.h"
@@ -49,6 +50,10 @@
 #include <map>
 #include <set>
 
+#if !LL_WINDOWS
+#include <netinet/in.h> // htonl & ntohl
+#endif
+
 namespace LLAvatarNameCache
 {
 	use_display_name_signal_t mUseDisplayNamesSignal;
@@ -91,6 +96,68 @@ namespace LLAvatarNameCache
 	// Only need per-frame timing resolution.
 	LLFrameTimer sRequestTimer;
 
+	// URL format is like:
+	// http://pdp60.lindenlab.com:8000/agents/?ids=3941037e-78ab-45f0-b421-bd6e77c1804d&ids=0012809d-7d2d-4c24-9609-af1230a37715&ids=0019aaba-24af-4f0a-aa72-6457953cf7f0
+	//
+	// Apache can handle URLs of 4096 chars, but let's be conservative
+	const U32 NAME_URL_MAX = 4096;
+	const U32 NAME_URL_SEND_THRESHOLD = 3500;
+	// "&ids=" and a UUID
+	const U32 NAME_URL_ID_LENGTH = 5 + UUID_STR_LENGTH - 1;
+
+	// People API requests in flight, and their smoothed round trip time.
+	// A slow service gets fewer requests at once and names wait longer
+	// to be batched, so they go out in fuller batches.
+	S32 sRequestsInFlight = 0;
+	F64 sRequestLatency = 0.0;
+	const S32 MAX_REQUESTS_IN_FLIGHT = 4;
+	const F64 SLOW_REQUEST_SECS = 1.0;
+	const F32 MIN_BATCH_DELAY = 0.1f;
+	const F32 MAX_BATCH_DELAY = 1.0f;
+
+	// Binary cache file, empty until loadCacheFile().
+	// The file starts with CACHE_FILE_MAGIC, followed by one record per
+	// name: U32 LLSD size (network order), agent UUID, F64 expiration
+	// (host order, the file never leaves this machine), then the name
+	// as a binary LLSD array of CACHE_NAME_FIELDS. Later records for an
+	// agent replace earlier ones.
+	std::string sCacheFilename;
+	const char CACHE_FILE_MAGIC[] = "ANC\n0001";
+	const U32 CACHE_FILE_MAGIC_LENGTH = sizeof(CACHE_FILE_MAGIC) - 1;
+	const U32 CACHE_RECORD_HEADER_LENGTH = sizeof(U32) + UUID_BYTES + sizeof(F64);
+	// LLAvatarName::asLLSD() keys, stored by position to keep records small.
+	const char* const CACHE_NAME_FIELDS[] =
+	{
+		"username",
+		"display_name",
+		"legacy_first_name",
+		"legacy_last_name",
+		"is_display_name_default",
+		"display_name_expires",
+		"display_name_next_update"
+	};
+	const S32 CACHE_NAME_FIELD_COUNT = LL_ARRAY_SIZE(CACHE_NAME_FIELDS);
+
+	// Records read from the cache file that have not been looked up yet.
+	struct stored_name_t
+	{
+		U32 mOffset;	// of the LLSD in sStoredData
+		U32 mSize;
+		F64 mExpires;
+	};
+	typedef std::map<LLUUID, stored_name_t> stored_index_t;
+	stored_index_t sStoredIndex;
+	std::vector<U8> sStoredData;
+
+	// Names changed since they were last written to the cache file.
+	std::set<LLUUID> sDirtyNames;
+	// Records in the cache file, superseded ones included.
+	U32 sFileRecords = 0;
+	// Missing, unreadable or torn at the end, write it from scratch.
+	bool sFileNeedsRewrite = true;
+	LLFrameTimer sFlushTimer;
+	const F32 CACHE_FLUSH_INTERVAL = 60.f;
+
     // Maximum time an unrefreshed cache entry is allowed.
     const F64 MAX_UNREFRESHED_TIME = 20.0 * 60.0;
 
@@ -115,6 +182,22 @@ namespace LLAvatarNameCache
 					 const LLAvatarName& av_name);
 
 	void requestNamesViaCapability();
+	void sendNameBatch();
+	S32 maxRequestsInFlight();
+	F32 batchDelay();
+	void requestFinished(F64 latency);
+
+	// Holds one of the sRequestsInFlight slots for as long as a name
+	// request coroutine runs, however it leaves.
+	class RequestSlot
+	{
+	public:
+		RequestSlot() : mLatency(0.0) { ++sRequestsInFlight; }
+		~RequestSlot() { requestFinished(mLatency); }
+		void setLatency(F64 latency) { mLatency = latency; }
+	private:
+		F64 mLatency;
+	};
 
 	// Legacy name system callbacks
 	void legacyNameCallback(const LLUUID& agent_id,
@@ -137,6 +220,15 @@ namespace LLAvatarNameCache
 	// Erase expired names from cache
 	void eraseUnrefreshed();
 
+	// sCache lookup that decodes the name from the cache file if needed.
+	cache_t::iterator findName(const LLUUID& agent_id);
+	void decodeStoredNames();
+
+	bool writeRecord(LLFILE* fp, const LLUUID& agent_id, F64 expires, const U8* data, U32 size);
+	bool writeName(LLFILE* fp, const LLUUID& agent_id, const LLAvatarName& av_name);
+	void appendDirtyNames();
+	void rewriteCacheFile();
+
     bool expirationFromCacheControl(const LLSD& headers, F64 *expires);
 
     // This is a coroutine.
@@ -192,6 +284,10 @@ void LLAvatarNameCache::requestAvatarNameCache_(std::string url, std::vector<LLU
     LL_DEBUGS("AvNameCache") << "Entering coroutine " << LLCoros::instance().getName()
         << " with url '" << url << "', requesting " << agentIds.size() << " Agent Ids" << LL_ENDL;
 
+    // LLCoros::launch() runs us up to the first suspend, so sendNameBatch()
+    // sees the slot taken before it decides whether to send another batch.
+    LLAvatarNameCache::RequestSlot slot;
+
     // Check pointer that can be cleaned up by cleanupClass()
     if (!sHttpRequest || !sHttpOptions || !sHttpHeaders)
     {
@@ -206,7 +302,9 @@ void LLAvatarNameCache::requestAvatarNameCache_(std::string url, std::vector<LLU
         bool success = true;
 
         LLCoreHttpUtil::HttpCoroutineAdapter httpAdapter("NameCache", LLAvatarNameCache::sHttpPolicy);
+        F64 start = LLFrameTimer::getTotalSeconds();
         LLSD results = httpAdapter.getAndSuspend(sHttpRequest, url);
+        slot.setLatency(LLFrameTimer::getTotalSeconds() - start);
 
         LL_DEBUGS() << results << LL_ENDL;
 
@@ -307,7 +405,7 @@ void LLAvatarNameCache::handleAvNameCacheSuccess(const LLSD &data, const LLSD &h
 // Provide some fallback for agents that return errors
 void LLAvatarNameCache::handleAgentError(const LLUUID& agent_id)
 {
-	std::map<LLUUID,LLAvatarName>::iterator existing = sCache.find(agent_id);
+	cache_t::iterator existing = findName(agent_id);
 	if (existing == sCache.end())
     {
         // there is no existing cache entry, so make a temporary name from legacy
@@ -342,6 +440,8 @@ void LLAvatarNameCache::processName(const LLUUID& agent_id, const LLAvatarName&
 
 	// Add to the cache
 	sCache[agent_id] = av_name;
+	sStoredIndex.erase(agent_id);
+	sDirtyNames.insert(agent_id);
 
 	// Suppress request from the queue
 	sPendingQueue.erase(agent_id);
@@ -362,14 +462,22 @@ void LLAvatarNameCache::processName(const LLUUID& agent_id, const LLAvatarName&
 
 void LLAvatarNameCache::requestNamesViaCapability()
 {
-	F64 now = LLFrameTimer::getTotalSeconds();
+	// A batch too small to fill a URL waits for the request timer so more
+	// names can join it. Full ones go out as soon as a request is free.
+	while (!sAskQueue.empty() && (sRequestsInFlight < maxRequestsInFlight()))
+	{
+		bool full = sNameLookupURL.size() + sAskQueue.size() * NAME_URL_ID_LENGTH > NAME_URL_SEND_THRESHOLD;
+		if (!full && !sRequestTimer.hasExpired())
+		{
+			break;
+		}
+		sendNameBatch();
+	}
+}
 
-	// URL format is like:
-	// http://pdp60.lindenlab.com:8000/agents/?ids=3941037e-78ab-45f0-b421-bd6e77c1804d&ids=0012809d-7d2d-4c24-9609-af1230a37715&ids=0019aaba-24af-4f0a-aa72-6457953cf7f0
-	//
-	// Apache can handle URLs of 4096 chars, but let's be conservative
-	static const U32 NAME_URL_MAX = 4096;
-	static const U32 NAME_URL_SEND_THRESHOLD = 3500;
+void LLAvatarNameCache::sendNameBatch()
+{
+	F64 now = LLFrameTimer::getTotalSeconds();
 
 	std::string url;
 	url.reserve(NAME_URL_MAX);
@@ -422,6 +530,36 @@ void LLAvatarNameCache::requestNamesViaCapability()
 	}
 }
 
+S32 LLAvatarNameCache::maxRequestsInFlight()
+{
+	if (sRequestLatency < SLOW_REQUEST_SECS)
+	{
+		return MAX_REQUESTS_IN_FLIGHT;
+	}
+	if (sRequestLatency < 3.0 * SLOW_REQUEST_SECS)
+	{
+		return MAX_REQUESTS_IN_FLIGHT / 2;
+	}
+	return 1;
+}
+
+F32 LLAvatarNameCache::batchDelay()
+{
+	// Waiting a quarter of a round trip for more names costs little
+	// next to the round trip itself.
+	return llclamp((F32)sRequestLatency * 0.25f, MIN_BATCH_DELAY, MAX_BATCH_DELAY);
+}
+
+void LLAvatarNameCache::requestFinished(F64 latency)
+{
+	sRequestsInFlight = llmax(sRequestsInFlight - 1, 0);
+	if (latency > 0.0)
+	{
+		// Smooth over a few requests so one slow reply does not throttle the rest.
+		sRequestLatency = (sRequestLatency > 0.0) ? sRequestLatency * 0.75 + latency * 0.25 : latency;
+	}
+}
+
 void LLAvatarNameCache::legacyNameCallback(const LLUUID& agent_id,
 										   const std::string& full_name,
 										   bool is_group)
@@ -432,7 +570,7 @@ void LLAvatarNameCache::legacyNameCallback(const LLUUID& agent_id,
 	// Retrieve the name and set it to never (or almost never...) expire: when we are using the legacy
 	// protocol, we do not get an expiration date for each name and there's no reason to ask the 
 	// data again and again so we set the expiration time to the largest value admissible.
-	std::map<LLUUID,LLAvatarName>::iterator av_record = sCache.find(agent_id);
+	cache_t::iterator av_record = sCache.find(agent_id);
 	LLAvatarName& av_name = av_record->second;
 	av_name.setExpires(MAX_UNREFRESHED_TIME);
 }
@@ -495,6 +633,11 @@ void LLAvatarNameCache::cleanupClass()
     sHttpHeaders.reset();
     sHttpOptions.reset();
     sCache.clear();
+	sStoredIndex.clear();
+	sStoredData.clear();
+	sDirtyNames.clear();
+	sAskQueue.clear();
+	sPendingQueue.clear();
 }
 
 bool LLAvatarNameCache::importFile(std::istream& istr)
@@ -529,6 +672,7 @@ bool LLAvatarNameCache::importFile(std::istream& istr)
 
 void LLAvatarNameCache::exportFile(std::ostream& ostr)
 {
+	decodeStoredNames();
 	LLSD agents;
 	F64 max_unrefreshed = LLFrameTimer::getTotalSeconds() - MAX_UNREFRESHED_TIME;
     LL_INFOS("AvNameCache") << "LLAvatarNameCache at exit cache has " << sCache.size() << LL_ENDL;
@@ -550,6 +694,280 @@ void LLAvatarNameCache::exportFile(std::ostream& ostr)
 	LLSDSerialize::toPrettyXML(data, ostr);
 }
 
+bool LLAvatarNameCache::loadCacheFile(const std::string& filename)
+{
+	sCacheFilename = filename;
+	sStoredIndex.clear();
+	sStoredData.clear();
+	sFileRecords = 0;
+	sFileNeedsRewrite = true;
+
+	LLFILE* fp = LLFile::fopen(filename, "rb");
+	if (!fp)
+	{
+		return false;
+	}
+	fseek(fp, 0, SEEK_END);
+	long size = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	bool read = (size >= (long)CACHE_FILE_MAGIC_LENGTH);
+	if (read)
+	{
+		sStoredData.resize(size);
+		read = (fread(&sStoredData[0], size, 1, fp) == 1);
+	}
+	LLFile::close(fp);
+	if (!read || memcmp(&sStoredData[0], CACHE_FILE_MAGIC, CACHE_FILE_MAGIC_LENGTH))
+	{
+		LL_WARNS("AvNameCache") << "ignoring invalid '" << filename << "'" << LL_ENDL;
+		sStoredData.clear();
+		return false;
+	}
+
+	// Index the records, the names are decoded when they are looked up.
+	U32 offset = CACHE_FILE_MAGIC_LENGTH;
+	while ((U32)size - offset >= CACHE_RECORD_HEADER_LENGTH)
+	{
+		const U8* record = &sStoredData[offset];
+		U32 llsd_size_nbo = 0;
+		memcpy(&llsd_size_nbo, record, sizeof(U32));
+		U32 llsd_size = ntohl(llsd_size_nbo);
+		if (llsd_size > (U32)size - offset - CACHE_RECORD_HEADER_LENGTH)
+		{
+			break;
+		}
+
+		LLUUID agent_id;
+		memcpy(agent_id.mData, record + sizeof(U32), UUID_BYTES);
+		stored_name_t stored;
+		memcpy(&stored.mExpires, record + sizeof(U32) + UUID_BYTES, sizeof(F64));
+		stored.mOffset = offset + CACHE_RECORD_HEADER_LENGTH;
+		stored.mSize = llsd_size;
+		sStoredIndex[agent_id] = stored;
+
+		offset = stored.mOffset + llsd_size;
+		++sFileRecords;
+	}
+	// Anything left over is a record cut short while it was appended.
+	sFileNeedsRewrite = (offset != (U32)size);
+
+	F64 max_unrefreshed = LLFrameTimer::getTotalSeconds() - MAX_UNREFRESHED_TIME;
+	for (stored_index_t::iterator it = sStoredIndex.begin(); it != sStoredIndex.end();)
+	{
+		if (it->second.mExpires < max_unrefreshed)
+		{
+			sStoredIndex.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+	if (sStoredIndex.empty())
+	{
+		std::vector<U8>().swap(sStoredData);
+	}
+
+	LL_INFOS("AvNameCache") << "LLAvatarNameCache indexed " << sStoredIndex.size()
+							<< " names from " << sFileRecords << " records" << LL_ENDL;
+	return true;
+}
+
+void LLAvatarNameCache::saveCacheFile()
+{
+	if (sCacheFilename.empty())
+	{
+		return;
+	}
+
+	if (sFileNeedsRewrite || (sFileRecords > 2 * (sCache.size() + sStoredIndex.size())))
+	{
+		rewriteCacheFile();
+	}
+	else
+	{
+		appendDirtyNames();
+	}
+	sFlushTimer.resetWithExpiry(CACHE_FLUSH_INTERVAL);
+}
+
+bool LLAvatarNameCache::writeRecord(LLFILE* fp, const LLUUID& agent_id, F64 expires, const U8* data, U32 size)
+{
+	U32 size_nbo = htonl(size);
+	return (fwrite(&size_nbo, sizeof(U32), 1, fp) == 1)
+		&& (fwrite(agent_id.mData, UUID_BYTES, 1, fp) == 1)
+		&& (fwrite(&expires, sizeof(F64), 1, fp) == 1)
+		&& (!size || (fwrite(data, size, 1, fp) == 1));
+}
+
+bool LLAvatarNameCache::writeName(LLFILE* fp, const LLUUID& agent_id, const LLAvatarName& av_name)
+{
+	LLSD name = av_name.asLLSD();
+	LLSD fields = LLSD::emptyArray();
+	for (S32 i = 0; i < CACHE_NAME_FIELD_COUNT; ++i)
+	{
+		fields.append(name[CACHE_NAME_FIELDS[i]]);
+	}
+	std::ostringstream ostr;
+	LLSDSerialize::toBinary(fields, ostr);
+	const std::string& llsd = ostr.str();
+	return writeRecord(fp, agent_id, av_name.mExpires, (const U8*)llsd.data(), llsd.size());
+}
+
+void LLAvatarNameCache::appendDirtyNames()
+{
+	if (sDirtyNames.empty())
+	{
+		return;
+	}
+
+	// "ab" would create a missing file, e.g. after the cache was cleared,
+	// and leave records with no magic in front of them.
+	LLFILE* fp = LLFile::fopen(sCacheFilename, "r+b");
+	if (!fp
+		|| fseek(fp, 0, SEEK_END)
+		|| (ftell(fp) < (long)CACHE_FILE_MAGIC_LENGTH))
+	{
+		if (fp)
+		{
+			LLFile::close(fp);
+		}
+		LL_INFOS("AvNameCache") << "'" << sCacheFilename << "' is missing, writing it again" << LL_ENDL;
+		sFileNeedsRewrite = true;
+		rewriteCacheFile();
+		return;
+	}
+
+	F64 max_unrefreshed = LLFrameTimer::getTotalSeconds() - MAX_UNREFRESHED_TIME;
+	bool written = true;
+	std::set<LLUUID>::const_iterator it = sDirtyNames.begin();
+	for ( ; written && (it != sDirtyNames.end()); ++it)
+	{
+		cache_t::const_iterator name_it = sCache.find(*it);
+		if (name_it != sCache.end())
+		{
+			// Do not write temporary or expired entries to the stored cache
+			if (!name_it->second.isValidName(max_unrefreshed))
+			{
+				continue;
+			}
+			written = writeName(fp, *it, name_it->second);
+		}
+		else
+		{
+			// Erased, supersede any earlier record with one that has
+			// long expired.
+			written = writeRecord(fp, *it, 0.0, NULL, 0);
+		}
+		++sFileRecords;
+	}
+	LLFile::close(fp);
+
+	if (!written)
+	{
+		LL_WARNS("AvNameCache") << "failed appending to '" << sCacheFilename << "'" << LL_ENDL;
+		sFileNeedsRewrite = true;
+	}
+	sDirtyNames.clear();
+}
+
+void LLAvatarNameCache::rewriteCacheFile()
+{
+	std::string temp_filename = sCacheFilename + ".tmp";
+	LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+	if (!fp)
+	{
+		LL_WARNS("AvNameCache") << "unable to write '" << temp_filename << "'" << LL_ENDL;
+		return;
+	}
+
+	F64 max_unrefreshed = LLFrameTimer::getTotalSeconds() - MAX_UNREFRESHED_TIME;
+	U32 records = 0;
+	bool written = (fwrite(CACHE_FILE_MAGIC, CACHE_FILE_MAGIC_LENGTH, 1, fp) == 1);
+	for (cache_t::const_iterator it = sCache.begin(); written && (it != sCache.end()); ++it)
+	{
+		// Do not write temporary or expired entries to the stored cache
+		if (it->second.isValidName(max_unrefreshed))
+		{
+			written = writeName(fp, it->first, it->second);
+			++records;
+		}
+	}
+	// Names never looked up this session are copied over as they are.
+	for (stored_index_t::const_iterator it = sStoredIndex.begin(); written && (it != sStoredIndex.end()); ++it)
+	{
+		const stored_name_t& stored = it->second;
+		if (stored.mExpires >= max_unrefreshed)
+		{
+			written = writeRecord(fp, it->first, stored.mExpires, &sStoredData[stored.mOffset], stored.mSize);
+			++records;
+		}
+	}
+	LLFile::close(fp);
+
+	if (written)
+	{
+		LLFile::remove(sCacheFilename, ENOENT);
+		written = (LLFile::rename(temp_filename, sCacheFilename) == 0);
+	}
+	if (!written)
+	{
+		LL_WARNS("AvNameCache") << "failed writing '" << sCacheFilename << "'" << LL_ENDL;
+		LLFile::remove(temp_filename, ENOENT);
+		return;
+	}
+
+	LL_INFOS("AvNameCache") << "LLAvatarNameCache wrote " << records << " names" << LL_ENDL;
+	sFileRecords = records;
+	sFileNeedsRewrite = false;
+	sDirtyNames.clear();
+}
+
+LLAvatarNameCache::cache_t::iterator LLAvatarNameCache::findName(const LLUUID& agent_id)
+{
+	cache_t::iterator it = sCache.find(agent_id);
+	if ((it != sCache.end()) || sStoredIndex.empty())
+	{
+		return it;
+	}
+
+	stored_index_t::iterator stored_it = sStoredIndex.find(agent_id);
+	if (stored_it == sStoredIndex.end())
+	{
+		return sCache.end();
+	}
+	const stored_name_t& stored = stored_it->second;
+	LLSD fields;
+	bool parsed = (LLSDSerialize::fromBinary(fields, &sStoredData[stored.mOffset], stored.mSize) > 0)
+		&& (fields.size() == CACHE_NAME_FIELD_COUNT);
+	sStoredIndex.erase(stored_it);
+	if (sStoredIndex.empty())
+	{
+		std::vector<U8>().swap(sStoredData);
+	}
+	if (!parsed)
+	{
+		return sCache.end();
+	}
+
+	LLSD name;
+	for (S32 i = 0; i < CACHE_NAME_FIELD_COUNT; ++i)
+	{
+		name[CACHE_NAME_FIELDS[i]] = fields[i];
+	}
+	LLAvatarName av_name;
+	av_name.fromLLSD(name);
+	return sCache.insert(std::make_pair(agent_id, av_name)).first;
+}
+
+void LLAvatarNameCache::decodeStoredNames()
+{
+	while (!sStoredIndex.empty())
+	{
+		findName(sStoredIndex.begin()->first);
+	}
+}
+
 void LLAvatarNameCache::setNameLookupURL(const std::string& name_lookup_url)
 {
 	sNameLookupURL = name_lookup_url;
@@ -570,22 +988,16 @@ void LLAvatarNameCache::idle()
 	// By convention, start running at first idle() call
 	sRunning = true;
 
-	// *TODO: Possibly re-enabled this based on People API load measurements
-	// 100 ms is the threshold for "user speed" operations, so we can
-	// stall for about that long to batch up requests.
-	const F32 SECS_BETWEEN_REQUESTS = 0.1f;
-	if (!sRequestTimer.hasExpired())
-	{
-		return;
-	}
-
+	// The request timer holds names back for batchDelay() so they can be
+	// sent together. 100 ms is the threshold for "user speed" operations,
+	// the delay only grows past that when the service is slow anyway.
 	if (!sAskQueue.empty())
 	{
         if (usePeopleAPI())
         {
             requestNamesViaCapability();
         }
-        else
+        else if (sRequestTimer.hasExpired())
         {
             LL_WARNS_ONCE("AvNameCache") << "LLAvatarNameCache still using legacy api" << LL_ENDL;
             requestNamesViaLegacy();
@@ -595,7 +1007,12 @@ void LLAvatarNameCache::idle()
 	if (sAskQueue.empty())
 	{
 		// cleared the list, reset the request timer.
-		sRequestTimer.resetWithExpiry(SECS_BETWEEN_REQUESTS);
+		sRequestTimer.resetWithExpiry(batchDelay());
+	}
+
+	if (!sDirtyNames.empty() && sFlushTimer.hasExpired())
+	{
+		saveCacheFile();
 	}
 
     // erase anything that has not been refreshed for more than MAX_UNREFRESHED_TIME
@@ -643,8 +1060,20 @@ void LLAvatarNameCache::eraseUnrefreshed()
 				++it;
 			}
         }
+        for (stored_index_t::iterator it = sStoredIndex.begin(); it != sStoredIndex.end();)
+        {
+            if (it->second.mExpires < max_unrefreshed)
+            {
+                sStoredIndex.erase(it++);
+                expired++;
+            }
+            else
+            {
+                ++it;
+            }
+        }
         LL_INFOS("AvNameCache") << "LLAvatarNameCache expired " << expired << " cached avatar names, "
-                                << sCache.size() << " remaining" << LL_ENDL;
+                                << sCache.size() + sStoredIndex.size() << " remaining" << LL_ENDL;
 	}
 }
 
@@ -655,7 +1084,7 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 	if (sRunning)
 	{
 		// ...only do immediate lookups when cache is running
-		std::map<LLUUID,LLAvatarName>::iterator it = sCache.find(agent_id);
+		cache_t::iterator it = findName(agent_id);
 		if (it != sCache.end())
 		{
 			*av_name = it->second;
@@ -700,7 +1129,7 @@ LLAvatarNameCache::callback_connection_t LLAvatarNameCache::get(const LLUUID& ag
 	if (sRunning)
 	{
 		// ...only do immediate lookups when cache is running
-		std::map<LLUUID,LLAvatarName>::iterator it = sCache.find(agent_id);
+		cache_t::iterator it = findName(agent_id);
 		if (it != sCache.end())
 		{
 			const LLAvatarName& av_name = it->second;
@@ -761,16 +1190,22 @@ void LLAvatarNameCache::setUseUsernames(bool use)
 void LLAvatarNameCache::erase(const LLUUID& agent_id)
 {
 	sCache.erase(agent_id);
+	sStoredIndex.erase(agent_id);
+	sDirtyNames.insert(agent_id);
 }
 
 void LLAvatarNameCache::insert(const LLUUID& agent_id, const LLAvatarName& av_name)
 {
 	// *TODO: update timestamp if zero?
 	sCache[agent_id] = av_name;
+	sStoredIndex.erase(agent_id);
+	sDirtyNames.insert(agent_id);
 }
 
 LLUUID LLAvatarNameCache::findIdByName(const std::string& name)
 {
+    decodeStoredNames();
+
     std::map<LLUUID, LLAvatarName>::iterator it;
     std::map<LLUUID, LLAvatarName>::iterator end = sCache.end();
     for (it = sCache.begin(); it != end; ++it)
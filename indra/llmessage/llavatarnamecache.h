@@ -48,6 +48,13 @@ namespace LLAvatarNameCache
 	bool importFile(std::istream& istr);
 	void exportFile(std::ostream& ostr);
 
+	// Binary cache file. Loading only indexes the records, a name is
+	// decoded the first time it is looked up. Names are appended as they
+	// change, idle() and saveCacheFile() write them out, and the file is
+	// rewritten once it is mostly superseded records.
+	bool loadCacheFile(const std::string& filename);
+	void saveCacheFile();
+
 	// On the viewer, usually a simulator capabilities.
 	// If empty, name cache will fall back to using legacy name lookup system.
 	void setNameLookupURL(const std::string& name_lookup_url);
@@ -64,6 +64,11 @@ const F32Seconds TARGET_PERIOD_LENGTH(5.f);
 const F32Seconds LL_DUPLICATE_SUPPRESSION_TIMEOUT(60.f); //this can be long, as time-based cleanup is
 													// only done when wrapping packetids, now...
 
+// Reliable timeouts are a second or more, so one revolution of the
+// resend wheel covers nearly all of them.
+const F64Seconds RESEND_WHEEL_TICK(0.05);
+const U32 RESEND_WHEEL_SLOTS = 256;
+
 LLCircuitData::LLCircuitData(const LLHost &host, TPACKETID in_id, 
 							 const F32Seconds circuit_heartbeat_interval, const F32Seconds circuit_timeout)
 :	mHost (host),
@@ -87,6 +92,7 @@ LLCircuitData::LLCircuitData(const LLHost &host, TPACKETID in_id,
 	mPingDelayAveraged(INITIAL_PING_VALUE_MSEC), 
 	mUnackedPacketCount(0),
 	mUnackedPacketBytes(0),
+	mResendWheel(RESEND_WHEEL_TICK, RESEND_WHEEL_SLOTS),
 	mLastPacketInTime(0.0),
 	mLocalEndPointID(),
 	mPacketsOut(0),
@@ -225,6 +231,11 @@ void LLCircuitData::ackReliablePacket(TPACKETID packet_num)
 		// Cleanup
 		delete packetp;
 		mUnackedPackets.erase(iter);
+		if (!mUnackedPacketCount)
+		{
+			mResendWheel.clear();
+			mExpiredPackets.clear();
+		}
 		return;
 	}
 
@@ -265,6 +276,13 @@ void LLCircuitData::ackReliablePacket(TPACKETID packet_num)
 		// Couldn't find this packet on either of the unacked lists.
 		// maybe it's a duplicate ack?
 	}
+
+	if (!mUnackedPacketCount)
+	{
+		// Everything left to expire has been acked.
+		mResendWheel.clear();
+		mExpiredPackets.clear();
+	}
 }
 
 
@@ -274,6 +292,16 @@ S32 LLCircuitData::resendUnackedPackets(const F64Seconds now)
 	S32 resent_packets = 0;
 	LLReliablePacket *packetp;
 
+	// Only expired packets need looking at.  Go through them in packet ID
+	// order as the whole list walk used to, anything the resend throttle
+	// holds back stays expired for the next call.
+	mResendWheel.collectDue(now, mExpiredPackets);
+	if (mExpiredPackets.empty())
+	{
+		return mUnackedPacketCount;
+	}
+	std::sort(mExpiredPackets.begin(), mExpiredPackets.end());
+	mExpiredPackets.erase(std::unique(mExpiredPackets.begin(), mExpiredPackets.end()), mExpiredPackets.end());
 
 	//
 	// Theoretically we should search through the list for the packet with the oldest
@@ -284,10 +312,26 @@ S32 LLCircuitData::resendUnackedPackets(const F64Seconds now)
 
 	reliable_iter iter;
 	BOOL have_resend_overflow = FALSE;
-	for (iter = mUnackedPackets.begin(); iter != mUnackedPackets.end();)
+	BOOL stop_resending = FALSE;
+	std::vector<TPACKETID> held;
+	std::vector<TPACKETID> failed;
+	for (std::vector<TPACKETID>::iterator id_it = mExpiredPackets.begin(); id_it != mExpiredPackets.end(); ++id_it)
 	{
+		iter = mUnackedPackets.find(*id_it);
+		if (iter == mUnackedPackets.end())
+		{
+			// Acked or on the final list.
+			failed.push_back(*id_it);
+			continue;
+		}
 		packetp = iter->second;
 
+		if (stop_resending)
+		{
+			held.push_back(*id_it);
+			continue;
+		}
+
 		// Only check overflow if we haven't had one yet.
 		if (!have_resend_overflow)
 		{
@@ -302,18 +346,12 @@ S32 LLCircuitData::resendUnackedPackets(const F64Seconds now)
 			// If we have too many unacked packets, we need to start dropping expired ones.
 			if (mUnackedPacketBytes > 512000)
 			{
-				if (now > packetp->mExpirationTime)
-				{
-					// This circuit has overflowed.  Do not retry.  Do not pass go.
-					packetp->mRetries = 0;
-					// Remove it from this list and add it to the final list.
-					mUnackedPackets.erase(iter++);
-					mFinalRetryPackets[packetp->mPacketID] = packetp;
-				}
-				else
-				{
-					++iter;
-				}
+				// This circuit has overflowed.  Do not retry.  Do not pass go.
+				packetp->mRetries = 0;
+				// Remove it from this list and add it to the final list.
+				mUnackedPackets.erase(iter);
+				mFinalRetryPackets[packetp->mPacketID] = packetp;
+				failed.push_back(packetp->mPacketID);
 				// Move on to the next unacked packet.
 				continue;
 			}
@@ -325,68 +363,65 @@ S32 LLCircuitData::resendUnackedPackets(const F64Seconds now)
 						<< " bytes of reliable messages waiting" << LL_ENDL;
 			}
 			// Stop resending.  There are less than 512000 unacked packets.
-			break;
+			stop_resending = TRUE;
+			held.push_back(*id_it);
+			continue;
 		}
 
-		if (now > packetp->mExpirationTime)
-		{
-			packetp->mRetries--;
-			
-			// retry		
-			mCurrentResendCount++;
-
-			gMessageSystem->mResentPackets++;
+		packetp->mRetries--;
+		
+		// retry		
+		mCurrentResendCount++;
 
-			if(gMessageSystem->mVerboseLog)
-			{
-				std::ostringstream str;
-				str << "MSG: -> " << packetp->mHost
-					<< "\tRESENDING RELIABLE:\t" << packetp->mPacketID;
-				LL_INFOS() << str.str() << LL_ENDL;
-			}
+		gMessageSystem->mResentPackets++;
 
-			packetp->mBuffer[0] |= LL_RESENT_FLAG;  // tag packet id as being a resend	
+		if(gMessageSystem->mVerboseLog)
+		{
+			std::ostringstream str;
+			str << "MSG: -> " << packetp->mHost
+				<< "\tRESENDING RELIABLE:\t" << packetp->mPacketID;
+			LL_INFOS() << str.str() << LL_ENDL;
+		}
 
-			gMessageSystem->mPacketRing.sendPacket(packetp->mSocket, 
-											   (char *)packetp->mBuffer, packetp->mBufferLength, 
-											   packetp->mHost);
+		packetp->mBuffer[0] |= LL_RESENT_FLAG;  // tag packet id as being a resend	
 
-			mThrottles.throttleOverflow(TC_RESEND, packetp->mBufferLength * 8.f);
+		gMessageSystem->mPacketRing.sendPacket(packetp->mSocket, 
+										   (char *)packetp->mBuffer, packetp->mBufferLength, 
+										   packetp->mHost);
 
-			// The new method, retry time based on ping
-			if (packetp->mPingBasedRetry)
-			{
-				packetp->mExpirationTime = now + llmax(LL_MINIMUM_RELIABLE_TIMEOUT_SECONDS, F32Seconds(LL_RELIABLE_TIMEOUT_FACTOR * getPingDelayAveraged()));
-			}
-			else
-			{
-				// custom, constant retry time
-				packetp->mExpirationTime = now + packetp->mTimeout;
-			}
+		mThrottles.throttleOverflow(TC_RESEND, packetp->mBufferLength * 8.f);
 
-			if (!packetp->mRetries)
-			{
-				// Last resend, remove it from this list and add it to the final list.
-				mUnackedPackets.erase(iter++);
-				mFinalRetryPackets[packetp->mPacketID] = packetp;
-			}
-			else
-			{
-				// Don't remove it yet, it still gets to try to resend at least once.
-				++iter;
-			}
-			resent_packets++;
+		// The new method, retry time based on ping
+		if (packetp->mPingBasedRetry)
+		{
+			packetp->mExpirationTime = now + llmax(LL_MINIMUM_RELIABLE_TIMEOUT_SECONDS, F32Seconds(LL_RELIABLE_TIMEOUT_FACTOR * getPingDelayAveraged()));
 		}
 		else
 		{
-			// Don't need to do anything with this packet, keep iterating.
-			++iter;
+			// custom, constant retry time
+			packetp->mExpirationTime = now + packetp->mTimeout;
 		}
+		mResendWheel.schedule(packetp->mPacketID, packetp->mExpirationTime);
+
+		if (!packetp->mRetries)
+		{
+			// Last resend, remove it from this list and add it to the final list.
+			mUnackedPackets.erase(iter);
+			mFinalRetryPackets[packetp->mPacketID] = packetp;
+		}
+		resent_packets++;
 	}
+	mExpiredPackets.swap(held);
 
 
-	for (iter = mFinalRetryPackets.begin(); iter != mFinalRetryPackets.end();)
+	for (std::vector<TPACKETID>::iterator id_it = failed.begin(); id_it != failed.end(); ++id_it)
 	{
+		iter = mFinalRetryPackets.find(*id_it);
+		if (iter == mFinalRetryPackets.end())
+		{
+			// Acked
+			continue;
+		}
 		packetp = iter->second;
 		if (now > packetp->mExpirationTime)
 		{
@@ -415,12 +450,12 @@ S32 LLCircuitData::resendUnackedPackets(const F64Seconds now)
 			mUnackedPacketCount--;
 			mUnackedPacketBytes -= packetp->mBufferLength;
 
-			mFinalRetryPackets.erase(iter++);
+			mFinalRetryPackets.erase(iter);
 			delete packetp;
 		}
 		else
 		{
-			++iter;
+			// Not this one's latest expiration time, it's still on the wheel.
 		}
 	}
 
@@ -581,6 +616,7 @@ void LLCircuitData::addReliablePacket(S32 mSocket, U8 *buf_ptr, S32 buf_len, LLR
 	{
 		mFinalRetryPackets[packet_info->mPacketID] = packet_info;
 	}
+	mResendWheel.schedule(packet_info->mPacketID, packet_info->mExpirationTime);
 }
 
 
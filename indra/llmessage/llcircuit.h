@@ -39,6 +39,7 @@
 #include "llpacketack.h"
 #include "lluuid.h"
 #include "llthrottle.h"
+#include "lltimingwheel.h"
 
 //
 // Constants
@@ -246,6 +247,12 @@ protected:
 	reliable_map							mUnackedPackets;
 	reliable_map							mFinalRetryPackets;
 
+	// Expiration times of the packets in both lists above, so resends
+	// only look at packets that have expired.  Acked packets are left in
+	// and skipped when they come due.
+	LLTimingWheel<TPACKETID>				mResendWheel;
+	std::vector<TPACKETID>					mExpiredPackets;	// expired, not yet resent
+
 	S32										mUnackedPacketCount;
 	S32										mUnackedPacketBytes;
 
@@ -101,6 +101,12 @@ public:
 		temp->addData(data, size, type, data_size);
 	}
 
+	// Variables are stored in template order, see LLMessageTemplate::getVariableIndex()
+	LLMsgVarData* getVarData(S32 index)
+	{
+		return (index >= 0 && index < (S32)mMemberVarData.size()) ? &*(mMemberVarData.begin() + index) : NULL;
+	}
+
 	S32									mBlockNumber;
 	typedef LLIndexedVector<LLMsgVarData, const char *, 8> msg_var_data_map_t;
 	msg_var_data_map_t					mMemberVarData;
@@ -128,9 +134,24 @@ public:
 
 	void addDataFast(char *blockname, char *varname, const void *data, S32 size, EMsgVariableType type, S32 data_size = -1);
 
+	// Block by template block index and repeat number, NULL if there is no
+	// such block. Only filled in for received messages.
+	LLMsgBlkData* getBlock(S32 index, S32 blocknum) const
+	{
+		if (index < 0 || index >= (S32)mBlockStart.size() || blocknum < 0)
+		{
+			return NULL;
+		}
+		S32 pos = mBlockStart[index] + blocknum;
+		S32 end = (index + 1 < (S32)mBlockStart.size()) ? mBlockStart[index + 1] : (S32)mBlockList.size();
+		return pos < end ? mBlockList[pos] : NULL;
+	}
+
 public:
 	typedef std::map<char*, LLMsgBlkData*> msg_blk_data_map_t;
 	msg_blk_data_map_t					mMemberBlocks;
+	std::vector<LLMsgBlkData*>			mBlockList;		// same blocks in template order
+	std::vector<S32>					mBlockStart;	// first entry in mBlockList for each template block
 	char								*mName;
 	S32									mTotalSize;
 };
@@ -391,6 +412,26 @@ public:
 		return iter != mMemberBlocks.end()? *iter : NULL;
 	}
 
+	// Positions of a block and of a variable within that block, as used by
+	// LLMsgData::getBlock() and LLMsgBlkData::getVarData().
+	BOOL getVariableIndex(const char* blockname, const char* varname, S32& block_index, S32& var_index) const
+	{
+		message_block_map_t::const_iterator block_iter = mMemberBlocks.find((char*)blockname);
+		if (block_iter == mMemberBlocks.end())
+		{
+			return FALSE;
+		}
+		const LLMessageBlock::message_variable_map_t& vars = (*block_iter)->mMemberVariables;
+		LLMessageBlock::message_variable_map_t::const_iterator var_iter = vars.find(varname);
+		if (var_iter == vars.end())
+		{
+			return FALSE;
+		}
+		block_index = (S32)(block_iter - mMemberBlocks.begin());
+		var_index = (S32)(var_iter - vars.begin());
+		return TRUE;
+	}
+
 public:
 	typedef LLIndexedVector<LLMessageBlock*, char*, 8> message_block_map_t;
 	message_block_map_t						mMemberBlocks;
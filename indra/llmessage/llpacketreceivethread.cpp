@@ -0,0 +1,233 @@
+/**
+ * @file llpacketreceivethread.cpp
+ * @brief Reads and unpacks incoming UDP packets off the main thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llpacketreceivethread.h"
+
+#if LL_WINDOWS
+#include "llwin32headerslean.h"
+#else
+#include <sys/select.h>
+#endif
+
+#include "message.h"
+
+// Packets read per receive_packets() call.
+const S32 RECEIVE_BATCH_SIZE = 32;
+// Packets in flight between the threads. When the main thread falls this
+// far behind, further datagrams wait in the socket buffer.
+const S32 MAX_RECEIVED_PACKETS = 512;
+// How long run() blocks before checking whether it should quit.
+const S32 RECEIVE_WAIT_MS = 50;
+
+LLPacketReceiveThread::LLPacketReceiveThread(S32 socket) :
+	LLThread("Packet receive"),
+	mSocket(socket),
+	mAllocated(0),
+	mReadyQueue(NULL, MAX_RECEIVED_PACKETS),
+	mFreeQueue(NULL, MAX_RECEIVED_PACKETS)
+{
+}
+
+LLPacketReceiveThread::~LLPacketReceiveThread()
+{
+	LLReceivedPacket* packetp = NULL;
+	while (mReadyQueue.tryPopBack(packetp))
+	{
+		delete packetp;
+	}
+	while (mFreeQueue.tryPopBack(packetp))
+	{
+		delete packetp;
+	}
+}
+
+LLReceivedPacket* LLPacketReceiveThread::popPacket()
+{
+	LLReceivedPacket* packetp = NULL;
+	if (!mReadyQueue.tryPopBack(packetp))
+	{
+		return NULL;
+	}
+	return packetp;
+}
+
+void LLPacketReceiveThread::releasePacket(LLReceivedPacket* packetp)
+{
+	if (packetp && !mFreeQueue.tryPushFront(packetp))
+	{
+		delete packetp;
+	}
+}
+
+bool LLPacketReceiveThread::waitForData()
+{
+	fd_set readfds;
+	FD_ZERO(&readfds);
+	FD_SET(mSocket, &readfds);
+
+	struct timeval timeout;
+	timeout.tv_sec = 0;
+	timeout.tv_usec = RECEIVE_WAIT_MS * 1000;
+
+	return select(mSocket + 1, &readfds, NULL, NULL, &timeout) > 0;
+}
+
+LLReceivedPacket* LLPacketReceiveThread::getFreePacket()
+{
+	LLReceivedPacket* packetp = NULL;
+	if (mFreeQueue.tryPopBack(packetp))
+	{
+		return packetp;
+	}
+	if (mAllocated < MAX_RECEIVED_PACKETS)
+	{
+		++mAllocated;
+		return new LLReceivedPacket;
+	}
+	return NULL;
+}
+
+// Mirrors the front of LLMessageSystem::checkMessages(). Returns false for
+// packets that should be thrown away.
+bool LLPacketReceiveThread::unpack(LLReceivedPacket* packetp)
+{
+	packetp->mBodyp = packetp->mData;
+	packetp->mBodySize = packetp->mSize;
+	packetp->mPackedSize = 0;
+	packetp->mExpandErrors = 0;
+	packetp->mAckCount = 0;
+
+	if (packetp->mSize < (S32)LL_MINIMUM_VALID_PACKET_SIZE)
+	{
+		// Let the main thread report it.
+		return true;
+	}
+
+	U8* buffer = packetp->mData;
+	S32 receive_size = packetp->mSize;
+	if (buffer[0] & LL_ACK_FLAG)
+	{
+		S32 acks = buffer[--receive_size];
+		S32 true_rcv_size = receive_size;
+		if (receive_size < (S32)(acks * sizeof(TPACKETID) + LL_MINIMUM_VALID_PACKET_SIZE))
+		{
+			LL_WARNS("Messaging") << "Malformed packet received. Packet size "
+				<< receive_size << " with invalid no. of acks " << acks
+				<< LL_ENDL;
+			return false;
+		}
+		receive_size -= acks * sizeof(TPACKETID);
+
+		U32 mem_id = 0;
+		for (S32 i = 0; i < acks; ++i)
+		{
+			true_rcv_size -= sizeof(TPACKETID);
+			memcpy(&mem_id, &buffer[true_rcv_size], sizeof(TPACKETID));	/* Flawfinder: ignore*/
+			packetp->mAcks[i] = ntohl(mem_id);
+		}
+		packetp->mAckCount = acks;
+	}
+
+	packetp->mBodySize = receive_size;
+	if (buffer[0] & LL_ZERO_CODE_FLAG)
+	{
+		packetp->mPackedSize = receive_size;
+		packetp->mBodySize = LLMessageSystem::zeroCodeExpand(buffer, receive_size, packetp->mExpanded,
+															 packetp->mExpandErrors);
+		packetp->mBodyp = packetp->mExpanded;
+	}
+	return true;
+}
+
+void LLPacketReceiveThread::run()
+{
+	LLNetPacket batch[RECEIVE_BATCH_SIZE];
+	LLReceivedPacket* packets[RECEIVE_BATCH_SIZE];
+	memset(packets, 0, sizeof(packets));
+
+	while (!isQuitting())
+	{
+		if (!waitForData())
+		{
+			continue;
+		}
+
+		S32 count = 0;
+		while (count < RECEIVE_BATCH_SIZE)
+		{
+			if (!packets[count])
+			{
+				packets[count] = getFreePacket();
+				if (!packets[count])
+				{
+					break;
+				}
+			}
+			batch[count].mData = (char*)packets[count]->mData;
+			++count;
+		}
+		if (!count)
+		{
+			// The main thread is not keeping up, leave the data in the socket.
+			ms_sleep(1);
+			continue;
+		}
+
+		S32 received = receive_packets(mSocket, batch, count);
+		for (S32 i = 0; i < received; ++i)
+		{
+			LLReceivedPacket* packetp = packets[i];
+			packetp->mSize = batch[i].mSize;
+			packetp->mSender.set(batch[i].mIP, batch[i].mPort);
+			packetp->mReceivingIF.set(batch[i].mReceivingIF, INVALID_PORT);
+			if (unpack(packetp) && mReadyQueue.tryPushFront(packetp))
+			{
+				packets[i] = NULL;
+			}
+		}
+
+		// Keep any unused packets at the front for the next batch.
+		S32 kept = 0;
+		for (S32 i = 0; i < RECEIVE_BATCH_SIZE; ++i)
+		{
+			if (packets[i])
+			{
+				packets[kept++] = packets[i];
+			}
+		}
+		for (S32 i = kept; i < RECEIVE_BATCH_SIZE; ++i)
+		{
+			packets[i] = NULL;
+		}
+	}
+
+	for (S32 i = 0; i < RECEIVE_BATCH_SIZE; ++i)
+	{
+		delete packets[i];
+	}
+}
@@ -0,0 +1,78 @@
+/**
+ * @file llpacketreceivethread.h
+ * @brief Reads and unpacks incoming UDP packets off the main thread.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLPACKETRECEIVETHREAD_H
+#define LL_LLPACKETRECEIVETHREAD_H
+
+#include "llhost.h"
+#include "llthread.h"
+#include "llthreadsafequeue.h"
+#include "net.h"
+
+// One datagram as read by LLPacketReceiveThread. Appended acks have been
+// split off and the body zero code expanded, so the main thread can go
+// straight to circuit checks and decoding.
+struct LLReceivedPacket
+{
+	U8			mData[NET_BUFFER_SIZE];		// as received
+	S32			mSize;
+	U8			mExpanded[NET_BUFFER_SIZE];	// zero code expanded body
+	U8*			mBodyp;						// mData or mExpanded
+	S32			mBodySize;
+	S32			mPackedSize;				// body size before expansion
+	S32			mExpandErrors;				// times expansion ran past the buffer
+	TPACKETID	mAcks[256];					// appended acks, last one first
+	S32			mAckCount;
+	LLHost		mSender;
+	LLHost		mReceivingIF;
+};
+
+class LLPacketReceiveThread : public LLThread
+{
+public:
+	LLPacketReceiveThread(S32 socket);
+	~LLPacketReceiveThread();
+
+	// Main thread only. Returns the next packet in arrival order, or NULL
+	// when none is waiting. Give it back with releasePacket() when done.
+	LLReceivedPacket* popPacket();
+	void releasePacket(LLReceivedPacket* packetp);
+
+protected:
+	/*virtual*/ void run();
+
+private:
+	bool waitForData();
+	LLReceivedPacket* getFreePacket();
+	bool unpack(LLReceivedPacket* packetp);
+
+	S32 mSocket;
+	S32 mAllocated;			// packets owned by this thread, touched by run() only
+	LLThreadSafeQueue<LLReceivedPacket*> mReadyQueue;
+	LLThreadSafeQueue<LLReceivedPacket*> mFreeQueue;
+};
+
+#endif // LL_LLPACKETRECEIVETHREAD_H
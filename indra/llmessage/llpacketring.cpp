@@ -55,14 +55,27 @@ LLPacketRing::LLPacketRing () :
 	mInBufferLength(0),
 	mOutBufferLength(0),
 	mDropPercentage(0.0f),
-	mPacketsToDrop(0x0)
+	mPacketsToDrop(0x0),
+	mReceiveBatchCount(0),
+	mReceiveBatchNext(0),
+	mSendBatchCount(0),
+	mSendBatchSocket(-1),
+	mSendBatchFailures(0),
+	mBatchSends(FALSE)
 {
+	mIOBuffer = new char[2 * IO_BATCH_SIZE * IO_SLOT_SIZE];
+	for (S32 i = 0; i < IO_BATCH_SIZE; ++i)
+	{
+		mReceiveBatch[i].mData = mIOBuffer + i * IO_SLOT_SIZE;
+		mSendBatch[i].mData = mIOBuffer + (IO_BATCH_SIZE + i) * IO_SLOT_SIZE;
+	}
 }
 
 ///////////////////////////////////////////////////////////
 LLPacketRing::~LLPacketRing ()
 {
 	cleanup();
+	delete[] mIOBuffer;
 }
 	
 ///////////////////////////////////////////////////////////
@@ -83,6 +96,12 @@ void LLPacketRing::cleanup ()
 		delete packetp;
 		mSendQueue.pop();
 	}
+
+	mReceiveBatchCount = 0;
+	mReceiveBatchNext = 0;
+	mSendBatchCount = 0;
+	mSendBatchFailures = 0;
+	mBatchSends = FALSE;
 }
 
 ///////////////////////////////////////////////////////////
@@ -153,6 +172,27 @@ S32 LLPacketRing::receiveFromRing (S32 socket, char *datap)
 	return packet_size;
 }
 
+///////////////////////////////////////////////////////////
+S32 LLPacketRing::receiveFromBatch (S32 socket, char *datap)
+{
+	if (mReceiveBatchNext >= mReceiveBatchCount)
+	{
+		// Drain whatever the socket has in one call.
+		mReceiveBatchCount = receive_packets(socket, mReceiveBatch, IO_BATCH_SIZE);
+		mReceiveBatchNext = 0;
+		if (!mReceiveBatchCount)
+		{
+			return 0;
+		}
+	}
+
+	const LLNetPacket& packet = mReceiveBatch[mReceiveBatchNext++];
+	memcpy(datap, packet.mData, packet.mSize);	/*Flawfinder: ignore*/
+	mLastSender.set(packet.mIP, packet.mPort);
+	mLastReceivingIF.set(packet.mReceivingIF, INVALID_PORT);
+	return packet.mSize;
+}
+
 ///////////////////////////////////////////////////////////
 S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 {
@@ -226,6 +266,10 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 		// no delay, pull straight from net
 		if (LLProxy::isSOCKSProxyEnabled())
 		{
+			// Anything batched before the proxy came up was not wrapped.
+			mReceiveBatchCount = 0;
+			mReceiveBatchNext = 0;
+
 			U8 buffer[NET_BUFFER_SIZE + SOCKS_HEADER_SIZE];
 			packet_size = receive_packet(socket, static_cast<char*>(static_cast<void*>(buffer)));
 			
@@ -243,15 +287,13 @@ S32 LLPacketRing::receivePacket (S32 socket, char *datap)
 			{
 				packet_size = 0;
 			}
+			mLastReceivingIF = ::get_receiving_interface();
 		}
 		else
 		{
-			packet_size = receive_packet(socket, datap);
-			mLastSender = ::get_sender();
+			packet_size = receiveFromBatch(socket, datap);
 		}
 
-		mLastReceivingIF = ::get_receiving_interface();
-
 		if (packet_size)  // did we actually get a packet?
 		{
 			if (mDropPercentage && (ll_frand(100.f) < mDropPercentage))
@@ -344,12 +386,58 @@ BOOL LLPacketRing::sendPacket(int h_socket, char * send_buffer, S32 buf_size, LL
 	return status;
 }
 
+void LLPacketRing::beginSendBatch()
+{
+	mBatchSends = TRUE;
+}
+
+S32 LLPacketRing::flushSendBatch()
+{
+	sendBatch();
+	mBatchSends = FALSE;
+
+	S32 failures = mSendBatchFailures;
+	mSendBatchFailures = 0;
+	return failures;
+}
+
+void LLPacketRing::sendBatch()
+{
+	if (mSendBatchCount)
+	{
+		S32 sent = send_packets(mSendBatchSocket, mSendBatch, mSendBatchCount);
+		mSendBatchFailures += mSendBatchCount - sent;
+		mSendBatchCount = 0;
+	}
+}
+
+BOOL LLPacketRing::sendDatagram(int h_socket, const char * send_buffer, S32 buf_size, U32 ip, U32 port)
+{
+	if (!mBatchSends || buf_size > IO_SLOT_SIZE)
+	{
+		return send_packet(h_socket, send_buffer, buf_size, ip, port);
+	}
+
+	if (mSendBatchCount == IO_BATCH_SIZE || (mSendBatchCount && h_socket != mSendBatchSocket))
+	{
+		sendBatch();
+	}
+
+	LLNetPacket& packet = mSendBatch[mSendBatchCount++];
+	memcpy(packet.mData, send_buffer, buf_size);	/*Flawfinder: ignore*/
+	packet.mSize = buf_size;
+	packet.mIP = ip;
+	packet.mPort = port;
+	mSendBatchSocket = h_socket;
+	return TRUE;
+}
+
 BOOL LLPacketRing::sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host)
 {
 	
 	if (!LLProxy::isSOCKSProxyEnabled())
 	{
-		return send_packet(h_socket, send_buffer, buf_size, host.getAddress(), host.getPort());
+		return sendDatagram(h_socket, send_buffer, buf_size, host.getAddress(), host.getPort());
 	}
 
 	char headered_send_buffer[NET_BUFFER_SIZE + SOCKS_HEADER_SIZE];
@@ -363,7 +451,7 @@ BOOL LLPacketRing::sendPacketImpl(int h_socket, const char * send_buffer, S32 bu
 
 	memcpy(headered_send_buffer + SOCKS_HEADER_SIZE, send_buffer, buf_size);
 
-	return send_packet(	h_socket,
+	return sendDatagram(h_socket,
 						headered_send_buffer,
 						buf_size + SOCKS_HEADER_SIZE,
 						LLProxy::getInstance()->getUDPProxy().getAddress(),
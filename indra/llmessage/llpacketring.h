@@ -55,6 +55,12 @@ public:
 
 	BOOL sendPacket(int h_socket, char * send_buffer, S32 buf_size, LLHost host);
 
+	// Between these calls outgoing packets are copied aside and written
+	// with as few system calls as possible, sendPacket() reports success
+	// for them. flushSendBatch() returns the number that failed to send.
+	void beginSendBatch();
+	S32  flushSendBatch();
+
 	inline LLHost getLastSender();
 	inline LLHost getLastReceivingInterface();
 
@@ -85,6 +91,21 @@ protected:
 
 private:
 	BOOL sendPacketImpl(int h_socket, const char * send_buffer, S32 buf_size, LLHost host);
+	BOOL sendDatagram(int h_socket, const char * send_buffer, S32 buf_size, U32 ip, U32 port);
+	S32  receiveFromBatch(S32 socket, char *datap);
+	void sendBatch();
+
+	// Preallocated slots for batched socket I/O.
+	enum { IO_BATCH_SIZE = 32, IO_SLOT_SIZE = NET_BUFFER_SIZE + SOCKS_HEADER_SIZE };
+	char* mIOBuffer;
+	LLNetPacket mReceiveBatch[IO_BATCH_SIZE];
+	S32 mReceiveBatchCount;			// packets read by the last receive_packets()
+	S32 mReceiveBatchNext;			// next one to hand out
+	LLNetPacket mSendBatch[IO_BATCH_SIZE];
+	S32 mSendBatchCount;
+	S32 mSendBatchSocket;
+	S32 mSendBatchFailures;
+	BOOL mBatchSends;
 };
 
 
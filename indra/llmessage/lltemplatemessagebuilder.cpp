@@ -45,8 +45,19 @@ LLTemplateMessageBuilder::LLTemplateMessageBuilder(const message_template_name_m
 	mbSBuilt(FALSE),
 	mbSClear(TRUE),
 	mCurrentSendTotal(0),
-	mMessageTemplates(name_template_map)
+	mMessageTemplates(name_template_map),
+	mDirect(FALSE),
+	mDirectSize(0),
+	mDirectBlock(-1),
+	mDirectVar(0),
+	mDirectCountPos(0),
+	mEncodedSize(0),
+	mBuiltBuffer(NULL),
+	mBuiltSize(0)
 {
+	mDirectBuffer = new U8[MAX_BUFFER_SIZE];
+	// zero coding can grow the message
+	mEncodedBuffer = new U8[2 * MAX_BUFFER_SIZE];
 }
 
 //virtual
@@ -54,6 +65,8 @@ LLTemplateMessageBuilder::~LLTemplateMessageBuilder()
 {
 	delete mCurrentSMessageData;
 	mCurrentSMessageData = NULL;
+	delete[] mDirectBuffer;
+	delete[] mEncodedBuffer;
 }
 
 // virtual
@@ -63,6 +76,7 @@ void LLTemplateMessageBuilder::newMessage(const char *name)
 	mbSClear = FALSE;
 
 	mCurrentSendTotal = 0;
+	mBuiltBuffer = NULL;
 
 	delete mCurrentSMessageData;
 	mCurrentSMessageData = NULL;
@@ -71,28 +85,22 @@ void LLTemplateMessageBuilder::newMessage(const char *name)
 	if (mMessageTemplates.count(namep) > 0)
 	{
 		mCurrentSMessageTemplate = mMessageTemplates.find(name)->second;
-		mCurrentSMessageData = new LLMsgData(namep);
 		mCurrentSMessageName = namep;
 		mCurrentSDataBlock = NULL;
 		mCurrentSBlockName = NULL;
 
-		// add at one of each block
-		const LLMessageTemplate* msg_template = mMessageTemplates.find(name)->second;
-
-		if (msg_template->getDeprecation() != MD_NOTDEPRECATED)
+		if (mCurrentSMessageTemplate->getDeprecation() != MD_NOTDEPRECATED)
 		{
 			LL_WARNS() << "Sending deprecated message " << namep << LL_ENDL;
 		}
-		
-		LLMessageTemplate::message_block_map_t::const_iterator iter;
-		for(iter = msg_template->mMemberBlocks.begin();
-			iter != msg_template->mMemberBlocks.end();
-			++iter)
-		{
-			LLMessageBlock* ci = *iter;
-			LLMsgBlkData* tblockp = new LLMsgBlkData(ci->mName, 0);
-			mCurrentSMessageData->addBlock(tblockp);
-		}
+
+		// mCurrentSMessageData is only created if the message leaves the
+		// direct path
+		mDirect = TRUE;
+		mDirectSize = 0;
+		mDirectBlock = -1;
+		mDirectVar = 0;
+		mDirectBlockCount.assign(mCurrentSMessageTemplate->mMemberBlocks.size(), 0);
 	}
 	else
 	{
@@ -107,6 +115,8 @@ void LLTemplateMessageBuilder::clearMessage()
 	mbSClear = TRUE;
 
 	mCurrentSendTotal = 0;
+	mDirect = FALSE;
+	mBuiltBuffer = NULL;
 
 	mCurrentSMessageTemplate = NULL;
 
@@ -137,6 +147,15 @@ void LLTemplateMessageBuilder::nextBlock(const char* blockname)
 			<< " not a block in " << mCurrentSMessageTemplate->mName << LL_ENDL;
 		return;
 	}
+
+	if (mDirect)
+	{
+		if (nextBlockDirect(bnamep))
+		{
+			return;
+		}
+		switchToMessageData();
+	}
 	
 	// ok, have we already set this block?
 	LLMsgBlkData* block_data = mCurrentSMessageData->mMemberBlocks[bnamep];
@@ -222,6 +241,10 @@ void LLTemplateMessageBuilder::nextBlock(const char* blockname)
 // TODO: Remove this horror...
 BOOL LLTemplateMessageBuilder::removeLastBlock()
 {
+	if (mDirect)
+	{
+		switchToMessageData();
+	}
 	if (mCurrentSBlockName)
 	{
 		if (  (mCurrentSMessageData)
@@ -287,6 +310,15 @@ void LLTemplateMessageBuilder::addData(const char *varname, const void *data, EM
 {
 	char *vnamep = (char *)varname; 
 
+	if (mDirect)
+	{
+		if (addDataDirect(vnamep, data, size, FALSE))
+		{
+			return;
+		}
+		switchToMessageData();
+	}
+
 	// do we have a current message?
 	if (!mCurrentSMessageTemplate)
 	{
@@ -347,6 +379,15 @@ void LLTemplateMessageBuilder::addData(const char *varname, const void *data, EM
 {
 	char *vnamep = (char *)varname; 
 
+	if (mDirect)
+	{
+		if (addDataDirect(vnamep, data, 0, TRUE))
+		{
+			return;
+		}
+		switchToMessageData();
+	}
+
 	// do we have a current message?
 	if (!mCurrentSMessageTemplate)
 	{
@@ -383,6 +424,231 @@ void LLTemplateMessageBuilder::addData(const char *varname, const void *data, EM
 	}
 }
 
+// Returns FALSE if blockname cannot be encoded in place, the caller then
+// switches to mCurrentSMessageData and lets nextBlock() report any error.
+BOOL LLTemplateMessageBuilder::nextBlockDirect(const char* blockname)
+{
+	const LLMessageTemplate::message_block_map_t& blocks = mCurrentSMessageTemplate->mMemberBlocks;
+	LLMessageTemplate::message_block_map_t::const_iterator iter = blocks.find((char*)blockname);
+	S32 block = (S32)(iter - blocks.begin());
+	const LLMessageBlock* template_data = *iter;
+
+	if (block < mDirectBlock)
+	{
+		// out of template order
+		return FALSE;
+	}
+	if (mDirectBlock >= 0
+		&& mDirectVar < (S32)(*(blocks.begin() + mDirectBlock))->mMemberVariables.size())
+	{
+		// previous block is missing variables
+		return FALSE;
+	}
+
+	if (block == mDirectBlock)
+	{
+		// another repeat of the current block
+		if (template_data->mType == MBT_SINGLE
+			|| (template_data->mType == MBT_MULTIPLE
+				&& mDirectBlockCount[block] == template_data->mNumber)
+			|| mDirectBlockCount[block] >= MAX_BLOCKS)
+		{
+			return FALSE;
+		}
+	}
+	else
+	{
+		// one byte at most for each skipped block and this one
+		if (mDirectSize + block - mDirectBlock > MAX_BUFFER_SIZE)
+		{
+			return FALSE;
+		}
+		// skipped variable blocks are sent with 0 repeats
+		for (S32 i = mDirectBlock + 1; i < block; ++i)
+		{
+			if ((*(blocks.begin() + i))->mType == MBT_VARIABLE)
+			{
+				mDirectBuffer[mDirectSize++] = 0;
+			}
+		}
+		if (template_data->mType == MBT_VARIABLE)
+		{
+			mDirectCountPos = mDirectSize++;
+		}
+		mDirectBlock = block;
+	}
+
+	++mDirectBlockCount[block];
+	if (template_data->mType == MBT_VARIABLE)
+	{
+		mDirectBuffer[mDirectCountPos] = (U8)mDirectBlockCount[block];
+	}
+	mDirectVar = 0;
+	mCurrentSBlockName = (char*)blockname;
+	mBuiltBuffer = NULL;
+	return TRUE;
+}
+
+// Returns FALSE if varname is not the next variable of the current block or
+// the data needs any of the checks in addData().
+BOOL LLTemplateMessageBuilder::addDataDirect(const char* varname, const void* data, S32 size, BOOL fixed)
+{
+	if (mDirectBlock < 0)
+	{
+		return FALSE;
+	}
+	const LLMessageBlock::message_variable_map_t& vars = (*(mCurrentSMessageTemplate->mMemberBlocks.begin() + mDirectBlock))->mMemberVariables;
+	LLMessageBlock::message_variable_map_t::const_iterator iter = vars.find(varname);
+	if (iter == vars.end() || (S32)(iter - vars.begin()) != mDirectVar)
+	{
+		return FALSE;
+	}
+
+	const LLMessageVariable* var_data = *iter;
+	S32 size_bytes = 0;
+	if (var_data->getType() == MVT_VARIABLE)
+	{
+		size_bytes = var_data->getSize();
+		if (fixed
+			|| (size_bytes != 1 && size_bytes != 2 && size_bytes != 4)
+			|| (size_bytes == 1 && size > 255))
+		{
+			return FALSE;
+		}
+	}
+	else if (fixed)
+	{
+		size = var_data->getSize();
+	}
+	else if (size != var_data->getSize())
+	{
+		return FALSE;
+	}
+
+	if (mDirectSize + size_bytes + size > MAX_BUFFER_SIZE)
+	{
+		return FALSE;
+	}
+
+	U8* dest = mDirectBuffer + mDirectSize;
+	if (size_bytes == 1)
+	{
+		*dest = (U8)size;
+	}
+	else if (size_bytes == 2)
+	{
+		U16 sizeh = (U16)size;
+		htonmemcpy(dest, &sizeh, MVT_U16, 2);
+	}
+	else if (size_bytes == 4)
+	{
+		htonmemcpy(dest, &size, MVT_S32, 4);
+	}
+	dest += size_bytes;
+	if (size)
+	{
+		htonmemcpy(dest, data, var_data->getType(), size);
+	}
+
+	mDirectSize += size_bytes + size;
+	mCurrentSendTotal += size;
+	++mDirectVar;
+	mBuiltBuffer = NULL;
+	return TRUE;
+}
+
+// Rebuilds mCurrentSMessageData from mDirectBuffer and leaves the direct path
+// for the rest of the message.
+void LLTemplateMessageBuilder::switchToMessageData()
+{
+	mDirect = FALSE;
+	mBuiltBuffer = NULL;
+	createMessageData();
+
+	const LLMessageTemplate::message_block_map_t& blocks = mCurrentSMessageTemplate->mMemberBlocks;
+	U8 host_data[MAX_BUFFER_SIZE];
+	S32 pos = 0;
+	for (S32 block = 0; block <= mDirectBlock; ++block)
+	{
+		const LLMessageBlock* template_data = *(blocks.begin() + block);
+		if (template_data->mType == MBT_VARIABLE)
+		{
+			// repeat count
+			++pos;
+		}
+
+		S32 count = mDirectBlockCount[block];
+		for (S32 i = 0; i < count; ++i)
+		{
+			nextBlock(template_data->mName);
+
+			S32 var_count = (block == mDirectBlock && i == count - 1) ? mDirectVar : (S32)template_data->mMemberVariables.size();
+			LLMessageBlock::message_variable_map_t::const_iterator iter = template_data->mMemberVariables.begin();
+			for (S32 var = 0; var < var_count; ++var, ++iter)
+			{
+				const LLMessageVariable* var_data = *iter;
+				S32 size = var_data->getSize();
+				S32 data_size = -1;
+				if (var_data->getType() == MVT_VARIABLE)
+				{
+					data_size = size;
+					if (data_size == 1)
+					{
+						size = mDirectBuffer[pos];
+					}
+					else if (data_size == 2)
+					{
+						U16 sizeh;
+						htonmemcpy(&sizeh, mDirectBuffer + pos, MVT_U16, 2);
+						size = sizeh;
+					}
+					else
+					{
+						htonmemcpy(&size, mDirectBuffer + pos, MVT_S32, 4);
+					}
+					pos += data_size;
+				}
+				if (size)
+				{
+					// back to host order, LLMsgBlkData::addData() swaps again
+					htonmemcpy(host_data, mDirectBuffer + pos, var_data->getType(), size);
+				}
+				mCurrentSDataBlock->addData(var_data->getName(), size ? host_data : NULL, size,
+											var_data->getType(), data_size);
+				pos += size;
+			}
+		}
+	}
+}
+
+void LLTemplateMessageBuilder::createMessageData()
+{
+	delete mCurrentSMessageData;
+	mCurrentSMessageData = new LLMsgData(mCurrentSMessageName);
+	mCurrentSDataBlock = NULL;
+	mCurrentSBlockName = NULL;
+
+	// add at one of each block
+	LLMessageTemplate::message_block_map_t::const_iterator iter;
+	for(iter = mCurrentSMessageTemplate->mMemberBlocks.begin();
+		iter != mCurrentSMessageTemplate->mMemberBlocks.end();
+		++iter)
+	{
+		LLMessageBlock* ci = *iter;
+		LLMsgBlkData* tblockp = new LLMsgBlkData(ci->mName, 0);
+		mCurrentSMessageData->addBlock(tblockp);
+	}
+}
+
+LLMsgData* LLTemplateMessageBuilder::getCurrentMessage()
+{
+	if (mDirect)
+	{
+		switchToMessageData();
+	}
+	return mCurrentSMessageData;
+}
+
 void LLTemplateMessageBuilder::addBinaryData(const char *varname, 
 											const void *data, S32 size)
 {
@@ -494,36 +760,16 @@ void LLTemplateMessageBuilder::addUUID(const char *varname, const LLUUID& uuid)
 	addData(varname, uuid.mData, MVT_LLUUID, sizeof(uuid.mData));
 }
 
-static S32 zero_code(U8 **data, U32 *data_size)
+// Zero codes count bytes from in, see zero_code(). num_zeroes and net_gain
+// carry over between calls.
+static void zero_code_append(const U8* in, S32 count, U8*& outptr, U8& num_zeroes, S32& net_gain)
 {
-	// Encoded send buffer needs to be slightly larger since the zero
-	// coding can potentially increase the size of the send data.
-	static U8 encodedSendBuffer[2 * MAX_BUFFER_SIZE];
-
-	S32 count = *data_size;
-	
-	S32 net_gain = 0;
-	U8 num_zeroes = 0;
-	
-	U8 *inptr = (U8 *)*data;
-	U8 *outptr = (U8 *)encodedSendBuffer;
-
-// skip the packet id field
-
-	for (U32 ii = 0; ii < LL_PACKET_ID_SIZE ; ++ii)
-	{
-		count--;
-		*outptr++ = *inptr++;
-	}
-
-// build encoded packet, keeping track of net size gain
-
 // sequential zero bytes are encoded as 0 [U8 count] 
 // with 0 0 [count] representing wrap (>256 zeroes)
 
 	while (count--)
 	{
-		if (!(*inptr))   // in a zero count
+		if (!(*in))   // in a zero count
 		{
 			if (num_zeroes)
 			{
@@ -540,7 +786,7 @@ static S32 zero_code(U8 **data, U32 *data_size)
 				net_gain++;  // starting a zero count adds one
 				num_zeroes = 1;
 			}
-			inptr++;
+			in++;
 		}
 		else
 		{
@@ -549,9 +795,35 @@ static S32 zero_code(U8 **data, U32 *data_size)
 				*outptr++ = num_zeroes;
 				num_zeroes = 0;
 			}
-			*outptr++ = *inptr++;
+			*outptr++ = *in++;
 		}
 	}
+}
+
+static S32 zero_code(U8 **data, U32 *data_size)
+{
+	// Encoded send buffer needs to be slightly larger since the zero
+	// coding can potentially increase the size of the send data.
+	static U8 encodedSendBuffer[2 * MAX_BUFFER_SIZE];
+
+	S32 count = *data_size;
+	
+	S32 net_gain = 0;
+	U8 num_zeroes = 0;
+	
+	U8 *inptr = (U8 *)*data;
+	U8 *outptr = (U8 *)encodedSendBuffer;
+
+// skip the packet id field
+
+	for (U32 ii = 0; ii < LL_PACKET_ID_SIZE ; ++ii)
+	{
+		count--;
+		*outptr++ = *inptr++;
+	}
+
+// build encoded packet, keeping track of net size gain
+	zero_code_append(inptr, count, outptr, num_zeroes, net_gain);
 
 	if (num_zeroes)
 	{
@@ -580,7 +852,21 @@ void LLTemplateMessageBuilder::compressMessage(U8*& buf_ptr, U32& buffer_length)
 {
 	if(ME_ZEROCODED == mCurrentSMessageTemplate->getEncoding())
 	{
-		zero_code(&buf_ptr, &buffer_length);
+		if (buf_ptr == mBuiltBuffer && buffer_length == mBuiltSize)
+		{
+			// buildMessage() already encoded everything after the header
+			if (mEncodedSize)
+			{
+				memcpy(mEncodedBuffer, buf_ptr, LL_PACKET_ID_SIZE);	/* Flawfinder: ignore */
+				mEncodedBuffer[0] |= LL_ZERO_CODE_FLAG;
+				buf_ptr = mEncodedBuffer;
+				buffer_length = mEncodedSize;
+			}
+		}
+		else
+		{
+			zero_code(&buf_ptr, &buffer_length);
+		}
 	}
 }
 
@@ -612,7 +898,17 @@ BOOL LLTemplateMessageBuilder::isMessageFull(const char* blockname) const
 		max = MAX_BLOCKS;
 		break;
 	}
-	if(mCurrentSMessageData->mMemberBlocks[bnamep]->mBlockNumber >= max)
+	S32 count;
+	if (mDirect)
+	{
+		const LLMessageTemplate::message_block_map_t& blocks = mCurrentSMessageTemplate->mMemberBlocks;
+		count = mDirectBlockCount[blocks.find(bnamep) - blocks.begin()];
+	}
+	else
+	{
+		count = mCurrentSMessageData->mMemberBlocks[bnamep]->mBlockNumber;
+	}
+	if(count >= max)
 	{
 		return TRUE;
 	}
@@ -815,6 +1111,16 @@ U32 LLTemplateMessageBuilder::buildMessage(
 
 	// fast forward through the offset and build the message
 	result += offset_to_data;
+	if (mDirect)
+	{
+		if (buildDirect(buffer, buffer_size, result))
+		{
+			mbSBuilt = TRUE;
+			return result;
+		}
+		switchToMessageData();
+	}
+	mBuiltBuffer = NULL;
 	for(LLMessageTemplate::message_block_map_t::const_iterator
 			iter = mCurrentSMessageTemplate->mMemberBlocks.begin(),
 			end = mCurrentSMessageTemplate->mMemberBlocks.end();
@@ -828,6 +1134,64 @@ U32 LLTemplateMessageBuilder::buildMessage(
 	return result;
 }
 
+// Copies out mDirectBuffer after the header written by buildMessage(),
+// zero coding it on the way for compressMessage(). Returns FALSE if the
+// message is incomplete.
+BOOL LLTemplateMessageBuilder::buildDirect(U8* buffer, U32 buffer_size, U32& result)
+{
+	const LLMessageTemplate::message_block_map_t& blocks = mCurrentSMessageTemplate->mMemberBlocks;
+	if (mDirectBlock >= 0
+		&& mDirectVar < (S32)(*(blocks.begin() + mDirectBlock))->mMemberVariables.size())
+	{
+		return FALSE;
+	}
+
+	// variable blocks after the last one used are sent with 0 repeats
+	S32 trailing = 0;
+	S32 block_count = (S32)blocks.size();
+	for (S32 i = 0; i < block_count; ++i)
+	{
+		const LLMessageBlock* template_data = *(blocks.begin() + i);
+		if (template_data->mType == MBT_MULTIPLE
+			&& mDirectBlockCount[i] != template_data->mNumber)
+		{
+			return FALSE;
+		}
+		if (i > mDirectBlock && template_data->mType == MBT_VARIABLE)
+		{
+			++trailing;
+		}
+	}
+	if (result + mDirectSize + trailing > buffer_size)
+	{
+		return FALSE;
+	}
+
+	memcpy(buffer + result, mDirectBuffer, mDirectSize);	/* Flawfinder: ignore */
+	memset(buffer + result + mDirectSize, 0, trailing);
+	result += mDirectSize + trailing;
+
+	mBuiltBuffer = buffer;
+	mBuiltSize = result;
+	mEncodedSize = 0;
+	if (ME_ZEROCODED == mCurrentSMessageTemplate->getEncoding())
+	{
+		U8* outptr = mEncodedBuffer + LL_PACKET_ID_SIZE;
+		U8 num_zeroes = 0;
+		S32 net_gain = 0;
+		zero_code_append(buffer + LL_PACKET_ID_SIZE, result - LL_PACKET_ID_SIZE, outptr, num_zeroes, net_gain);
+		if (num_zeroes)
+		{
+			*outptr++ = num_zeroes;
+		}
+		if (net_gain < 0)
+		{
+			mEncodedSize = result + net_gain;
+		}
+	}
+	return TRUE;
+}
+
 void LLTemplateMessageBuilder::copyFromMessageData(const LLMsgData& data)
 {
 	// copy the blocks
@@ -28,6 +28,7 @@
 #define LL_LLTEMPLATEMESSAGEBUILDER_H
 
 #include <map>
+#include <vector>
 
 #include "llmessagebuilder.h"
 #include "llmsgvariabletype.h"
@@ -93,7 +94,7 @@ public:
 	virtual void copyFromMessageData(const LLMsgData& data);
 	virtual void copyFromLLSD(const LLSD&);
 
-	LLMsgData* getCurrentMessage() const { return mCurrentSMessageData; }
+	LLMsgData* getCurrentMessage();
 private:
 	void addData(const char* varname, const void* data, 
 					 EMsgVariableType type, S32 size);
@@ -101,6 +102,15 @@ private:
 	void addData(const char* varname, const void* data, 
 						EMsgVariableType type);
 
+	// Messages are encoded straight into mDirectBuffer while blocks and
+	// variables arrive in template order. Anything else switches the
+	// message over to mCurrentSMessageData.
+	BOOL nextBlockDirect(const char* blockname);
+	BOOL addDataDirect(const char* varname, const void* data, S32 size, BOOL fixed);
+	BOOL buildDirect(U8* buffer, U32 buffer_size, U32& result);
+	void switchToMessageData();
+	void createMessageData();
+
 	LLMsgData* mCurrentSMessageData;
 	const LLMessageTemplate* mCurrentSMessageTemplate;
 	LLMsgBlkData* mCurrentSDataBlock;
@@ -110,6 +120,20 @@ private:
 	BOOL mbSClear;
 	S32	 mCurrentSendTotal;
 	const message_template_name_map_t& mMessageTemplates;
+
+	BOOL mDirect;
+	U8* mDirectBuffer;						// encoded blocks, MAX_BUFFER_SIZE bytes
+	S32 mDirectSize;
+	S32 mDirectBlock;						// template index of the current block, -1 before the first
+	S32 mDirectVar;							// template index of the next variable in that block
+	S32 mDirectCountPos;					// repeat count byte of the current MBT_VARIABLE block
+	std::vector<S32> mDirectBlockCount;		// repeats of each template block
+
+	// buildMessage() zero codes direct messages as it copies them out
+	U8* mEncodedBuffer;
+	U32 mEncodedSize;						// 0 if zero coding did not help
+	const U8* mBuiltBuffer;
+	U32 mBuiltSize;
 };
 
 #endif // LL_LLTEMPLATEMESSAGEBUILDER_H
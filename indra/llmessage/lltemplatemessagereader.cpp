@@ -101,7 +101,45 @@ void LLTemplateMessageReader::getData(const char *blockname, const char *varname
 	}
 
 	LLMsgVarData& vardata = msg_block_data->mMemberVarData[vnamep];
+	copyData(vardata, vnamep, datap, size, max_size);
+}
+
+void LLTemplateMessageReader::getData(LLMessageAccessor& field, void *datap, S32 size, S32 blocknum, S32 max_size)
+{
+	LLMsgVarData* vardata = findVarData(field, blocknum);
+	if (!vardata)
+	{
+		// let the name lookup report what is wrong
+		getData(field.mBlockName, field.mVarName, datap, size, blocknum, max_size);
+		return;
+	}
+	copyData(*vardata, field.mVarName, datap, size, max_size);
+}
+
+// Returns NULL when the accessor does not match the current message
+LLMsgVarData* LLTemplateMessageReader::findVarData(LLMessageAccessor& field, S32 blocknum)
+{
+	if (mReceiveSize == -1 || !mCurrentRMessageData || !mCurrentRMessageTemplate)
+	{
+		return NULL;
+	}
 
+	if (field.mTemplate != mCurrentRMessageTemplate)
+	{
+		if (!mCurrentRMessageTemplate->getVariableIndex(field.mBlockName, field.mVarName,
+														field.mBlockIndex, field.mVarIndex))
+		{
+			return NULL;
+		}
+		field.mTemplate = mCurrentRMessageTemplate;
+	}
+
+	LLMsgBlkData* msg_block_data = mCurrentRMessageData->getBlock(field.mBlockIndex, blocknum);
+	return msg_block_data ? msg_block_data->getVarData(field.mVarIndex) : NULL;
+}
+
+void LLTemplateMessageReader::copyData(LLMsgVarData& vardata, const char *vnamep, void *datap, S32 size, S32 max_size)
+{
 	if (size && size != vardata.getSize())
 	{
 		LL_ERRS() << "Msg " << mCurrentRMessageData->mName 
@@ -436,6 +474,100 @@ inline void LLTemplateMessageReader::getString(const char *block, const char *va
 	outstr = s;
 }
 
+void LLTemplateMessageReader::getBinaryData(LLMessageAccessor& field, void *datap,
+											S32 size, S32 blocknum, S32 max_size)
+{
+	getData(field, datap, size, blocknum, max_size);
+}
+
+void LLTemplateMessageReader::getU8(LLMessageAccessor& field, U8 &u, S32 blocknum)
+{
+	getData(field, &u, sizeof(U8), blocknum);
+}
+
+void LLTemplateMessageReader::getU16(LLMessageAccessor& field, U16 &d, S32 blocknum)
+{
+	getData(field, &d, sizeof(U16), blocknum);
+}
+
+void LLTemplateMessageReader::getS32(LLMessageAccessor& field, S32 &d, S32 blocknum)
+{
+	getData(field, &d, sizeof(S32), blocknum);
+}
+
+void LLTemplateMessageReader::getU32(LLMessageAccessor& field, U32 &d, S32 blocknum)
+{
+	getData(field, &d, sizeof(U32), blocknum);
+}
+
+void LLTemplateMessageReader::getU64(LLMessageAccessor& field, U64 &d, S32 blocknum)
+{
+	getData(field, &d, sizeof(U64), blocknum);
+}
+
+void LLTemplateMessageReader::getF32(LLMessageAccessor& field, F32 &d, S32 blocknum)
+{
+	getData(field, &d, sizeof(F32), blocknum);
+
+	if( !llfinite( d ) )
+	{
+		LL_WARNS() << "non-finite in getF32Fast " << field.mBlockName << " " << field.mVarName
+				<< LL_ENDL;
+		d = 0;
+	}
+}
+
+void LLTemplateMessageReader::getVector3(LLMessageAccessor& field, LLVector3 &v, S32 blocknum)
+{
+	getData(field, &v.mV[0], sizeof(v.mV), blocknum);
+
+	if( !v.isFinite() )
+	{
+		LL_WARNS() << "non-finite in getVector3Fast " << field.mBlockName << " " 
+				<< field.mVarName << LL_ENDL;
+		v.zeroVec();
+	}
+}
+
+void LLTemplateMessageReader::getQuat(LLMessageAccessor& field, LLQuaternion &q, S32 blocknum)
+{
+	LLVector3 vec;
+	getData(field, &vec.mV[0], sizeof(vec.mV), blocknum);
+	if( vec.isFinite() )
+	{
+		q.unpackFromVector3( vec );
+	}
+	else
+	{
+		LL_WARNS() << "non-finite in getQuatFast " << field.mBlockName << " " << field.mVarName
+				<< LL_ENDL;
+		q.loadIdentity();
+	}
+}
+
+void LLTemplateMessageReader::getUUID(LLMessageAccessor& field, LLUUID &u, S32 blocknum)
+{
+	getData(field, &u.mData[0], sizeof(u.mData), blocknum);
+}
+
+void LLTemplateMessageReader::getString(LLMessageAccessor& field, std::string& outstr, S32 blocknum)
+{
+	char s[MTUBYTES + 1]= {0}; // every element is initialized with 0
+	getData(field, s, 0, blocknum, MTUBYTES);
+	s[MTUBYTES] = '\0';
+	outstr = s;
+}
+
+S32 LLTemplateMessageReader::getSize(LLMessageAccessor& field, S32 blocknum)
+{
+	LLMsgVarData* vardata = findVarData(field, blocknum);
+	if (!vardata)
+	{
+		return getSize(field.mBlockName, blocknum, field.mVarName);
+	}
+	return vardata->getSize();
+}
+
 //virtual 
 S32 LLTemplateMessageReader::getMessageSize() const
 {
@@ -546,6 +678,8 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 	// create base working data set
 	mCurrentRMessageData = new LLMsgData(mCurrentRMessageTemplate->mName);
 	
+	mCurrentRMessageData->mBlockStart.reserve(mCurrentRMessageTemplate->mMemberBlocks.size());
+
 	// loop through the template building the data structure as we go
 	LLMessageTemplate::message_block_map_t::const_iterator iter;
 	for(iter = mCurrentRMessageTemplate->mMemberBlocks.begin();
@@ -594,6 +728,7 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 		}
 
 		LLMsgBlkData* cur_data_block = NULL;
+		mCurrentRMessageData->mBlockStart.push_back((S32)mCurrentRMessageData->mBlockList.size());
 
 		// now loop through the block
 		for (i = 0; i < repeat_number; i++)
@@ -612,6 +747,7 @@ BOOL LLTemplateMessageReader::decodeData(const U8* buffer, const LLHost& sender
 
 			// add the block to the message
 			mCurrentRMessageData->addBlock(cur_data_block);
+			mCurrentRMessageData->mBlockList.push_back(cur_data_block);
 
 			// now read the variables
 			for (LLMessageBlock::message_variable_map_t::const_iterator iter = 
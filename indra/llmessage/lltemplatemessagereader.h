@@ -31,8 +31,10 @@
 
 #include <map>
 
+class LLMessageAccessor;
 class LLMessageTemplate;
 class LLMsgData;
+class LLMsgVarData;
 
 class LLTemplateMessageReader : public LLMessageReader
 {
@@ -91,6 +93,21 @@ public:
 	virtual S32	getSize(const char *blockname, S32 blocknum, 
 						const char *varname);
 
+	// Accessor versions of the getters above, see LLMessageAccessor.
+	void getBinaryData(LLMessageAccessor& field, void *datap, S32 size,
+					   S32 blocknum = 0, S32 max_size = S32_MAX);
+	void getU8(LLMessageAccessor& field, U8 &data, S32 blocknum = 0);
+	void getU16(LLMessageAccessor& field, U16 &data, S32 blocknum = 0);
+	void getS32(LLMessageAccessor& field, S32 &data, S32 blocknum = 0);
+	void getU32(LLMessageAccessor& field, U32 &data, S32 blocknum = 0);
+	void getU64(LLMessageAccessor& field, U64 &data, S32 blocknum = 0);
+	void getF32(LLMessageAccessor& field, F32 &data, S32 blocknum = 0);
+	void getVector3(LLMessageAccessor& field, LLVector3 &vec, S32 blocknum = 0);
+	void getQuat(LLMessageAccessor& field, LLQuaternion &q, S32 blocknum = 0);
+	void getUUID(LLMessageAccessor& field, LLUUID &uuid, S32 blocknum = 0);
+	void getString(LLMessageAccessor& field, std::string& outstr, S32 blocknum = 0);
+	S32	getSize(LLMessageAccessor& field, S32 blocknum);
+
 	virtual void clearMessage();
 
 	virtual const char* getMessageName() const;
@@ -110,6 +127,11 @@ private:
 
 	void getData(const char *blockname, const char *varname, void *datap, 
 				 S32 size = 0, S32 blocknum = 0, S32 max_size = S32_MAX);
+	void getData(LLMessageAccessor& field, void *datap, 
+				 S32 size = 0, S32 blocknum = 0, S32 max_size = S32_MAX);
+	void copyData(LLMsgVarData& vardata, const char *vnamep, void *datap,
+				  S32 size, S32 max_size);
+	LLMsgVarData* findVarData(LLMessageAccessor& field, S32 blocknum);
 
 	BOOL decodeTemplate(const U8* buffer, S32 buffer_size,  // inputs
 						LLMessageTemplate** msg_template ); // outputs
@@ -0,0 +1,140 @@
+/**
+ * @file lltimingwheel.h
+ * @brief Hashed timing wheel for scheduling many short deadlines.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTIMINGWHEEL_H
+#define LL_LLTIMINGWHEEL_H
+
+#include <vector>
+
+#include "llunits.h"
+
+// Values are hashed into slots by the tick their deadline falls in.
+// collectDue() only looks at the slots for the ticks passed since the
+// last call, so its cost follows the number of deadlines coming due
+// rather than the number scheduled.  Deadlines more than a revolution
+// away share a slot with nearer ones and are skipped over until due.
+//
+// There is no removal, owners look the value up when it comes due and
+// ignore it if it no longer applies.
+template <typename T>
+class LLTimingWheel
+{
+public:
+	// slot_count must be a power of two.
+	LLTimingWheel(F64Seconds tick, U32 slot_count)
+	:	mSlots(slot_count),
+		mMask(slot_count - 1),
+		mTicksPerSecond(1.0 / tick.value()),
+		mCurrentTick(-1),
+		mCount(0)
+	{
+		llassert(slot_count && !(slot_count & mMask));
+	}
+
+	void schedule(const T& value, F64Seconds when)
+	{
+		S64 tick = getTick(when);
+		if (mCurrentTick < 0)
+		{
+			mCurrentTick = tick;
+		}
+		// Anything already due goes in the next slot collectDue() looks at.
+		tick = llmax(tick, mCurrentTick);
+		Entry entry = { value, when };
+		mSlots[tick & mMask].push_back(entry);
+		++mCount;
+	}
+
+	// Appends the values with deadlines before now to due.
+	void collectDue(F64Seconds now, std::vector<T>& due)
+	{
+		const S64 now_tick = getTick(now);
+		if (!mCount)
+		{
+			mCurrentTick = now_tick;
+			return;
+		}
+
+		S64 first = mCurrentTick;
+		if (now_tick - first >= (S64)mSlots.size())
+		{
+			// Been away for a whole revolution, every slot may have some.
+			first = now_tick - mMask;
+		}
+		for (S64 tick = first; tick <= now_tick && mCount; ++tick)
+		{
+			slot_t& slot = mSlots[tick & mMask];
+			for (U32 i = 0; i < slot.size(); )
+			{
+				if (slot[i].mWhen < now)
+				{
+					due.push_back(slot[i].mValue);
+					slot[i] = slot.back();
+					slot.pop_back();
+					--mCount;
+				}
+				else
+				{
+					++i;
+				}
+			}
+		}
+		mCurrentTick = now_tick;
+	}
+
+	void clear()
+	{
+		for (typename std::vector<slot_t>::iterator it = mSlots.begin(); it != mSlots.end(); ++it)
+		{
+			it->clear();
+		}
+		mCount = 0;
+	}
+
+	bool empty() const		{ return !mCount; }
+	U32 size() const		{ return mCount; }
+
+private:
+	S64 getTick(F64Seconds when) const
+	{
+		return (S64)(when.value() * mTicksPerSecond);
+	}
+
+	struct Entry
+	{
+		T			mValue;
+		F64Seconds	mWhen;
+	};
+	typedef std::vector<Entry> slot_t;
+
+	std::vector<slot_t>	mSlots;
+	const U32			mMask;
+	const F64			mTicksPerSecond;
+	S64					mCurrentTick;	// slots before this one have been collected
+	U32					mCount;
+};
+
+#endif // LL_LLTIMINGWHEEL_H
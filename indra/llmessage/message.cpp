@@ -55,6 +55,7 @@
 #include "llmessagebuilder.h"
 #include "llmessageconfig.h"
 #include "lltemplatemessagedispatcher.h"
+#include "llpacketreceivethread.h"
 #include "llpumpio.h"
 #include "lltemplatemessagebuilder.h"
 #include "lltemplatemessagereader.h"
@@ -77,6 +78,7 @@
 #include "lltransfertargetvfile.h"
 #include "llcorehttputil.h"
 #include "llpounceable.h"
+#include "llproxy.h"
 
 // Constants
 //const char* MESSAGE_LOG_FILENAME = "message.log";
@@ -190,6 +192,9 @@ void LLMessageSystem::init()
 
 	mMessageBuilder = NULL;
 	mMessageReader = NULL;
+
+	mReceiveThread = NULL;
+	mReceivedPacket = NULL;
 }
 
 // Read file and build message templates
@@ -321,6 +326,8 @@ LLMessageSystem::~LLMessageSystem()
 	mMessageTemplates.clear(); // don't delete templates.
 	for_each(mMessageNumbers.begin(), mMessageNumbers.end(), DeletePairedPointer());
 	mMessageNumbers.clear();
+
+	stopReceiveThread();
 	
 	if (!mbError)
 	{
@@ -479,6 +486,45 @@ LLCircuitData* LLMessageSystem::findCircuit(const LLHost& host,
 	return cdp;
 }
 
+void LLMessageSystem::startReceiveThread()
+{
+	if (mReceiveThread || mbError)
+	{
+		return;
+	}
+	if (LLProxy::isSOCKSProxyEnabled())
+	{
+		// The thread reads the socket directly and would not strip the
+		// SOCKS5 UDP header, leave it to mPacketRing.
+		LL_INFOS("Messaging") << "Not starting packet receive thread, SOCKS5 UDP proxy is enabled" << LL_ENDL;
+		return;
+	}
+	LL_INFOS("Messaging") << "Starting packet receive thread" << LL_ENDL;
+	mReceiveThread = new LLPacketReceiveThread(mSocket);
+	mReceiveThread->start();
+}
+
+void LLMessageSystem::stopReceiveThread()
+{
+	if (!mReceiveThread)
+	{
+		return;
+	}
+	releaseReceivedPacket();
+	mReceiveThread->shutdown();
+	delete mReceiveThread;
+	mReceiveThread = NULL;
+}
+
+void LLMessageSystem::releaseReceivedPacket()
+{
+	if (mReceivedPacket)
+	{
+		mReceiveThread->releasePacket(mReceivedPacket);
+		mReceivedPacket = NULL;
+	}
+}
+
 // Returns TRUE if a valid, on-circuit message has been received.
 BOOL LLMessageSystem::checkMessages( S64 frame_count )
 {
@@ -487,6 +533,14 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 	mMessageReader = mTemplateMessageReader;
 
 	LLTransferTargetVFile::updateQueue();
+
+	if (mReceiveThread && LLProxy::isSOCKSProxyEnabled())
+	{
+		// The proxy came up after the thread started. Anything it has
+		// queued is dropped, reliable traffic will be resent.
+		LL_INFOS("Messaging") << "SOCKS5 UDP proxy enabled, stopping packet receive thread" << LL_ENDL;
+		stopReceiveThread();
+	}
 	
 	if (!mNumMessageCounts)
 	{
@@ -502,6 +556,7 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 	do
 	{
 		clearReceiveState();
+		releaseReceivedPacket();
 		
 		BOOL recv_reliable = FALSE;
 		BOOL recv_resent = FALSE;
@@ -510,13 +565,27 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 
 		U8* buffer = mTrueReceiveBuffer;
 		
-		mTrueReceiveSize = mPacketRing.receivePacket(mSocket, (char *)mTrueReceiveBuffer);
-		// If you want to dump all received packets into SecondLife.log, uncomment this
-		//dumpPacketToLog();
+		if (mReceiveThread)
+		{
+			mReceivedPacket = mReceiveThread->popPacket();
+			mTrueReceiveSize = mReceivedPacket ? mReceivedPacket->mSize : 0;
+			if (mReceivedPacket)
+			{
+				mLastSender = mReceivedPacket->mSender;
+				mLastReceivingIF = mReceivedPacket->mReceivingIF;
+			}
+		}
+		else
+		{
+			mTrueReceiveSize = mPacketRing.receivePacket(mSocket, (char *)mTrueReceiveBuffer);
+			// If you want to dump all received packets into SecondLife.log, uncomment this
+			//dumpPacketToLog();
+
+			mLastSender = mPacketRing.getLastSender();
+			mLastReceivingIF = mPacketRing.getLastReceivingInterface();
+		}
 		
 		receive_size = mTrueReceiveSize;
-		mLastSender = mPacketRing.getLastSender();
-		mLastReceivingIF = mPacketRing.getLastReceivingInterface();
 		
 		if (receive_size < (S32) LL_MINIMUM_VALID_PACKET_SIZE)
 		{
@@ -535,8 +604,29 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 			LLHost host;
 			LLCircuitData* cdp;
 			
+			if (mReceivedPacket)
+			{
+				// acks were split off and the body expanded by the receive thread
+				acks = mReceivedPacket->mAckCount;
+				true_rcv_size = mTrueReceiveSize;
+				buffer = mReceivedPacket->mBodyp;
+				receive_size = mReceivedPacket->mBodySize;
+
+				mTotalBytesIn += mReceivedPacket->mPackedSize ? mReceivedPacket->mPackedSize : receive_size;
+				mIncomingCompressedSize = mReceivedPacket->mPackedSize;
+				if (mIncomingCompressedSize)
+				{
+					mCompressedPacketsIn++;
+					mCompressedBytesIn += mIncomingCompressedSize;
+					mUncompressedBytesIn += receive_size;
+				}
+				for (S32 i = 0; i < mReceivedPacket->mExpandErrors; ++i)
+				{
+					callExceptionFunc(MX_WROTE_PAST_BUFFER_SIZE);
+				}
+			}
 			// note if packet acks are appended.
-			if(buffer[0] & LL_ACK_FLAG)
+			else if(buffer[0] & LL_ACK_FLAG)
 			{
 				acks += buffer[--receive_size];
 				true_rcv_size = receive_size;
@@ -557,7 +647,10 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 			}
 
 			// process the message as normal
-			mIncomingCompressedSize = zeroCodeExpand(&buffer, &receive_size);
+			if (!mReceivedPacket)
+			{
+				mIncomingCompressedSize = zeroCodeExpand(&buffer, &receive_size);
+			}
 			mCurrentRecvPacketID = ntohl(*((U32*)(&buffer[1])));
 			host = getSender();
 
@@ -574,10 +667,17 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 				U32 mem_id=0;
 				for(S32 i = 0; i < acks; ++i)
 				{
-					true_rcv_size -= sizeof(TPACKETID);
-					memcpy(&mem_id, &mTrueReceiveBuffer[true_rcv_size], /* Flawfinder: ignore*/
-					     sizeof(TPACKETID));
-					packet_id = ntohl(mem_id);
+					if (mReceivedPacket)
+					{
+						packet_id = mReceivedPacket->mAcks[i];
+					}
+					else
+					{
+						true_rcv_size -= sizeof(TPACKETID);
+						memcpy(&mem_id, &mTrueReceiveBuffer[true_rcv_size], /* Flawfinder: ignore*/
+							 sizeof(TPACKETID));
+						packet_id = ntohl(mem_id);
+					}
 					//LL_INFOS("Messaging") << "got ack: " << packet_id << LL_ENDL;
 					cdp->ackReliablePacket(packet_id);
 				}
@@ -730,6 +830,7 @@ BOOL LLMessageSystem::checkMessages( S64 frame_count )
 	if( !valid_packet )
 	{
 		clearReceiveState();
+		releaseReceivedPacket();
 	}
 
 	return valid_packet;
@@ -770,6 +871,9 @@ void LLMessageSystem::processAcks(F32 collect_time)
 		// Check the status of circuits
 		mCircuitInfo.updateWatchDogTimers(this);
 
+		// resends and acks are written out together below
+		mPacketRing.beginSendBatch();
+
 		//resend any necessary packets
 		mCircuitInfo.resendUnackedPackets(mUnackedListDepth, mUnackedListSize);
 
@@ -786,6 +890,8 @@ void LLMessageSystem::processAcks(F32 collect_time)
 			mDenyTrustedCircuitSet.clear();
 		}
 
+		mSendPacketFailureCount += mPacketRing.flushSendBatch();
+
 		if (mMaxMessageCounts >= 0)
 		{
 			if (mNumMessageCounts >= mMaxMessageCounts)
@@ -2834,13 +2940,29 @@ S32 LLMessageSystem::zeroCodeExpand(U8** data, S32* data_size)
 	S32 in_size = *data_size;
 	mCompressedPacketsIn++;
 	mCompressedBytesIn += *data_size;
-	
-	*data[0] &= (~LL_ZERO_CODE_FLAG);
 
-	S32 count = (*data_size);  
+	S32 errors = 0;
+	*data_size = zeroCodeExpand(*data, in_size, mEncodedRecvBuffer, errors);
+	*data = mEncodedRecvBuffer;
+	mUncompressedBytesIn += *data_size;
+
+	for (S32 i = 0; i < errors; ++i)
+	{
+		callExceptionFunc(MX_WROTE_PAST_BUFFER_SIZE);
+	}
+
+	return(in_size);
+}
+
+// static
+S32 LLMessageSystem::zeroCodeExpand(U8* in, S32 in_size, U8* out, S32& errors)
+{
+	in[0] &= (~LL_ZERO_CODE_FLAG);
+
+	S32 count = in_size;
 	
-	U8 *inptr = (U8 *)*data;
-	U8 *outptr = (U8 *)mEncodedRecvBuffer;
+	U8 *inptr = in;
+	U8 *outptr = out;
 
 // skip the packet id field
 
@@ -2857,11 +2979,11 @@ S32 LLMessageSystem::zeroCodeExpand(U8** data, S32* data_size)
 
 	while (count--)
 	{
-		if (outptr > (&mEncodedRecvBuffer[MAX_BUFFER_SIZE-1]))
+		if (outptr > (&out[MAX_BUFFER_SIZE-1]))
 		{
 			LL_WARNS("Messaging") << "attempt to write past reasonable encoded buffer size 1" << LL_ENDL;
-			callExceptionFunc(MX_WROTE_PAST_BUFFER_SIZE);
-			outptr = mEncodedRecvBuffer;					
+			errors++;
+			outptr = out;
 			break;
 		}
 		if (!((*outptr++ = *inptr++)))
@@ -2869,11 +2991,11 @@ S32 LLMessageSystem::zeroCodeExpand(U8** data, S32* data_size)
 			while (((count--)) && (!(*inptr)))
 			{
 				*outptr++ = *inptr++;
-  				if (outptr > (&mEncodedRecvBuffer[MAX_BUFFER_SIZE-256]))
+  				if (outptr > (&out[MAX_BUFFER_SIZE-256]))
   				{
   					LL_WARNS("Messaging") << "attempt to write past reasonable encoded buffer size 2" << LL_ENDL;
-					callExceptionFunc(MX_WROTE_PAST_BUFFER_SIZE);
-					outptr = mEncodedRecvBuffer;
+					errors++;
+					outptr = out;
 					count = -1;
 					break;
   				}
@@ -2888,11 +3010,11 @@ S32 LLMessageSystem::zeroCodeExpand(U8** data, S32* data_size)
 
 			else
 			{
-  				if (outptr > (&mEncodedRecvBuffer[MAX_BUFFER_SIZE-(*inptr)]))
+  				if (outptr > (&out[MAX_BUFFER_SIZE-(*inptr)]))
 				{
   					LL_WARNS("Messaging") << "attempt to write past reasonable encoded buffer size 3" << LL_ENDL;
-					callExceptionFunc(MX_WROTE_PAST_BUFFER_SIZE);
-					outptr = mEncodedRecvBuffer;					
+					errors++;
+					outptr = out;
 				}
 				memset(outptr,0,(*inptr) - 1);
 				outptr += ((*inptr) - 1);
@@ -2901,11 +3023,7 @@ S32 LLMessageSystem::zeroCodeExpand(U8** data, S32* data_size)
 		}		
 	}
 	
-	*data = mEncodedRecvBuffer;
-	*data_size = (S32)(outptr - mEncodedRecvBuffer);
-	mUncompressedBytesIn += *data_size;
-
-	return(in_size);
+	return (S32)(outptr - out);
 }
 
 
@@ -3956,6 +4074,152 @@ S32	LLMessageSystem::getSize(const char *blockname, S32 blocknum,
 					   LLMessageStringTable::getInstance()->getString(varname));
 }
 
+// Accessor reads go straight to the template reader, which caches the
+// variable's position in the accessor. LLSD messages use the names.
+void LLMessageSystem::getBinaryData(LLMessageAccessor& field, void *datap, 
+									S32 size, S32 blocknum, S32 max_size)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getBinaryData(field, datap, size, blocknum, max_size);
+	}
+	else
+	{
+		mMessageReader->getBinaryData(field.mBlockName, field.mVarName, datap, size, 
+									  blocknum, max_size);
+	}
+}
+
+void LLMessageSystem::getU8(LLMessageAccessor& field, U8 &d, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getU8(field, d, blocknum);
+	}
+	else
+	{
+		mMessageReader->getU8(field.mBlockName, field.mVarName, d, blocknum);
+	}
+}
+
+void LLMessageSystem::getU16(LLMessageAccessor& field, U16 &d, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getU16(field, d, blocknum);
+	}
+	else
+	{
+		mMessageReader->getU16(field.mBlockName, field.mVarName, d, blocknum);
+	}
+}
+
+void LLMessageSystem::getS32(LLMessageAccessor& field, S32 &d, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getS32(field, d, blocknum);
+	}
+	else
+	{
+		mMessageReader->getS32(field.mBlockName, field.mVarName, d, blocknum);
+	}
+}
+
+void LLMessageSystem::getU32(LLMessageAccessor& field, U32 &d, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getU32(field, d, blocknum);
+	}
+	else
+	{
+		mMessageReader->getU32(field.mBlockName, field.mVarName, d, blocknum);
+	}
+}
+
+void LLMessageSystem::getU64(LLMessageAccessor& field, U64 &d, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getU64(field, d, blocknum);
+	}
+	else
+	{
+		mMessageReader->getU64(field.mBlockName, field.mVarName, d, blocknum);
+	}
+}
+
+void LLMessageSystem::getF32(LLMessageAccessor& field, F32 &d, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getF32(field, d, blocknum);
+	}
+	else
+	{
+		mMessageReader->getF32(field.mBlockName, field.mVarName, d, blocknum);
+	}
+}
+
+void LLMessageSystem::getVector3(LLMessageAccessor& field, LLVector3& v, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getVector3(field, v, blocknum);
+	}
+	else
+	{
+		mMessageReader->getVector3(field.mBlockName, field.mVarName, v, blocknum);
+	}
+}
+
+void LLMessageSystem::getQuat(LLMessageAccessor& field, LLQuaternion& q, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getQuat(field, q, blocknum);
+	}
+	else
+	{
+		mMessageReader->getQuat(field.mBlockName, field.mVarName, q, blocknum);
+	}
+}
+
+void LLMessageSystem::getUUID(LLMessageAccessor& field, LLUUID& uuid, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getUUID(field, uuid, blocknum);
+	}
+	else
+	{
+		mMessageReader->getUUID(field.mBlockName, field.mVarName, uuid, blocknum);
+	}
+}
+
+void LLMessageSystem::getString(LLMessageAccessor& field, std::string& outstr, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		mTemplateMessageReader->getString(field, outstr, blocknum);
+	}
+	else
+	{
+		mMessageReader->getString(field.mBlockName, field.mVarName, outstr, blocknum);
+	}
+}
+
+S32 LLMessageSystem::getSize(LLMessageAccessor& field, S32 blocknum)
+{
+	if (mMessageReader == mTemplateMessageReader)
+	{
+		return mTemplateMessageReader->getSize(field, blocknum);
+	}
+	return mMessageReader->getSize(field.mBlockName, blocknum, field.mVarName);
+}
+
+
 S32 LLMessageSystem::getReceiveSize() const
 {
 	return mMessageReader->getMessageSize();
@@ -162,6 +162,8 @@ class LLQuaternion;
 class LLSD;
 class LLUUID;
 class LLMessageSystem;
+class LLPacketReceiveThread;
+struct LLReceivedPacket;
 class LLPumpIO;
 
 // message system exceptional condition handlers.
@@ -188,6 +190,32 @@ class LLMessageReader;
 class LLTemplateMessageReader;
 class LLSDMessageReader;
 
+// A block and variable name pair that remembers where that variable sits in
+// the last message template it was read from, so repeated reads skip the
+// name lookups. Names are prehashed (_PREHASH_*) strings. Keep these as
+// function statics in message handlers, not globals, since the prehash
+// strings are themselves set up during static initialization.
+class LLMessageAccessor
+{
+public:
+	LLMessageAccessor(const char* blockname, const char* varname)
+	:	mBlockName(blockname),
+		mVarName(varname),
+		mTemplate(NULL),
+		mBlockIndex(-1),
+		mVarIndex(-1)
+	{
+	}
+
+	const char* mBlockName;
+	const char* mVarName;
+
+	// Filled in by LLTemplateMessageReader
+	const LLMessageTemplate* mTemplate;
+	S32 mBlockIndex;
+	S32 mVarIndex;
+};
+
 
 
 class LLUseCircuitCodeResponder
@@ -290,6 +318,16 @@ public:
 	BOOL isOK() const { return !mbError; }
 	S32 getErrorCode() const { return mErrorCode; }
 
+	// Read and unpack packets on a separate thread. Circuit handling,
+	// decoding and handlers still run in checkMessages(). The inbound
+	// throttle and packet loss simulation in mPacketRing are bypassed.
+	// The thread does not unwrap SOCKS5 UDP packets, so it will not start
+	// while LLProxy has UDP proxying enabled and checkMessages() stops it
+	// if the proxy is enabled later.
+	void startReceiveThread();
+	void stopReceiveThread();
+	bool hasReceiveThread() const { return mReceiveThread != NULL; }
+
 	// Read file and build message templates filename must point to a
 	// valid string which specifies the path of a valid linden
 	// template.
@@ -454,6 +492,9 @@ public:
 
 	S32     zeroCode(U8 **data, S32 *data_size);
 	S32		zeroCodeExpand(U8 **data, S32 *data_size);
+	// Expands in into out, which must hold MAX_BUFFER_SIZE bytes. Returns the
+	// expanded size, errors counts writes that would have run past out.
+	static S32 zeroCodeExpand(U8* in, S32 in_size, U8* out, S32& errors);
 	S32		zeroCodeAdjustCurrentSendTotal();
 
 	// Uses ping-based retry
@@ -555,6 +596,20 @@ public:
 	void getStringFast(	const char *block, const char *var, std::string& outstr, S32 blocknum = 0);
 	void	getString(	const char *block, const char *var, std::string& outstr, S32 blocknum = 0);
 
+	// Reads through an LLMessageAccessor. Same results as the *Fast versions.
+	void	getBinaryData(LLMessageAccessor& field, void *datap, S32 size, S32 blocknum = 0, S32 max_size = S32_MAX);
+	void	getU8(		LLMessageAccessor& field, U8 &data, S32 blocknum = 0);
+	void	getU16(		LLMessageAccessor& field, U16 &data, S32 blocknum = 0);
+	void	getS32(		LLMessageAccessor& field, S32 &data, S32 blocknum = 0);
+	void	getU32(		LLMessageAccessor& field, U32 &data, S32 blocknum = 0);
+	void	getU64(		LLMessageAccessor& field, U64 &data, S32 blocknum = 0);
+	void	getF32(		LLMessageAccessor& field, F32 &data, S32 blocknum = 0);
+	void	getVector3(	LLMessageAccessor& field, LLVector3 &vec, S32 blocknum = 0);
+	void	getQuat(	LLMessageAccessor& field, LLQuaternion &q, S32 blocknum = 0);
+	void	getUUID(	LLMessageAccessor& field, LLUUID &uuid, S32 blocknum = 0);
+	void	getString(	LLMessageAccessor& field, std::string& outstr, S32 blocknum = 0);
+	S32		getSize(	LLMessageAccessor& field, S32 blocknum);
+
 
 	// Utility functions to generate a replay-resistant digest check
 	// against the shared secret. The window specifies how much of a
@@ -777,6 +832,10 @@ private:
 	U8	mTrueReceiveBuffer[MAX_BUFFER_SIZE];
 	S32	mTrueReceiveSize;
 
+	LLPacketReceiveThread*	mReceiveThread;
+	LLReceivedPacket*		mReceivedPacket;	// packet being processed, from mReceiveThread
+	void releaseReceivedPacket();
+
 	// Must be valid during decode
 	
 	BOOL	mbError;
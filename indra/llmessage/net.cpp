@@ -523,12 +523,30 @@ void end_net(S32& socket_out)
 }
 
 #if LL_LINUX
+static void get_pktinfo_destip( struct msghdr *msg, U32 *dstip )
+{
+	struct cmsghdr *cmsgptr;
+	for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR( msg, cmsgptr))
+	{
+		if( cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO )
+		{
+			in_pktinfo *pktinfo = (in_pktinfo *)CMSG_DATA(cmsgptr);
+			if( pktinfo )
+			{
+				// Two choices. routed and specified. ipi_addr is routed, ipi_spec_dst is
+				// routed. We should stay with specified until we go to multiple
+				// interfaces
+				*dstip = pktinfo->ipi_spec_dst.s_addr;
+			}
+		}
+	}
+}
+
 static int recvfrom_destip( int socket, void *buf, int len, struct sockaddr *from, socklen_t *fromlen, U32 *dstip )
 {
 	int size;
 	struct iovec iov[1];
 	char cmsg[CMSG_SPACE(sizeof(struct in_pktinfo))];
-	struct cmsghdr *cmsgptr;
 	struct msghdr msg = {0};
 
 	iov[0].iov_base = buf;
@@ -549,20 +567,7 @@ static int recvfrom_destip( int socket, void *buf, int len, struct sockaddr *fro
 		return -1;
 	}
 
-	for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != NULL; cmsgptr = CMSG_NXTHDR( &msg, cmsgptr))
-	{
-		if( cmsgptr->cmsg_level == SOL_IP && cmsgptr->cmsg_type == IP_PKTINFO )
-		{
-			in_pktinfo *pktinfo = (in_pktinfo *)CMSG_DATA(cmsgptr);
-			if( pktinfo )
-			{
-				// Two choices. routed and specified. ipi_addr is routed, ipi_spec_dst is
-				// routed. We should stay with specified until we go to multiple
-				// interfaces
-				*dstip = pktinfo->ipi_spec_dst.s_addr;
-			}
-		}
-	}
+	get_pktinfo_destip(&msg, dstip);
 
 	return size;
 }
@@ -660,4 +665,141 @@ BOOL send_packet(int hSocket, const char * sendBuffer, int size, U32 recipient,
 
 #endif
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Batched I/O
+//////////////////////////////////////////////////////////////////////////////////////////
+
+#if LL_LINUX
+
+// Upper bound on packets per recvmmsg()/sendmmsg() call, keeps the headers on the stack.
+const S32 NET_MAX_BATCH = 64;
+
+S32 receive_packets(int hSocket, LLNetPacket* packets, S32 count)
+{
+	struct mmsghdr msgs[NET_MAX_BATCH];
+	struct iovec iovs[NET_MAX_BATCH];
+	struct sockaddr_in addrs[NET_MAX_BATCH];
+	char cmsgs[NET_MAX_BATCH][CMSG_SPACE(sizeof(struct in_pktinfo))];
+
+	count = llmin(count, NET_MAX_BATCH);
+	if (count <= 0)
+	{
+		return 0;
+	}
+
+	memset(msgs, 0, sizeof(msgs[0]) * count);
+	for (S32 i = 0; i < count; ++i)
+	{
+		iovs[i].iov_base = packets[i].mData;
+		iovs[i].iov_len = NET_BUFFER_SIZE;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_control = cmsgs[i];
+		msgs[i].msg_hdr.msg_controllen = sizeof(cmsgs[i]);
+	}
+
+	int received = recvmmsg(hSocket, msgs, count, MSG_DONTWAIT, NULL);
+	if (received <= 0)
+	{
+		// Same as receive_packet(), errors read as no data.
+		return 0;
+	}
+
+	for (S32 i = 0; i < received; ++i)
+	{
+		LLNetPacket& packet = packets[i];
+		packet.mSize = msgs[i].msg_len;
+		packet.mIP = addrs[i].sin_addr.s_addr;
+		packet.mPort = ntohs(addrs[i].sin_port);
+		packet.mReceivingIF = INVALID_HOST_IP_ADDRESS;
+		get_pktinfo_destip(&msgs[i].msg_hdr, &packet.mReceivingIF);
+	}
+	return received;
+}
+
+S32 send_packets(int hSocket, const LLNetPacket* packets, S32 count)
+{
+	struct mmsghdr msgs[NET_MAX_BATCH];
+	struct iovec iovs[NET_MAX_BATCH];
+	struct sockaddr_in addrs[NET_MAX_BATCH];
+
+	S32 sent = 0;
+	S32 done = 0;
+	while (done < count)
+	{
+		S32 batch = llmin(count - done, NET_MAX_BATCH);
+		memset(msgs, 0, sizeof(msgs[0]) * batch);
+		memset(addrs, 0, sizeof(addrs[0]) * batch);
+		for (S32 i = 0; i < batch; ++i)
+		{
+			const LLNetPacket& packet = packets[done + i];
+			iovs[i].iov_base = packet.mData;
+			iovs[i].iov_len = packet.mSize;
+			addrs[i].sin_family = AF_INET;
+			addrs[i].sin_addr.s_addr = packet.mIP;
+			addrs[i].sin_port = htons(packet.mPort);
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		int ret = sendmmsg(hSocket, msgs, batch, 0);
+		if (ret > 0)
+		{
+			sent += ret;
+			done += ret;
+		}
+		else
+		{
+			// The first packet failed, let send_packet() retry and log it.
+			const LLNetPacket& packet = packets[done];
+			if (send_packet(hSocket, packet.mData, packet.mSize, packet.mIP, packet.mPort))
+			{
+				++sent;
+			}
+			++done;
+		}
+	}
+	return sent;
+}
+
+#else
+
+S32 receive_packets(int hSocket, LLNetPacket* packets, S32 count)
+{
+	S32 received = 0;
+	while (received < count)
+	{
+		LLNetPacket& packet = packets[received];
+		packet.mSize = receive_packet(hSocket, packet.mData);
+		if (packet.mSize <= 0)
+		{
+			break;
+		}
+		packet.mIP = get_sender_ip();
+		packet.mPort = get_sender_port();
+		packet.mReceivingIF = get_receiving_interface_ip();
+		++received;
+	}
+	return received;
+}
+
+S32 send_packets(int hSocket, const LLNetPacket* packets, S32 count)
+{
+	S32 sent = 0;
+	for (S32 i = 0; i < count; ++i)
+	{
+		if (send_packet(hSocket, packets[i].mData, packets[i].mSize, packets[i].mIP, packets[i].mPort))
+		{
+			++sent;
+		}
+	}
+	return sent;
+}
+
+#endif
+
 //EOF
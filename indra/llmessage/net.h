@@ -45,6 +45,26 @@ S32		receive_packet(int hSocket, char * receiveBuffer);
 
 BOOL	send_packet(int hSocket, const char *sendBuffer, int size, U32 recipient, int nPort);	// Returns TRUE on success.
 
+// One datagram for the batched calls below. mData must hold NET_BUFFER_SIZE
+// bytes when receiving.
+struct LLNetPacket
+{
+	char*	mData;
+	S32		mSize;
+	U32		mIP;				// sender when receiving, recipient when sending
+	U32		mPort;
+	U32		mReceivingIF;		// receive only
+};
+
+// Batched versions of receive_packet() and send_packet(). On Linux these are
+// single recvmmsg()/sendmmsg() calls, elsewhere they loop over the single
+// packet calls. Use the per packet fields rather than get_sender() and
+// get_receiving_interface() afterwards.
+// receive_packets() returns the number of packets read, 0 if none are waiting.
+// send_packets() returns the number of packets sent successfully.
+S32		receive_packets(int hSocket, LLNetPacket* packets, S32 count);
+S32		send_packets(int hSocket, const LLNetPacket* packets, S32 count);
+
 //void	get_sender(char * tmp);
 LLHost	get_sender();
 U32		get_sender_port();
@@ -29,12 +29,89 @@
 
 #include "../llavatarnamecache.h"
 
+#include <fstream>
+#include <iterator>
+
+#include "lldate.h"
+#include "llfile.h"
+#include "llframetimer.h"
+#include "llsd.h"
+#include "lluuid.h"
+
 #include "../test/lltut.h"
+#include "../test/namedtempfile.h"
 
 namespace tut
 {
 	struct avatarnamecache_data
 	{
+		avatarnamecache_data() :
+			mPlaceholder("avnames", ""),
+			mFilename(mPlaceholder.getName() + ".bin")
+		{
+			mAgentA.generate();
+			mAgentB.generate();
+			// Immediate lookups only work once the cache is running.
+			LLAvatarNameCache::idle();
+		}
+
+		~avatarnamecache_data()
+		{
+			LLAvatarNameCache::cleanupClass();
+			LLFile::remove(mFilename, ENOENT);
+		}
+
+		LLAvatarName makeName(const std::string& first, const std::string& last)
+		{
+			LLSD sd;
+			sd["username"] = first + "." + last;
+			sd["display_name"] = first + " " + last;
+			sd["legacy_first_name"] = first;
+			sd["legacy_last_name"] = last;
+			sd["display_name_expires"] = LLDate(LLFrameTimer::getTotalSeconds() + 3600.0);
+			LLAvatarName av_name;
+			av_name.fromLLSD(sd);
+			return av_name;
+		}
+
+		void ensureName(const std::string& msg, const LLUUID& agent_id, const LLAvatarName& expected)
+		{
+			LLAvatarName av_name;
+			ensure(msg + " found", LLAvatarNameCache::get(agent_id, &av_name));
+			ensure_equals(msg + " username", av_name.getAccountName(), expected.getAccountName());
+			ensure_equals(msg + " display name", av_name.getDisplayName(true), expected.getDisplayName(true));
+			ensure_equals(msg + " expires", av_name.mExpires, expected.mExpires);
+		}
+
+		void ensureNoName(const std::string& msg, const LLUUID& agent_id)
+		{
+			LLAvatarName av_name;
+			ensure(msg, !LLAvatarNameCache::get(agent_id, &av_name));
+		}
+
+		// Drops what is in memory and loads the file again.
+		bool reload()
+		{
+			LLAvatarNameCache::cleanupClass();
+			return LLAvatarNameCache::loadCacheFile(mFilename);
+		}
+
+		std::string readFile()
+		{
+			std::ifstream in(mFilename.c_str(), std::ios::binary);
+			return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		}
+
+		void writeFile(const std::string& data)
+		{
+			std::ofstream out(mFilename.c_str(), std::ios::binary | std::ios::trunc);
+			out.write(data.data(), data.size());
+		}
+
+		NamedTempFile mPlaceholder;
+		std::string mFilename;
+		LLUUID mAgentA;
+		LLUUID mAgentB;
 	};
 	typedef test_group<avatarnamecache_data> avatarnamecache_test;
 	typedef avatarnamecache_test::object avatarnamecache_object;
@@ -99,4 +176,125 @@ namespace tut
 		valid = max_age_from_cache_control("max-age=-123", &max_age);
 		ensure("less than zero max-age is invalid", !valid);
 	}
+
+	template<> template<>
+	void avatarnamecache_object::test<3>()
+	{
+		set_test_name("cache file round trip");
+		ensure("no file yet", !LLAvatarNameCache::loadCacheFile(mFilename));
+		LLAvatarName name_a = makeName("Alice", "Tester");
+		LLAvatarName name_b = makeName("Bob", "Tester");
+		LLAvatarNameCache::insert(mAgentA, name_a);
+		LLAvatarNameCache::insert(mAgentB, name_b);
+		LLAvatarNameCache::saveCacheFile();
+
+		ensure("reloaded", reload());
+		ensureName("A", mAgentA, name_a);
+		ensureName("B", mAgentB, name_b);
+	}
+
+	template<> template<>
+	void avatarnamecache_object::test<4>()
+	{
+		set_test_name("truncated and corrupt cache files");
+		LLAvatarNameCache::loadCacheFile(mFilename);
+		LLAvatarName name_a = makeName("Alice", "Tester");
+		LLAvatarName name_b = makeName("Bob", "Tester");
+		LLAvatarNameCache::insert(mAgentA, name_a);
+		LLAvatarNameCache::saveCacheFile();
+		const std::string one_name = readFile();
+		LLAvatarNameCache::insert(mAgentB, name_b);
+		LLAvatarNameCache::saveCacheFile();
+
+		// B was appended after A, cut it short as a crash mid-append would.
+		std::string torn = readFile();
+		ensure("appended", torn.size() > one_name.size() + 5);
+		torn.resize(torn.size() - 5);
+		writeFile(torn);
+		ensure("torn file loads", reload());
+		ensureName("A from torn file", mAgentA, name_a);
+		ensureNoName("torn B dropped", mAgentB);
+
+		// The next save rewrites the file without the torn record.
+		LLAvatarNameCache::saveCacheFile();
+		ensure_equals("rewritten", readFile(), one_name);
+
+		writeFile("");
+		ensure("empty file rejected", !reload());
+		ensureNoName("nothing from empty file", mAgentA);
+
+		std::string bad_magic = one_name;
+		bad_magic[0] = 'X';
+		writeFile(bad_magic);
+		ensure("bad magic rejected", !reload());
+		ensureNoName("nothing from bad magic", mAgentA);
+
+		// A record claiming more data than the file holds is torn too.
+		std::string bad_size = one_name;
+		bad_size[8] = 0x7f;		// high byte of the first record's size
+		writeFile(bad_size);
+		ensure("short record loads", reload());
+		ensureNoName("short record dropped", mAgentA);
+	}
+
+	template<> template<>
+	void avatarnamecache_object::test<5>()
+	{
+		set_test_name("append then rewrite");
+		LLAvatarNameCache::loadCacheFile(mFilename);
+		LLAvatarName name_a = makeName("Alice", "Tester");
+		LLAvatarName name_b = makeName("Bob", "Tester");
+		LLAvatarNameCache::insert(mAgentA, name_a);
+		LLAvatarNameCache::saveCacheFile();
+		const std::string first = readFile();
+
+		// New and erased names are appended, what is there stays put.
+		LLAvatarNameCache::insert(mAgentB, name_b);
+		LLAvatarNameCache::saveCacheFile();
+		LLAvatarNameCache::erase(mAgentA);
+		LLAvatarNameCache::saveCacheFile();
+		const std::string appended = readFile();
+		ensure("appended", appended.size() > first.size());
+		ensure_equals("earlier records kept", appended.substr(0, first.size()), first);
+
+		ensure("reloaded", reload());
+		ensureNoName("erased A", mAgentA);
+		ensureName("B", mAgentB, name_b);
+
+		// Three records for one live name, the next save starts over.
+		LLAvatarName name_b2 = makeName("Bobby", "Tester");
+		LLAvatarNameCache::insert(mAgentB, name_b2);
+		LLAvatarNameCache::saveCacheFile();
+		const std::string rewritten = readFile();
+		ensure("rewritten smaller", rewritten.size() < appended.size());
+		ensure_equals("same magic", rewritten.substr(0, 8), first.substr(0, 8));
+
+		ensure("reloaded rewrite", reload());
+		ensureNoName("A still erased", mAgentA);
+		ensureName("B renamed", mAgentB, name_b2);
+	}
+
+	template<> template<>
+	void avatarnamecache_object::test<6>()
+	{
+		set_test_name("file removed between saves");
+		LLAvatarNameCache::loadCacheFile(mFilename);
+		LLAvatarName name_a = makeName("Alice", "Tester");
+		LLAvatarName name_b = makeName("Bob", "Tester");
+		LLAvatarNameCache::insert(mAgentA, name_a);
+		LLAvatarNameCache::saveCacheFile();
+		const std::string first = readFile();
+
+		// Clearing the cache deletes the file under a running session, the
+		// next save must not leave records without the magic.
+		LLFile::remove(mFilename);
+		LLAvatarNameCache::insert(mAgentB, name_b);
+		LLAvatarNameCache::saveCacheFile();
+		const std::string written = readFile();
+		ensure_equals("magic", written.substr(0, 8), first.substr(0, 8));
+
+		ensure("reloaded", reload());
+		ensureName("A", mAgentA, name_a);
+		ensureName("B", mAgentB, name_b);
+	}
 }
@@ -0,0 +1,158 @@
+/**
+ * @file llpacketreceivethread_test.cpp
+ * @brief LLPacketReceiveThread loopback tests.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llpacketreceivethread.h"
+#include "../message.h"
+#include "../net.h"
+#include "lltimer.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct receivethread_data
+	{
+		receivethread_data() :
+			mReceiveSocket(-1),
+			mSendSocket(-1),
+			mReceivePort(NET_USE_OS_ASSIGNED_PORT),
+			mSendPort(NET_USE_OS_ASSIGNED_PORT)
+		{
+			start_net(mReceiveSocket, mReceivePort);
+			start_net(mSendSocket, mSendPort);
+			mLoopback = ip_string_to_u32(LOOPBACK_ADDRESS_STRING);
+		}
+
+		~receivethread_data()
+		{
+			end_net(mSendSocket);
+			end_net(mReceiveSocket);
+		}
+
+		// Packet i has no flags and a body of 50 + i bytes of the value i.
+		S32 fill(U8* buf, S32 i)
+		{
+			S32 size = 50 + i;
+			memset(buf, i, size);
+			buf[0] = 0;
+			return size;
+		}
+
+		// Waits up to five seconds for the next packet.
+		LLReceivedPacket* waitForPacket(LLPacketReceiveThread& thread)
+		{
+			LLTimer timer;
+			LLReceivedPacket* packetp = NULL;
+			while (!(packetp = thread.popPacket()) && timer.getElapsedTimeF32() < 5.f)
+			{
+				ms_sleep(1);
+			}
+			return packetp;
+		}
+
+		S32 mReceiveSocket;
+		S32 mSendSocket;
+		int mReceivePort;
+		int mSendPort;
+		U32 mLoopback;
+	};
+	typedef test_group<receivethread_data> receivethread_test;
+	typedef receivethread_test::object receivethread_object;
+	tut::receivethread_test receivethread_testcase("LLPacketReceiveThread");
+
+	template<> template<>
+	void receivethread_object::test<1>()
+	{
+		set_test_name("start, receive and stop");
+		ensure("sockets", mReceiveSocket >= 0 && mSendSocket >= 0);
+		LLPacketReceiveThread thread(mReceiveSocket);
+		thread.start();
+
+		const S32 COUNT = 100;
+		U8 buf[NET_BUFFER_SIZE];
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			S32 size = fill(buf, i);
+			send_packet(mSendSocket, (char*)buf, size, mLoopback, mReceivePort);
+		}
+
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			LLReceivedPacket* packetp = waitForPacket(thread);
+			ensure("packet arrived", packetp != NULL);
+			ensure_equals("size", packetp->mSize, 50 + i);
+			ensure_equals("body size", packetp->mBodySize, 50 + i);
+			ensure("body", packetp->mBodyp == packetp->mData);
+			ensure_equals("data", (S32)packetp->mData[packetp->mSize - 1], i);
+			ensure_equals("acks", packetp->mAckCount, 0);
+			ensure_equals("sender address", packetp->mSender.getAddress(), mLoopback);
+			ensure_equals("sender port", packetp->mSender.getPort(), (U32)mSendPort);
+			thread.releasePacket(packetp);
+		}
+		ensure("no extra packets", thread.popPacket() == NULL);
+
+		thread.shutdown();
+		ensure("stopped", thread.isStopped());
+	}
+
+	template<> template<>
+	void receivethread_object::test<2>()
+	{
+		set_test_name("appended acks are split off");
+		LLPacketReceiveThread thread(mReceiveSocket);
+		thread.start();
+
+		U8 buf[NET_BUFFER_SIZE];
+		S32 size = fill(buf, 10);
+		buf[0] = LL_ACK_FLAG;
+		const S32 ACKS = 3;
+		for (S32 i = 0; i < ACKS; ++i)
+		{
+			U32 packet_id = htonl(1000 + i);
+			memcpy(&buf[size], &packet_id, sizeof(TPACKETID));
+			size += sizeof(TPACKETID);
+		}
+		buf[size++] = ACKS;
+		send_packet(mSendSocket, (char*)buf, size, mLoopback, mReceivePort);
+
+		LLReceivedPacket* packetp = waitForPacket(thread);
+		ensure("packet arrived", packetp != NULL);
+		ensure_equals("size", packetp->mSize, size);
+		ensure_equals("body size", packetp->mBodySize, 60);
+		ensure_equals("acks", packetp->mAckCount, ACKS);
+		// Acks are read from the end, last one first.
+		for (S32 i = 0; i < ACKS; ++i)
+		{
+			ensure_equals("ack", packetp->mAcks[i], (TPACKETID)(1000 + ACKS - 1 - i));
+		}
+		thread.releasePacket(packetp);
+
+		thread.shutdown();
+		ensure("stopped", thread.isStopped());
+	}
+}
@@ -0,0 +1,197 @@
+/**
+ * @file llpacketring_test.cpp
+ * @brief LLPacketRing batched I/O tests.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llpacketring.h"
+#include "../net.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct packetring_data
+	{
+		packetring_data() :
+			mReceiveSocket(-1),
+			mSendSocket(-1),
+			mReceivePort(NET_USE_OS_ASSIGNED_PORT),
+			mSendPort(NET_USE_OS_ASSIGNED_PORT)
+		{
+			start_net(mReceiveSocket, mReceivePort);
+			start_net(mSendSocket, mSendPort);
+			mLoopback = ip_string_to_u32(LOOPBACK_ADDRESS_STRING);
+		}
+
+		~packetring_data()
+		{
+			end_net(mSendSocket);
+			end_net(mReceiveSocket);
+		}
+
+		// Packet i is 50 + i bytes of the value i.
+		void fill(char* buf, S32 i)
+		{
+			memset(buf, i, 50 + i);
+		}
+
+		void ensureReceived(LLPacketRing& ring, S32 count)
+		{
+			char buf[NET_BUFFER_SIZE];
+			S32 got = 0;
+			S32 size;
+			while ((size = ring.receivePacket(mReceiveSocket, buf)))
+			{
+				ensure_equals("size", size, 50 + got);
+				ensure_equals("data", (S32)(U8)buf[size - 1], got);
+				ensure_equals("sender", ring.getLastSender().getPort(), (U32)mSendPort);
+				++got;
+			}
+			ensure_equals("count", got, count);
+		}
+
+		S32 mReceiveSocket;
+		S32 mSendSocket;
+		int mReceivePort;
+		int mSendPort;
+		U32 mLoopback;
+	};
+	typedef test_group<packetring_data> packetring_test;
+	typedef packetring_test::object packetring_object;
+	tut::packetring_test packetring_testcase("LLPacketRing");
+
+	template<> template<>
+	void packetring_object::test<1>()
+	{
+		set_test_name("batched receive");
+		ensure("sockets", mReceiveSocket >= 0 && mSendSocket >= 0);
+		char buf[NET_BUFFER_SIZE];
+		for (S32 i = 0; i < 100; ++i)
+		{
+			fill(buf, i);
+			send_packet(mSendSocket, buf, 50 + i, mLoopback, mReceivePort);
+		}
+		LLPacketRing ring;
+		ensureReceived(ring, 100);
+	}
+
+	template<> template<>
+	void packetring_object::test<2>()
+	{
+		set_test_name("batched send");
+		LLPacketRing ring;
+		char buf[NET_BUFFER_SIZE];
+		ring.beginSendBatch();
+		for (S32 i = 0; i < 100; ++i)
+		{
+			fill(buf, i);
+			ensure("queued", ring.sendPacket(mSendSocket, buf, 50 + i, LLHost(mLoopback, mReceivePort)));
+		}
+		ensure_equals("failures", ring.flushSendBatch(), 0);
+		ensureReceived(ring, 100);
+	}
+
+	template<> template<>
+	void packetring_object::test<3>()
+	{
+		set_test_name("loopback flood");
+		// Bursts larger than one I/O batch, sent and received through the
+		// ring, every packet has to come back once, in order and intact.
+		const S32 ROUNDS = 50;
+		const S32 BURST = 69;
+		const S32 SIZE = 120;
+		char buf[NET_BUFFER_SIZE];
+		LLHost dest(mLoopback, mReceivePort);
+		LLPacketRing ring;
+		U32 sent = 0;
+		U32 expected = 0;
+		for (S32 round = 0; round < ROUNDS; ++round)
+		{
+			ring.beginSendBatch();
+			for (S32 i = 0; i < BURST; ++i)
+			{
+				memset(buf, (U8)sent, SIZE);
+				memcpy(buf, &sent, sizeof(sent));
+				ensure("queued", ring.sendPacket(mSendSocket, buf, SIZE, dest));
+				++sent;
+			}
+			ensure_equals("failures", ring.flushSendBatch(), 0);
+
+			S32 size;
+			while ((size = ring.receivePacket(mReceiveSocket, buf)))
+			{
+				U32 sequence = 0;
+				memcpy(&sequence, buf, sizeof(sequence));
+				ensure_equals("sequence", sequence, expected);
+				ensure_equals("size", size, SIZE);
+				ensure_equals("payload", (U8)buf[SIZE - 1], (U8)expected);
+				ensure_equals("sender address", ring.getLastSender().getAddress(), mLoopback);
+				ensure_equals("sender port", ring.getLastSender().getPort(), (U32)mSendPort);
+				++expected;
+			}
+			ensure_equals("received", expected, sent);
+		}
+	}
+
+	template<> template<>
+	void packetring_object::test<4>()
+	{
+		set_test_name("receive_packets batch bound");
+		const S32 COUNT = 100;
+		const S32 BATCH = 32;
+		char buf[NET_BUFFER_SIZE];
+		for (S32 i = 0; i < COUNT; ++i)
+		{
+			fill(buf, i);
+			send_packet(mSendSocket, buf, 50 + i, mLoopback, mReceivePort);
+		}
+
+		std::vector<char> storage(BATCH * NET_BUFFER_SIZE);
+		LLNetPacket batch[BATCH];
+		for (S32 i = 0; i < BATCH; ++i)
+		{
+			batch[i].mData = &storage[i * NET_BUFFER_SIZE];
+		}
+
+		S32 got = 0;
+		S32 calls = 0;
+		S32 received;
+		while ((received = receive_packets(mReceiveSocket, batch, BATCH)))
+		{
+			ensure("within batch", received > 0 && received <= BATCH);
+			for (S32 i = 0; i < received; ++i, ++got)
+			{
+				ensure_equals("size", batch[i].mSize, 50 + got);
+				ensure_equals("data", (S32)(U8)batch[i].mData[batch[i].mSize - 1], got);
+				ensure_equals("sender", batch[i].mPort, (U32)mSendPort);
+			}
+			++calls;
+		}
+		ensure_equals("count", got, COUNT);
+		// Everything was waiting, so each call should fill the batch.
+		ensure_equals("calls", calls, (COUNT + BATCH - 1) / BATCH);
+	}
+}
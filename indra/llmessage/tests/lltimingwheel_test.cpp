@@ -0,0 +1,115 @@
+/**
+ * @file lltimingwheel_test.cpp
+ * @brief LLTimingWheel tests.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include <algorithm>
+
+#include "../lltimingwheel.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct timingwheel_data
+	{
+		timingwheel_data() :
+			mWheel(F64Seconds(0.05), 16)
+		{
+		}
+
+		std::vector<S32> collect(F64 now)
+		{
+			std::vector<S32> due;
+			mWheel.collectDue(F64Seconds(now), due);
+			std::sort(due.begin(), due.end());
+			return due;
+		}
+
+		LLTimingWheel<S32> mWheel;
+	};
+	typedef test_group<timingwheel_data> timingwheel_test;
+	typedef timingwheel_test::object timingwheel_object;
+	tut::timingwheel_test timingwheel_testcase("LLTimingWheel");
+
+	template<> template<>
+	void timingwheel_object::test<1>()
+	{
+		set_test_name("due in order of deadline");
+		collect(100.0);
+		mWheel.schedule(1, F64Seconds(100.12));
+		mWheel.schedule(2, F64Seconds(100.30));
+		mWheel.schedule(3, F64Seconds(100.31));
+		ensure_equals("scheduled", mWheel.size(), 3U);
+
+		ensure("nothing early", collect(100.12).empty());
+		std::vector<S32> due = collect(100.125);
+		ensure("first due", due.size() == 1 && due[0] == 1);
+		ensure("none between", collect(100.2).empty());
+		due = collect(100.5);
+		ensure("rest due", due.size() == 2 && due[0] == 2 && due[1] == 3);
+		ensure("empty", mWheel.empty());
+	}
+
+	template<> template<>
+	void timingwheel_object::test<2>()
+	{
+		set_test_name("deadlines beyond a revolution");
+		// 16 slots of 50 ms is 0.8 s a revolution.
+		collect(10.0);
+		mWheel.schedule(1, F64Seconds(10.1));
+		mWheel.schedule(2, F64Seconds(10.1 + 0.8));
+		mWheel.schedule(3, F64Seconds(10.1 + 2.4));
+
+		std::vector<S32> due = collect(10.2);
+		ensure("only first revolution", due.size() == 1 && due[0] == 1);
+		for (F64 now = 10.25; now < 10.9; now += 0.05)
+		{
+			ensure("second waits", collect(now).empty());
+		}
+		due = collect(11.0);
+		ensure("second due", due.size() == 1 && due[0] == 2);
+
+		// A long gap between calls still finds everything due.
+		due = collect(20.0);
+		ensure("third due", due.size() == 1 && due[0] == 3);
+		ensure("empty", mWheel.empty());
+	}
+
+	template<> template<>
+	void timingwheel_object::test<3>()
+	{
+		set_test_name("already due and clear");
+		collect(5.0);
+		mWheel.schedule(1, F64Seconds(4.0));
+		std::vector<S32> due = collect(5.01);
+		ensure("past deadline due next call", due.size() == 1 && due[0] == 1);
+
+		mWheel.schedule(2, F64Seconds(5.5));
+		mWheel.clear();
+		ensure("cleared", mWheel.empty() && collect(6.0).empty());
+	}
+}
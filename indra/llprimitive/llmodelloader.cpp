@@ -25,7 +25,7 @@
  */
 
 #include "llmodelloader.h"
-#include "llsdserialize.h"
+#include "llsdbinaryview.h"
 #include "lljoint.h"
 #include "llcallbacklist.h"
 
@@ -216,12 +216,22 @@ bool LLModelLoader::loadFromSLM(const std::string& filename)
 	}
 
 	S32 file_size = (S32) stat.st_size;
-	
+	if (file_size <= 0)
+	{
+		return false;
+	}
+
+	// The mesh entries hold whole mesh assets, so the file can run to many
+	// megabytes. Read it through a view instead of parsing it into an LLSD:
+	// each mesh string is copied out only when a model is built from it.
+	std::vector<U8> buffer(file_size);
 	llifstream ifstream(filename.c_str(), std::ifstream::in | std::ifstream::binary);
-	LLSD data;
-	LLSDSerialize::fromBinary(data, ifstream, file_size);
+	ifstream.read((char*)&buffer[0], file_size);
+	S32 bytes_read = (S32) ifstream.gcount();
 	ifstream.close();
 
+	LLSDBinaryView data(&buffer[0], bytes_read);
+
 	//build model list for each LoD
 	model_list model[LLModel::NUM_LODS];
 
@@ -230,14 +240,14 @@ bool LLModelLoader::loadFromSLM(const std::string& filename)
 		return false;
 	}
 
-	LLSD& mesh = data["mesh"];
+	LLSDBinaryView mesh = data["mesh"];
 
 	LLVolumeParams volume_params;
 	volume_params.setType(LL_PCODE_PROFILE_SQUARE, LL_PCODE_PATH_LINE);
 
 	for (S32 lod = 0; lod < LLModel::NUM_LODS; ++lod)
 	{
-		for (U32 i = 0; i < mesh.size(); ++i)
+		for (S32 i = 0; i < mesh.size(); ++i)
 		{
 			std::stringstream str(mesh[i].asString());
 			LLPointer<LLModel> loaded_model = new LLModel(volume_params, (F32) lod);
@@ -270,12 +280,13 @@ bool LLModelLoader::loadFromSLM(const std::string& filename)
 	//load instance list
 	model_instance_list instance_list;
 
-	LLSD& instance = data["instance"];
+	LLSDBinaryView instance = data["instance"];
 
-	for (U32 i = 0; i < instance.size(); ++i)
+	for (S32 i = 0; i < instance.size(); ++i)
 	{
 		//deserialize instance list
-		instance_list.push_back(LLModelInstance(instance[i]));
+		LLSD instance_data = instance[i].asLLSD();
+		instance_list.push_back(LLModelInstance(instance_data));
 
 		//match up model instance pointers
 		S32 idx = instance_list[i].mLocalMeshID;
@@ -324,7 +335,7 @@ bool LLModelLoader::loadFromSLM(const std::string& filename)
 	}
 
 	// Set name for UI to use
-	std::string name = data["name"];
+	std::string name = data["name"].asString();
 	if (!name.empty())
 	{
 		model[LLModel::LOD_HIGH][0]->mRequestedLabel = name;
@@ -40,6 +40,9 @@
 #else
 #include <sys/file.h>
 #endif
+#if !LL_WINDOWS
+#include <unistd.h>	// pread(), pwrite()
+#endif
     
 #include "llstl.h"
 #include "lltimer.h"
@@ -123,6 +126,7 @@ public:
 		mSize = 0;
 		mIndexLocation = -1;
 		mAccessTime = (U32)time(NULL);
+		mReaders = 0;
 
 		for (S32 i = 0; i < (S32)VFSLOCK_COUNT; i++)
 		{
@@ -212,6 +216,7 @@ public:
 	S32  mIndexLocation; // location of index entry
 	U32  mAccessTime;
 	BOOL mLocks[VFSLOCK_COUNT]; // number of outstanding locks of each type
+	S32  mReaders; // getData() calls reading the data with mDataMutex released
     
 	static const S32 SERIAL_SIZE;
 };
@@ -251,7 +256,7 @@ LLVFS::LLVFS(const std::string& index_filename, const std::string& data_filename
 	LL_INFOS("VFS") << "Attempting to open VFS index file " << mIndexFilename << LL_ENDL;
 	LL_INFOS("VFS") << "Attempting to open VFS data file " << mDataFilename << LL_ENDL;
 
-	mDataFP = openAndLock(mDataFilename, file_mode, mReadOnly);
+	mDataFP = openDataFile(file_mode, mReadOnly);
 	if (!mDataFP)
 	{
 		if (mReadOnly)
@@ -261,7 +266,7 @@ LLVFS::LLVFS(const std::string& index_filename, const std::string& data_filename
 			return;
 		}
 
-		mDataFP = openAndLock(mDataFilename, "w+b", FALSE);
+		mDataFP = openDataFile("w+b", FALSE);
 		if (mDataFP)
 		{
 			// Since we're creating this data file, assume any index file is bogus
@@ -299,7 +304,7 @@ LLVFS::LLVFS(const std::string& index_filename, const std::string& data_filename
 			LLFile::remove(mDataFilename);
 			LLFile::remove(marker);
 
-			mDataFP = openAndLock(mDataFilename, "w+b", FALSE);
+			mDataFP = openDataFile("w+b", FALSE);
 			if (!mDataFP)
 			{
 				LL_WARNS("VFS") << "Can't open VFS data file in crash recovery" << LL_ENDL;
@@ -634,6 +639,21 @@ LLVFS * LLVFS::createLLVFS(const std::string& index_filename,
 
 
 
+LLFILE *LLVFS::openDataFile(const char* mode, BOOL read_lock)
+{
+	LLFILE *fp = openAndLock(mDataFilename, mode, read_lock);
+#if !LL_WINDOWS
+	// getData() and storeData() use pread()/pwrite() on the underlying descriptor,
+	// so stdio must not keep stale data in its own buffer. setvbuf() is only
+	// guaranteed to work before any other operation on the stream.
+	if (fp)
+	{
+		setvbuf(fp, NULL, _IONBF, 0);
+	}
+#endif
+	return fp;
+}
+
 void LLVFS::presizeDataFile(const U32 size)
 {
 	if (!mDataFP)
@@ -744,7 +764,7 @@ BOOL LLVFS::checkAvailable(S32 max_size)
 {
 	lockData();
 	
-	blocks_length_map_t::iterator iter = mFreeBlocksByLength.lower_bound(max_size); // first entry >= size
+	blocks_length_map_t::iterator iter = mFreeBlocksByLength.lower_bound(block_length_key_t(max_size, 0)); // first entry >= size
 	const BOOL res(iter == mFreeBlocksByLength.end() ? FALSE : TRUE);
 
 	unlockData();
@@ -771,12 +791,7 @@ BOOL LLVFS::setMaxSize(const LLUUID &file_id, const LLAssetType::EType file_type
 	lockData();
 	
 	LLVFSFileSpecifier spec(file_id, file_type);
-	LLVFSFileBlock *block = NULL;
-	fileblock_map::iterator it = mFileBlocks.find(spec);
-	if (it != mFileBlocks.end())
-	{
-		block = (*it).second;
-	}
+	LLVFSFileBlock *block = waitForReaders(spec);
     
 	// round all sizes upward to KB increments
 	// SJB: Need to not round for the new texture-pipeline code so we know the correct
@@ -965,6 +980,9 @@ void LLVFS::renameFile(const LLUUID &file_id, const LLAssetType::EType file_type
 	
 	LLVFSFileSpecifier new_spec(new_id, new_type);
 	LLVFSFileSpecifier old_spec(file_id, file_type);
+
+	// The target's data is freed and its block deleted below.
+	waitForReaders(new_spec);
 	
 	fileblock_map::iterator it = mFileBlocks.find(old_spec);
 	if (it != mFileBlocks.end())
@@ -1015,7 +1033,8 @@ void LLVFS::renameFile(const LLUUID &file_id, const LLAssetType::EType file_type
 	unlockData();
 }
 
-// mDataMutex must be LOCKED before calling this
+// mDataMutex must be LOCKED before calling this, and no getData() may be
+// reading the block (see waitForReaders())
 void LLVFS::removeFileBlock(LLVFSFileBlock *fileblock)
 {
 	// convert this into an unsaved, dummy fileblock to preserve locks
@@ -1052,10 +1071,9 @@ void LLVFS::removeFile(const LLUUID &file_id, const LLAssetType::EType file_type
     lockData();
 	
 	LLVFSFileSpecifier spec(file_id, file_type);
-	fileblock_map::iterator it = mFileBlocks.find(spec);
-	if (it != mFileBlocks.end())
+	LLVFSFileBlock *block = waitForReaders(spec);
+	if (block)
 	{
-		LLVFSFileBlock *block = (*it).second;
 		removeFileBlock(block);
 	}
 	else
@@ -1065,6 +1083,30 @@ void LLVFS::removeFile(const LLUUID &file_id, const LLAssetType::EType file_type
 
 	unlockData();
 }
+
+// mDataMutex must be LOCKED exactly once before calling this
+// Returns the file block for spec, or NULL if there is none, once no
+// getData() call is reading it with mDataMutex released. The lock is
+// dropped while waiting, so anything looked up before this may be stale.
+LLVFSFileBlock *LLVFS::waitForReaders(const LLVFSFileSpecifier &spec)
+{
+	while (true)
+	{
+		fileblock_map::iterator it = mFileBlocks.find(spec);
+		if (it == mFileBlocks.end())
+		{
+			return NULL;
+		}
+		LLVFSFileBlock *block = (*it).second;
+		if (!block->mReaders)
+		{
+			return block;
+		}
+		unlockData();
+		ms_sleep(1);
+		lockData();
+	}
+}
     
     
 S32 LLVFS::getData(const LLUUID &file_id, const LLAssetType::EType file_type, U8 *buffer, S32 location, S32 length)
@@ -1078,7 +1120,7 @@ S32 LLVFS::getData(const LLUUID &file_id, const LLAssetType::EType file_type, U8
 	llassert(location >= 0);
 	llassert(length >= 0);
 
-	BOOL do_read = FALSE;
+	LLVFSFileBlock *read_block = NULL;
 	
     lockData();
 	
@@ -1101,14 +1143,29 @@ S32 LLVFS::getData(const LLUUID &file_id, const LLAssetType::EType file_type, U8
 				length = block->mSize - location;
 			}
 			location += block->mLocation;
-			do_read = TRUE;
+			read_block = block;
 		}
 	}
 
-	if (do_read)
+	if (read_block)
 	{
+#if LL_WINDOWS
 		fseek(mDataFP, location, SEEK_SET);
 		bytesread = (S32)fread(buffer, 1, length, mDataFP);
+#else
+		// Count ourselves as a reader instead of holding mDataMutex during the
+		// disk read so other files can be read in parallel. findFreeBlock()
+		// skips blocks with readers, and the calls that write, move or free
+		// a file go through waitForReaders() first.
+		read_block->mReaders++;
+		unlockData();
+
+		ssize_t res = pread(fileno(mDataFP), buffer, length, location);
+		bytesread = res > 0 ? (S32)res : 0;
+
+		lockData();
+		read_block->mReaders--;
+#endif
 	}
 	
 	unlockData();
@@ -1132,11 +1189,9 @@ S32 LLVFS::storeData(const LLUUID &file_id, const LLAssetType::EType file_type,
     lockData();
     
 	LLVFSFileSpecifier spec(file_id, file_type);
-	fileblock_map::iterator it = mFileBlocks.find(spec);
-	if (it != mFileBlocks.end())
+	LLVFSFileBlock *block = waitForReaders(spec);
+	if (block)
 	{
-		LLVFSFileBlock *block = (*it).second;
-
 		S32 in_loc = location;
 		if (location == -1)
 		{
@@ -1177,8 +1232,13 @@ S32 LLVFS::storeData(const LLUUID &file_id, const LLAssetType::EType file_type,
 			}
 			U32 file_location = location + block->mLocation;
 			
+#if LL_WINDOWS
 			fseek(mDataFP, file_location, SEEK_SET);
 			S32 write_len = (S32)fwrite(buffer, 1, length, mDataFP);
+#else
+			ssize_t res = pwrite(fileno(mDataFP), buffer, length, file_location);
+			S32 write_len = res > 0 ? (S32)res : 0;
+#endif
 			if (write_len != length)
 			{
 				LL_WARNS() << llformat("VFS Write Error: %d != %d",write_len,length) << LL_ENDL;
@@ -1278,26 +1338,18 @@ BOOL LLVFS::isLocked(const LLUUID &file_id, const LLAssetType::EType file_type,
 void LLVFS::eraseBlockLength(LLVFSBlock *block)
 {
 	// find the corresponding map entry in the length map and erase it
-	S32 length = block->mLength;
-	blocks_length_map_t::iterator iter = mFreeBlocksByLength.lower_bound(length);
-	blocks_length_map_t::iterator end = mFreeBlocksByLength.end();
-	bool found_block = false;
-	while(iter != end)
-	{
-		LLVFSBlock *tblock = iter->second;
-		llassert(tblock->mLength == length); // there had -better- be an entry with our length!
-		if (tblock == block)
-		{
-			mFreeBlocksByLength.erase(iter);
-			found_block = true;
-			break;
-		}
-		++iter;
-	}
-	if(!found_block)
+	blocks_length_map_t::iterator iter = mFreeBlocksByLength.find(block_length_key_t(block->mLength, block->mLocation));
+	if (iter == mFreeBlocksByLength.end() || iter->second != block)
 	{
 		LL_ERRS() << "eraseBlock could not find block" << LL_ENDL;
 	}
+	mFreeBlocksByLength.erase(iter);
+}
+
+// Add block to the length map, block->mLength and block->mLocation must be final.
+void LLVFS::insertBlockLength(LLVFSBlock *block)
+{
+	mFreeBlocksByLength.insert(blocks_length_map_t::value_type(block_length_key_t(block->mLength, block->mLocation), block));
 }
 
 
@@ -1354,7 +1406,7 @@ void LLVFS::addFreeBlock(LLVFSBlock *block)
 		eraseBlockLength(prev_block);
 		eraseBlock(next_block);
 		prev_block->mLength += block->mLength + next_block->mLength;
-		mFreeBlocksByLength.insert(blocks_length_map_t::value_type(prev_block->mLength, prev_block));
+		insertBlockLength(prev_block);
 		delete block;
 		block = NULL;
 		delete next_block;
@@ -1367,7 +1419,7 @@ void LLVFS::addFreeBlock(LLVFSBlock *block)
 		// therefore only need to update the length map. JC
 		eraseBlockLength(prev_block);
 		prev_block->mLength += block->mLength;
-		mFreeBlocksByLength.insert(blocks_length_map_t::value_type(prev_block->mLength, prev_block)); // multimap insert
+		insertBlockLength(prev_block);
 		delete block;
 		block = NULL;
 	}
@@ -1381,7 +1433,7 @@ void LLVFS::addFreeBlock(LLVFSBlock *block)
 		next_block->mLength += block->mLength;
 		// Don't hint here, next_free_it iterator may be invalid.
 		mFreeBlocksByLocation.insert(blocks_location_map_t::value_type(next_block->mLocation, next_block)); // multimap insert
-		mFreeBlocksByLength.insert(blocks_length_map_t::value_type(next_block->mLength, next_block)); // multimap insert			
+		insertBlockLength(next_block);
 		delete block;
 		block = NULL;
 	}
@@ -1390,7 +1442,7 @@ void LLVFS::addFreeBlock(LLVFSBlock *block)
 		// Can't merge with other free blocks.
 		// Hint that insert should go near next_free_it.
  		mFreeBlocksByLocation.insert(next_free_it, blocks_location_map_t::value_type(block->mLocation, block)); // multimap insert
- 		mFreeBlocksByLength.insert(blocks_length_map_t::value_type(block->mLength, block)); // multimap insert
+ 		insertBlockLength(block);
 	}
 }
 
@@ -1555,7 +1607,7 @@ LLVFSBlock *LLVFS::findFreeBlock(S32 size, LLVFSFileBlock *immune)
 	while (! block)
 	{
 		// look for a suitable free block
-		blocks_length_map_t::iterator iter = mFreeBlocksByLength.lower_bound(size); // first entry >= size
+		blocks_length_map_t::iterator iter = mFreeBlocksByLength.lower_bound(block_length_key_t(size, 0)); // first entry >= size
 		if (iter != mFreeBlocksByLength.end())
 			block = iter->second;
     	
@@ -1572,6 +1624,7 @@ LLVFSBlock *LLVFS::findFreeBlock(S32 size, LLVFSFileBlock *immune)
 
 					if (tmp != immune &&
 						tmp->mLength > 0 &&
+						! tmp->mReaders &&
 						! tmp->mLocks[VFSLOCK_READ] &&
 						! tmp->mLocks[VFSLOCK_APPEND] &&
 						! tmp->mLocks[VFSLOCK_OPEN])
@@ -131,13 +131,17 @@ public:
 
 protected:
 	void removeFileBlock(LLVFSFileBlock *fileblock);
+	// Waits until getData() is not reading the file outside of the lock.
+	LLVFSFileBlock *waitForReaders(const LLVFSFileSpecifier &spec);
 	
 	void eraseBlockLength(LLVFSBlock *block);
 	void eraseBlock(LLVFSBlock *block);
 	void addFreeBlock(LLVFSBlock *block);
 	//void mergeFreeBlocks();
 	void useFreeSpace(LLVFSBlock *free_block, S32 length);
+	void insertBlockLength(LLVFSBlock *block);
 	void sync(LLVFSFileBlock *block, BOOL remove = FALSE);
+	LLFILE *openDataFile(const char* mode, BOOL read_lock);
 	void presizeDataFile(const U32 size);
 
 	static LLFILE *openAndLock(const std::string& filename, const char* mode, BOOL read_lock);
@@ -157,7 +161,10 @@ protected:
 	typedef std::map<LLVFSFileSpecifier, LLVFSFileBlock*> fileblock_map;
 	fileblock_map mFileBlocks;
 
-	typedef std::multimap<S32, LLVFSBlock*>	blocks_length_map_t;
+	// Keyed by (length, location) so a given free block can be found directly
+	// instead of scanning every free block of the same length.
+	typedef std::pair<S32, U32> block_length_key_t;
+	typedef std::map<block_length_key_t, LLVFSBlock*>	blocks_length_map_t;
 	blocks_length_map_t 	mFreeBlocksByLength;
 	typedef std::multimap<U32, LLVFSBlock*>	blocks_location_map_t;
 	blocks_location_map_t 	mFreeBlocksByLocation;
@@ -0,0 +1,187 @@
+/**
+ * @file llvfs_test.cpp
+ * @brief LLVFS tests for reads that run without the data mutex.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llvfs.h"
+#include "llapr.h"
+#include "llfile.h"
+#include "llthread.h"
+#include "lltimer.h"
+
+#include "../test/lltut.h"
+#include "../test/namedtempfile.h"
+
+namespace
+{
+	const S32 FILE_SIZE = 16 * 1024;
+	const U32 VFS_SIZE = 1024 * 1024;
+	const LLAssetType::EType FILE_TYPE = LLAssetType::AT_NOTECARD;
+
+	// Reads one file over and over. Every read has to come back empty or
+	// entirely filled with the file's own byte, never with data another
+	// file wrote into space the VFS handed out while the read was running.
+	class ReaderThread : public LLThread
+	{
+	public:
+		ReaderThread(LLVFS* vfs, const LLUUID& file_id, U8 value) :
+			LLThread("VFS reader"),
+			mVFS(vfs),
+			mFileID(file_id),
+			mValue(value)
+		{
+		}
+
+		/*virtual*/ void run()
+		{
+			std::vector<U8> buffer(FILE_SIZE);
+			while (!isQuitting())
+			{
+				S32 bytes = mVFS->getData(mFileID, FILE_TYPE, &buffer[0], 0, FILE_SIZE);
+				for (S32 i = 0; i < bytes; ++i)
+				{
+					if (buffer[i] != mValue)
+					{
+						++mBadReads;
+						break;
+					}
+				}
+				if (bytes)
+				{
+					++mReads;
+				}
+			}
+		}
+
+		LLAtomicS32 mReads;
+		LLAtomicS32 mBadReads;
+
+	private:
+		LLVFS* mVFS;
+		LLUUID mFileID;
+		U8 mValue;
+	};
+}
+
+namespace tut
+{
+	struct vfs_data
+	{
+		vfs_data() :
+			mPlaceholder("vfs", ""),
+			mIndexFilename(mPlaceholder.getName() + ".index"),
+			mDataFilename(mPlaceholder.getName() + ".data"),
+			mVFS(LLVFS::createLLVFS(mIndexFilename, mDataFilename, FALSE, VFS_SIZE, FALSE))
+		{
+			mFileA.generate();
+			mFileB.generate();
+			mFileC.generate();
+		}
+
+		~vfs_data()
+		{
+			delete mVFS;
+			LLFile::remove(mIndexFilename);
+			LLFile::remove(mDataFilename);
+		}
+
+		void write(const LLUUID& file_id, S32 size, U8 value)
+		{
+			ensure("set size", mVFS->setMaxSize(file_id, FILE_TYPE, size));
+			std::vector<U8> buffer(FILE_SIZE, value);
+			ensure_equals("stored", mVFS->storeData(file_id, FILE_TYPE, &buffer[0], 0, FILE_SIZE), FILE_SIZE);
+		}
+
+		// Runs round() until the reader has seen enough data to make the
+		// check meaningful, then stops it.
+		template <typename ROUND>
+		void race(ReaderThread& reader, ROUND round)
+		{
+			reader.start();
+			LLTimer timer;
+			S32 rounds = 0;
+			while ((rounds < 200 || reader.mReads.CurrentValue() < 200) && timer.getElapsedTimeF32() < 10.f)
+			{
+				(this->*round)();
+				++rounds;
+			}
+			reader.shutdown();
+			ensure("reader stopped", reader.isStopped());
+			ensure_equals("reads of someone else's data", reader.mBadReads.CurrentValue(), 0);
+		}
+
+		// A is removed and its space immediately reused for B.
+		void removeRound()
+		{
+			write(mFileA, FILE_SIZE, 'a');
+			mVFS->removeFile(mFileA, FILE_TYPE);
+			write(mFileB, FILE_SIZE, 'b');
+			mVFS->removeFile(mFileB, FILE_TYPE);
+		}
+
+		// C sits right after A, so growing A moves it and B takes the space
+		// A was read from.
+		void relocateRound()
+		{
+			write(mFileA, FILE_SIZE, 'a');
+			write(mFileC, FILE_SIZE, 'c');
+			ensure("grow", mVFS->setMaxSize(mFileA, FILE_TYPE, FILE_SIZE * 2));
+			write(mFileB, FILE_SIZE, 'b');
+			mVFS->removeFile(mFileA, FILE_TYPE);
+			mVFS->removeFile(mFileB, FILE_TYPE);
+			mVFS->removeFile(mFileC, FILE_TYPE);
+		}
+
+		NamedTempFile mPlaceholder;
+		std::string mIndexFilename;
+		std::string mDataFilename;
+		LLVFS* mVFS;
+		LLUUID mFileA;
+		LLUUID mFileB;
+		LLUUID mFileC;
+	};
+	typedef test_group<vfs_data> vfs_test;
+	typedef vfs_test::object vfs_object;
+	tut::vfs_test vfs_testcase("LLVFS");
+
+	template<> template<>
+	void vfs_object::test<1>()
+	{
+		set_test_name("getData racing removeFile");
+		ensure("vfs", mVFS != NULL);
+		ReaderThread reader(mVFS, mFileA, 'a');
+		race(reader, &vfs_data::removeRound);
+	}
+
+	template<> template<>
+	void vfs_object::test<2>()
+	{
+		set_test_name("getData racing setMaxSize relocation");
+		ensure("vfs", mVFS != NULL);
+		ReaderThread reader(mVFS, mFileA, 'a');
+		race(reader, &vfs_data::relocateRound);
+	}
+}
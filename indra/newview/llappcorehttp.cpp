@@ -210,6 +210,13 @@ void LLAppCoreHttp::init()
 															trace_level, NULL);
 	}
 	
+	// Keep response body blocks around for reuse by later requests
+	static const std::string http_buffer_pool("HttpBufferPoolSize");
+	if (gSavedSettings.controlExists(http_buffer_pool))
+	{
+		LLCore::BufferArray::setPoolLimit(size_t(gSavedSettings.getU32(http_buffer_pool)) * 1024 * 1024);
+	}
+	
 	// Setup default policy and constrain if directed to
 	mHttpClasses[AP_DEFAULT].mPolicy = LLCore::HttpRequest::DEFAULT_POLICY_ID;
 
@@ -367,6 +374,9 @@ void LLAppCoreHttp::cleanup()
 							<< status.toString()
 							<< LL_ENDL;
 	}
+
+	// Release pooled body blocks, any still in use are freed as they're released
+	LLCore::BufferArray::setPoolLimit(0);
 }
 
 
@@ -100,6 +100,7 @@
 #include "llavatarrenderinfoaccountant.h"
 #include "lllocalbitmaps.h"
 #include "llhmd.h"
+#include "llskeletonupdater.h"
 #include "llskinningutil.h"
 
 // Linden library includes
@@ -1977,6 +1978,7 @@ bool LLAppViewer::cleanup()
 	mAppCoreHttp.cleanup();
 
 	SUBSYSTEM_CLEANUP(LLFilePickerThread);
+	SUBSYSTEM_CLEANUP(LLSkeletonUpdater);
 
 	//MUST happen AFTER SUBSYSTEM_CLEANUP(LLCurl)
 	delete sTextureCache;
@@ -2129,7 +2131,8 @@ bool LLAppViewer::initThreads()
 	LLLFSThread::initClass(enable_threads && false);
 
 	// Image decoding
-	LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true);
+	S32 decode_threads = llclamp((S32)gSavedSettings.getU32("ImageDecodeThreads"), 1, 8);
+	LLAppViewer::sImageDecodeThread = new LLImageDecodeThread(enable_threads && true, decode_threads);
 	LLAppViewer::sTextureCache = new LLTextureCache(enable_threads && true);
 	LLAppViewer::sTextureFetch = new LLTextureFetch(LLAppViewer::getTextureCache(),
 													sImageDecodeThread,
@@ -2143,6 +2146,9 @@ bool LLAppViewer::initThreads()
 		mFastTimerLogThread->start();
 	}
 
+	// Avatar skeleton world matrices
+	LLSkeletonUpdater::initClass(llclamp((S32)gSavedSettings.getU32("AvatarSkeletonThreads"), 0, 8));
+
 	// Mesh streaming and caching
 	gMeshRepo.init();
 
@@ -4489,17 +4495,24 @@ void LLAppViewer::loadNameCache()
 {
 	// display names cache
 	std::string filename =
-		gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
+		gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.bin");
 	LL_INFOS("AvNameCache") << filename << LL_ENDL;
-	llifstream name_cache_stream(filename.c_str());
-	if(name_cache_stream.is_open())
-	{
-		if ( ! LLAvatarNameCache::importFile(name_cache_stream))
-        {
-            LL_WARNS("AppInit") << "removing invalid '" << filename << "'" << LL_ENDL;
-            name_cache_stream.close();
-            LLFile::remove(filename);
-        }
+	if (!LLAvatarNameCache::loadCacheFile(filename))
+	{
+		// Start from the XML cache earlier viewers wrote, the binary
+		// file is written from it on the next save.
+		std::string xml_filename =
+			gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
+		llifstream name_cache_stream(xml_filename.c_str());
+		if(name_cache_stream.is_open())
+		{
+			if ( ! LLAvatarNameCache::importFile(name_cache_stream))
+			{
+				LL_WARNS("AppInit") << "removing invalid '" << xml_filename << "'" << LL_ENDL;
+				name_cache_stream.close();
+				LLFile::remove(xml_filename);
+			}
+		}
 	}
 
 	if (!gCacheName) return;
@@ -4516,13 +4529,7 @@ void LLAppViewer::loadNameCache()
 void LLAppViewer::saveNameCache()
 {
 	// display names cache
-	std::string filename =
-		gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
-	llofstream name_cache_stream(filename.c_str());
-	if(name_cache_stream.is_open())
-	{
-		LLAvatarNameCache::exportFile(name_cache_stream);
-    }
+	LLAvatarNameCache::saveCacheFile();
     
     // real names cache
 	if (gCacheName)
@@ -245,6 +245,7 @@
 //     sActiveHeaderRequests    mMutex        rw.any.mMutex, ro.repo.none [1]
 //     sActiveLODRequests       mMutex        rw.any.mMutex, ro.repo.none [1]
 //     sMaxConcurrentRequests   mMutex        wo.main.none, ro.repo.none, ro.main.mMutex
+//     sBuildOctreeOnLoad       none          wo.main.none, ro.repo.none
 //     mMeshHeader              mHeaderMutex  rw.repo.mHeaderMutex, ro.main.mHeaderMutex, ro.main.none [0]
 //     mMeshHeaderSize          mHeaderMutex  rw.repo.mHeaderMutex
 //     mSkinRequests            mMutex        rw.repo.mMutex, ro.repo.none [5]
@@ -525,6 +526,7 @@ LLViewerFetchedTexture* LLMeshUploadThread::FindViewerTexture(const LLImportMate
 volatile S32 LLMeshRepoThread::sActiveHeaderRequests = 0;
 volatile S32 LLMeshRepoThread::sActiveLODRequests = 0;
 U32	LLMeshRepoThread::sMaxConcurrentRequests = 1;
+bool LLMeshRepoThread::sBuildOctreeOnLoad = true;
 S32 LLMeshRepoThread::sRequestLowWater = REQUEST2_LOW_WATER_MIN;
 S32 LLMeshRepoThread::sRequestHighWater = REQUEST2_HIGH_WATER_MIN;
 S32 LLMeshRepoThread::sRequestWaterLevel = 0;
@@ -1691,27 +1693,24 @@ bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* dat
 	U32 header_size = 0;
 	if (data_size > 0)
 	{
-		std::string res_str((char*) data, data_size);
+		static const char deprecated_header[] = "<? LLSD/Binary ?>";
+		const S32 deprecated_header_len = sizeof(deprecated_header) - 1;
 
-		std::string deprecated_header("<? LLSD/Binary ?>");
-
-		if (res_str.substr(0, deprecated_header.size()) == deprecated_header)
+		if (data_size > deprecated_header_len
+			&& !memcmp(data, deprecated_header, deprecated_header_len))
 		{
-			res_str = res_str.substr(deprecated_header.size()+1, data_size);
-			header_size = deprecated_header.size()+1;
+			header_size = deprecated_header_len + 1;
 		}
-		data_size = res_str.size();
-
-		std::istringstream stream(res_str);
 
-		if (!LLSDSerialize::fromBinary(header, stream, data_size))
+		S32 bytes_read = 0;
+		if (LLSDSerialize::fromBinary(header, data + header_size, data_size - header_size, -1, &bytes_read) <= 0)
 		{
 			LL_WARNS(LOG_MESH) << "Mesh header parse error.  Not a valid mesh asset!  ID:  " << mesh_id
 							   << LL_ENDL;
 			return false;
 		}
 
-		header_size += stream.tellg();
+		header_size += bytes_read;
 	}
 	else
 	{
@@ -1772,6 +1771,21 @@ EMeshProcessingResult LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_p
 	{
 		if (volume->getNumFaces() > 0)
 		{
+			// unpackVolumeFaces() has already cache optimized the faces,
+			// build the picking octrees here too instead of on the main
+			// thread the first time the face is raycast against.
+			if (sBuildOctreeOnLoad)
+			{
+				for (S32 i = 0; i < volume->getNumVolumeFaces(); ++i)
+				{
+					LLVolumeFace& face = volume->getVolumeFace(i);
+					if (face.mNumIndices > 0 && !face.mOctree)
+					{
+						face.createOctree();
+					}
+				}
+			}
+
 			LoadedMesh mesh(volume, mesh_params, lod);
 			{
 				LLMutexLock lock(mMutex);
@@ -1790,11 +1804,7 @@ bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 dat
 
 	if (data_size > 0)
 	{
-		std::string res_str((char*) data, data_size);
-
-		std::istringstream stream(res_str);
-
-		U32 uzip_result = LLUZipHelper::unzip_llsd(skin, stream, data_size);
+		U32 uzip_result = LLUZipHelper::unzip_llsd(skin, data, data_size);
 		if (uzip_result != LLUZipHelper::ZR_OK)
 		{
 			LL_WARNS(LOG_MESH) << "Mesh skin info parse error.  Not a valid mesh asset!  ID:  " << mesh_id
@@ -1824,11 +1834,7 @@ bool LLMeshRepoThread::decompositionReceived(const LLUUID& mesh_id, U8* data, S3
 
 	if (data_size > 0)
 	{ 
-		std::string res_str((char*) data, data_size);
-
-		std::istringstream stream(res_str);
-
-		U32 uzip_result = LLUZipHelper::unzip_llsd(decomp, stream, data_size);
+		U32 uzip_result = LLUZipHelper::unzip_llsd(decomp, data, data_size);
 		if (uzip_result != LLUZipHelper::ZR_OK)
 		{
 			LL_WARNS(LOG_MESH) << "Mesh decomposition parse error.  Not a valid mesh asset!  ID:  " << mesh_id
@@ -2906,6 +2912,7 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
 		LLCore::BufferArray * body(response->getBody());
 		S32 body_offset(0);
 		U8 * data(NULL);
+		bool data_copied(false);
 		S32 data_size(body ? body->size() : 0);
 
 		if (data_size > 0)
@@ -2958,15 +2965,22 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
 				goto common_exit;
 			}
 			
-			// *TODO: Try to get rid of data copying and add interfaces
-			// that support BufferArray directly.  Introduce a two-phase
-			// handler, optional first that takes a body, fallback second
-			// that requires a temporary allocation and data copy.
+			// Bodies with a Content-Length normally arrive in a single
+			// block which the handlers can parse in place.  Anything
+			// else takes a temporary allocation and data copy.
 			body_offset = mOffset - offset;
-			data = new(std::nothrow) U8[data_size - body_offset];
+			data = (U8 *) body->contiguousData(body_offset, data_size - body_offset);
+			if (! data)
+			{
+				data = new(std::nothrow) U8[data_size - body_offset];
+				if (data)
+				{
+					body->read(body_offset, (char *) data, data_size - body_offset);
+					data_copied = true;
+				}
+			}
 			if (data)
 			{
-				body->read(body_offset, (char *) data, data_size - body_offset);
 				LLMeshRepository::sBytesReceived += data_size;
 			}
 			else
@@ -2978,7 +2992,10 @@ void LLMeshHandlerBase::onCompleted(LLCore::HttpHandle handle, LLCore::HttpRespo
 
 		processData(body, body_offset, data, data_size - body_offset);
 
-		delete [] data;
+		if (data_copied)
+		{
+			delete [] data;
+		}
 	}
 
 	// Release handler
@@ -3534,6 +3551,7 @@ void LLMeshRepository::notifyLoadedMeshes()
               : 5);
 
     LLMeshRepoThread::sMaxConcurrentRequests = gSavedSettings.getU32("Mesh2MaxConcurrentRequests");
+    LLMeshRepoThread::sBuildOctreeOnLoad = gSavedSettings.getBOOL("MeshBuildOctreeOnLoad");
     LLMeshRepoThread::sRequestHighWater = llclamp(scale * S32(LLMeshRepoThread::sMaxConcurrentRequests),
                                                   REQUEST2_HIGH_WATER_MIN,
                                                   REQUEST2_HIGH_WATER_MAX);
@@ -3810,7 +3828,9 @@ void LLMeshRepository::notifyMeshLoaded(const LLVolumeParams& mesh_params, LLVol
 			LLVolume* sys_volume = LLPrimitive::getVolumeManager()->refVolume(mesh_params, detail);
 			if (sys_volume)
 			{
-				sys_volume->copyVolumeFaces(volume);
+				// volume is a scratch copy owned by the repo thread's
+				// LoadedMesh, take its faces rather than copying them.
+				sys_volume->swapVolumeFaces(volume);
 				sys_volume->setMeshAssetLoaded(TRUE);
 				LLPrimitive::getVolumeManager()->unrefVolume(sys_volume);
 			}
@@ -184,6 +184,7 @@ public:
 	volatile static S32 sActiveHeaderRequests;
 	volatile static S32 sActiveLODRequests;
 	static U32 sMaxConcurrentRequests;
+	static bool sBuildOctreeOnLoad;			// build picking octrees on the repo thread in lodReceived()
 	static S32 sRequestLowWater;
 	static S32 sRequestHighWater;
 	static S32 sRequestWaterLevel;			// Stats-use only, may read outside of thread
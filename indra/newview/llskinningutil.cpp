@@ -216,3 +216,89 @@ void LLSkinningUtil::getPerVertexSkinMatrix(
     llassert(valid_weights);
 }
 
+// static
+void LLSkinningUtil::applyBindShapeMatrix(LLMatrix4a* mat, U32 count, const LLMeshSkinInfo* skin)
+{
+    LLMatrix4a bind_shape;
+    bind_shape.loadu(skin->mBindShapeMatrix);
+
+    // The per vertex path only uses the affine part of the bind shape
+    // matrix, keep it that way once it is folded into the palette.
+    bind_shape.mMatrix[0].getF32ptr()[3] = 0.f;
+    bind_shape.mMatrix[1].getF32ptr()[3] = 0.f;
+    bind_shape.mMatrix[2].getF32ptr()[3] = 0.f;
+    bind_shape.mMatrix[3].getF32ptr()[3] = 1.f;
+
+    for (U32 j = 0; j < count; ++j)
+    {
+        matMul(bind_shape, mat[j], mat[j]);
+    }
+}
+
+// static
+void LLSkinningUtil::skinVertices(
+    const LLMatrix4a* mat,
+    U32 max_joints,
+    const LLVector4a* weights,
+    U32 num_vertices,
+    const LLVector4a* positions,
+    LLVector4a* dst_positions,
+    const LLVector4a* normals,
+    LLVector4a* dst_normals)
+{
+    const S32 max_joint_idx = (S32)max_joints - 1;
+    S32 idx[4];
+
+    for (U32 j = 0; j < num_vertices; ++j)
+    {
+        // Same blend as getPerVertexSkinMatrix(), four weights at a time.
+        // The integer part of each weight is the joint index and the
+        // fractional part its influence. Weights are never negative
+        // (see scrubSkinWeights()) so truncation is the same as floorf().
+        const LLVector4a& w = weights[j];
+        __m128i joints = _mm_cvttps_epi32(w);
+        _mm_storeu_si128((__m128i*)idx, joints);
+
+        LLVector4a wght;
+        wght.setSub(w, LLVector4a(_mm_cvtepi32_ps(joints)));
+
+        // This is enforced in unpackVolumeFaces()
+        LLVector4a scale;
+        scale.setAllDot4(wght, LLVector4a(1.f));
+        wght.div(scale);
+
+        const LLMatrix4a& m0 = mat[llclamp(idx[0], 0, max_joint_idx)];
+        const LLMatrix4a& m1 = mat[llclamp(idx[1], 0, max_joint_idx)];
+        const LLMatrix4a& m2 = mat[llclamp(idx[2], 0, max_joint_idx)];
+        const LLMatrix4a& m3 = mat[llclamp(idx[3], 0, max_joint_idx)];
+
+        LLVector4a w0 = _mm_shuffle_ps(wght, wght, _MM_SHUFFLE(0, 0, 0, 0));
+        LLVector4a w1 = _mm_shuffle_ps(wght, wght, _MM_SHUFFLE(1, 1, 1, 1));
+        LLVector4a w2 = _mm_shuffle_ps(wght, wght, _MM_SHUFFLE(2, 2, 2, 2));
+        LLVector4a w3 = _mm_shuffle_ps(wght, wght, _MM_SHUFFLE(3, 3, 3, 3));
+
+        LLMatrix4a final_mat;
+        for (U32 r = 0; r < 4; ++r)
+        {
+            LLVector4a t0, t1, t2, t3;
+            t0.setMul(m0.mMatrix[r], w0);
+            t1.setMul(m1.mMatrix[r], w1);
+            t2.setMul(m2.mMatrix[r], w2);
+            t3.setMul(m3.mMatrix[r], w3);
+            t0.add(t1);
+            t2.add(t3);
+            final_mat.mMatrix[r].setAdd(t0, t2);
+        }
+
+        final_mat.affineTransform(positions[j], dst_positions[j]);
+
+        if (normals)
+        {
+            LLVector4a n;
+            final_mat.rotate(normals[j], n);
+            n.normalize3fast();
+            dst_normals[j] = n;
+        }
+    }
+}
+
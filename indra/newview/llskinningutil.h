@@ -30,6 +30,7 @@
 class LLVOAvatar;
 class LLMeshSkinInfo;
 class LLMatrix4a;
+class LLVector4a;
 
 class LLSkinningUtil
 {
@@ -42,6 +43,15 @@ public:
     static void checkSkinWeights(LLVector4a* weights, U32 num_vertices, const LLMeshSkinInfo* skin);
     static void scrubSkinWeights(LLVector4a* weights, U32 num_vertices, const LLMeshSkinInfo* skin);
     static void getPerVertexSkinMatrix(F32* weights, LLMatrix4a* mat, bool handle_bad_scale, LLMatrix4a& final_mat, U32 max_joints);
+    // Fold the mesh bind shape matrix into a palette built by initSkinningMatrixPalette(),
+    // for use with skinVertices().
+    static void applyBindShapeMatrix(LLMatrix4a* mat, U32 count, const LLMeshSkinInfo* skin);
+    // Skin a whole vertex stream against a palette prepared with applyBindShapeMatrix().
+    // normals and dst_normals may be NULL.
+    static void skinVertices(const LLMatrix4a* mat, U32 max_joints,
+                             const LLVector4a* weights, U32 num_vertices,
+                             const LLVector4a* positions, LLVector4a* dst_positions,
+                             const LLVector4a* normals, LLVector4a* dst_normals);
 };
 
 #endif
@@ -684,18 +684,32 @@ BOOL LLSurface::idleUpdate(F32 max_update_time)
 	return did_update;
 }
 
+static LLTrace::BlockTimerStatHandle FTM_DECOMPRESS_DCT_PATCH("Decompress Terrain Patches");
+
 void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, BOOL b_large_patch) 
 {
+	LL_RECORD_BLOCK_TIME(FTM_DECOMPRESS_DCT_PATCH);
 
 	LLPatchHeader  ph;
 	S32 j, i;
 	S32 patch[LARGE_PATCH_SIZE*LARGE_PATCH_SIZE];
 	LLSurfacePatch *patchp;
+	std::vector<LLSurfacePatch*> decoded_patches;
+
+	// The decompressor tables and the IDCT only handle these two sizes.
+	if ((gopp->patch_size != NORMAL_PATCH_SIZE) && (gopp->patch_size != LARGE_PATCH_SIZE))
+	{
+		LL_WARNS() << "Received invalid terrain packet - patch size " << (S32)gopp->patch_size << LL_ENDL;
+		return;
+	}
 
 	init_patch_decompressor(gopp->patch_size);
 	gopp->stride = mGridsPerEdge;
 	set_group_of_patch_header(gopp);
 
+	// Decode every patch in the packet first. Edges, normals and stats
+	// only need refreshing once per patch after all the heights are in,
+	// instead of once per neighbor as each patch arrives.
 	while (1)
 	{
 		decode_patch_header(bitpack, &ph);
@@ -718,7 +732,7 @@ void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, BOOL
 				<< " quant_wbits " << (S32)ph.quant_wbits
 				<< " patchids " << (S32)ph.patchids
 				<< LL_ENDL;
-			return;
+			break;
 		}
 
 		patchp = &mPatchList[j*mPatchesPerEdge + i];
@@ -727,6 +741,17 @@ void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, BOOL
 		decode_patch(bitpack, patch);
 		decompress_patch(patchp->getDataZ(), patch, &ph);
 
+		if (std::find(decoded_patches.begin(), decoded_patches.end(), patchp) == decoded_patches.end())
+		{
+			decoded_patches.push_back(patchp);
+		}
+	}
+
+	for (std::vector<LLSurfacePatch*>::iterator iter = decoded_patches.begin();
+		 iter != decoded_patches.end(); ++iter)
+	{
+		patchp = *iter;
+
 		// Update edges for neighbors.  Need to guarantee that this gets done before we generate vertical stats.
 		patchp->updateNorthEdge();
 		patchp->updateEastEdge();
@@ -743,10 +768,14 @@ void LLSurface::decompressDCTPatch(LLBitPack &bitpack, LLGroupHeader *gopp, BOOL
 		{
 			patchp->getNeighborPatch(SOUTH)->updateNorthEdge();
 		}
+	}
 
+	for (std::vector<LLSurfacePatch*>::iterator iter = decoded_patches.begin();
+		 iter != decoded_patches.end(); ++iter)
+	{
 		// Dirty patch statistics, and flag that the patch has data.
-		patchp->dirtyZ();
-		patchp->setHasReceivedData();
+		(*iter)->dirtyZ();
+		(*iter)->setHasReceivedData();
 	}
 }
 
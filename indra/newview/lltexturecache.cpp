@@ -1273,11 +1273,19 @@ void LLTextureCache::writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool
 
 	closeHeaderEntriesFile();
 	mUpdatedEntryMap.erase(idx) ;
+	setHeaderEntry(idx, entry);
 }
 
 //mHeaderMutex is locked before calling this.
 void LLTextureCache::readEntryFromHeaderImmediately(S32& idx, Entry& entry)
 {
+	if (idx < (S32)mHeaderEntries.size())
+	{
+		// The in-memory copy mirrors the file, no need to hit the disk.
+		entry = mHeaderEntries[idx];
+		return;
+	}
+
 	S32 offset = sizeof(EntriesInfo) + idx * sizeof(Entry);
 	LLAPRFile* aprfile = openHeaderEntriesFile(true, offset);
 	S32 bytes_read = aprfile->read((void*)&entry, (S32)sizeof(Entry));
@@ -1288,6 +1296,24 @@ void LLTextureCache::readEntryFromHeaderImmediately(S32& idx, Entry& entry)
 		clearCorruptedCache() ; //clear the cache.
 		idx = -1 ;//mark the idx invalid.
 	}
+	else
+	{
+		setHeaderEntry(idx, entry);
+	}
+}
+
+//mHeaderMutex is locked before calling this.
+void LLTextureCache::setHeaderEntry(S32 idx, const Entry& entry)
+{
+	if (idx < 0)
+	{
+		return;
+	}
+	if (idx >= (S32)mHeaderEntries.size())
+	{
+		mHeaderEntries.resize(idx + 1);
+	}
+	mHeaderEntries[idx] = entry;
 }
 
 //mHeaderMutex is locked before calling this.
@@ -1373,6 +1399,7 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 	mTexturesSizeMap.clear();
 	mFreeList.clear();
 	mTexturesSizeTotal = 0;
+	mHeaderEntries.clear();
 
 	LLAPRFile* aprfile = NULL; 
 	if(mUpdatedEntryMap.empty())
@@ -1414,6 +1441,7 @@ U32 LLTextureCache::openAndReadEntries(std::vector<Entry>& entries)
 		}
 	}
 	closeHeaderEntriesFile();
+	mHeaderEntries = entries;
 	return num_entries;
 }
 
@@ -1435,6 +1463,7 @@ void LLTextureCache::writeEntriesAndClose(const std::vector<Entry>& entries)
 			}
 		}
 		closeHeaderEntriesFile();
+		mHeaderEntries = entries;
 	}
 }
 
@@ -1483,6 +1512,7 @@ void LLTextureCache::updatedHeaderEntriesFile()
 				clearCorruptedCache() ; //clear the cache.
 				return ;
 			}
+			setHeaderEntry(iter->first, iter->second);
 		}
 		mUpdatedEntryMap.clear() ;
 	}
@@ -1661,6 +1691,7 @@ void LLTextureCache::purgeAllTextures(bool purge_directories)
 	mFreeList.clear();
 	mTexturesSizeTotal = 0;
 	mUpdatedEntryMap.clear();
+	mHeaderEntries.clear();
 
 	// Info with 0 entries
 	setEntriesHeader();
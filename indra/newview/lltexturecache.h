@@ -168,6 +168,7 @@ private:
 	void writeEntriesAndClose(const std::vector<Entry>& entries);
 	void readEntryFromHeaderImmediately(S32& idx, Entry& entry) ;
 	void writeEntryToHeaderImmediately(S32& idx, Entry& entry, bool write_header = false) ;
+	void setHeaderEntry(S32 idx, const Entry& entry);
 	void removeEntry(S32 idx, Entry& entry, std::string& filename);
 	void removeCachedTexture(const LLUUID& id) ;
 	S32 getHeaderCacheEntry(const LLUUID& id, Entry& entry);
@@ -226,6 +227,11 @@ private:
 	typedef std::map<S32, Entry> idx_entry_map_t;
 	idx_entry_map_t mUpdatedEntryMap;
 
+	// In-memory copy of the entries stored in the header entries file, indexed by entry idx.
+	// Kept in sync with every write to the file so that entry lookups never touch the disk.
+	typedef std::vector<Entry> entry_list_t;
+	entry_list_t mHeaderEntries;
+
 	// Statics
 	static F32 sHeaderCacheVersion;
 	static U32 sHeaderCacheAddressSize;
@@ -1181,6 +1181,25 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 		{
 		case OUT_FULL:
 			{
+				static LLMessageAccessor full_crc_field(_PREHASH_ObjectData, _PREHASH_CRC);
+				static LLMessageAccessor full_parentid_field(_PREHASH_ObjectData, _PREHASH_ParentID);
+				static LLMessageAccessor full_sound_field(_PREHASH_ObjectData, _PREHASH_Sound);
+				static LLMessageAccessor full_ownerid_field(_PREHASH_ObjectData, _PREHASH_OwnerID);
+				static LLMessageAccessor full_gain_field(_PREHASH_ObjectData, _PREHASH_Gain);
+				static LLMessageAccessor full_flags_field(_PREHASH_ObjectData, _PREHASH_Flags);
+				static LLMessageAccessor full_material_field(_PREHASH_ObjectData, _PREHASH_Material);
+				static LLMessageAccessor full_clickaction_field(_PREHASH_ObjectData, _PREHASH_ClickAction);
+				static LLMessageAccessor full_scale_field(_PREHASH_ObjectData, _PREHASH_Scale);
+				static LLMessageAccessor full_objectdata_field(_PREHASH_ObjectData, _PREHASH_ObjectData);
+				static LLMessageAccessor full_updateflags_field(_PREHASH_ObjectData, _PREHASH_UpdateFlags);
+				static LLMessageAccessor full_state_field(_PREHASH_ObjectData, _PREHASH_State);
+				static LLMessageAccessor full_namevalue_field(_PREHASH_ObjectData, _PREHASH_NameValue);
+				static LLMessageAccessor full_data_field(_PREHASH_ObjectData, _PREHASH_Data);
+				static LLMessageAccessor full_text_field(_PREHASH_ObjectData, _PREHASH_Text);
+				static LLMessageAccessor full_textcolor_field(_PREHASH_ObjectData, _PREHASH_TextColor);
+				static LLMessageAccessor full_mediaurl_field(_PREHASH_ObjectData, _PREHASH_MediaURL);
+				static LLMessageAccessor full_extraparams_field(_PREHASH_ObjectData, _PREHASH_ExtraParams);
+
 #ifdef DEBUG_UPDATE_TYPE
 				LL_INFOS() << "Full:" << getID() << LL_ENDL;
 #endif
@@ -1196,18 +1215,18 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				F32    gain;
 				U8     sound_flags;
 
-				mesgsys->getU32Fast( _PREHASH_ObjectData, _PREHASH_CRC, crc, block_num);
-				mesgsys->getU32Fast( _PREHASH_ObjectData, _PREHASH_ParentID, parent_id, block_num);
-				mesgsys->getUUIDFast(_PREHASH_ObjectData, _PREHASH_Sound, audio_uuid, block_num );
+				mesgsys->getU32(full_crc_field, crc, block_num);
+				mesgsys->getU32(full_parentid_field, parent_id, block_num);
+				mesgsys->getUUID(full_sound_field, audio_uuid, block_num );
 				// HACK: Owner id only valid if non-null sound id or particle system
-				mesgsys->getUUIDFast(_PREHASH_ObjectData, _PREHASH_OwnerID, owner_id, block_num );
-				mesgsys->getF32Fast( _PREHASH_ObjectData, _PREHASH_Gain, gain, block_num );
-				mesgsys->getU8Fast(  _PREHASH_ObjectData, _PREHASH_Flags, sound_flags, block_num );
-				mesgsys->getU8Fast(  _PREHASH_ObjectData, _PREHASH_Material, material, block_num );
-				mesgsys->getU8Fast(  _PREHASH_ObjectData, _PREHASH_ClickAction, click_action, block_num); 
-				mesgsys->getVector3Fast(_PREHASH_ObjectData, _PREHASH_Scale, new_scale, block_num );
-				length = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_ObjectData);
-				mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_ObjectData, data, length, block_num);
+				mesgsys->getUUID(full_ownerid_field, owner_id, block_num );
+				mesgsys->getF32(full_gain_field, gain, block_num );
+				mesgsys->getU8(full_flags_field, sound_flags, block_num );
+				mesgsys->getU8(full_material_field, material, block_num );
+				mesgsys->getU8(full_clickaction_field, click_action, block_num);
+				mesgsys->getVector3(full_scale_field, new_scale, block_num );
+				length = mesgsys->getSize(full_objectdata_field, block_num);
+				mesgsys->getBinaryData(full_objectdata_field, data, length, block_num);
 
 				mTotalCRC = crc;
 
@@ -1382,24 +1401,24 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				//
 
 				U32 flags;
-				mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, flags, block_num);
+				mesgsys->getU32(full_updateflags_field, flags, block_num);
 				// clear all but local flags
 				mFlags &= FLAGS_LOCAL;
 				mFlags |= flags;
 
 				U8 state;
-				mesgsys->getU8Fast(_PREHASH_ObjectData, _PREHASH_State, state, block_num );
+				mesgsys->getU8(full_state_field, state, block_num );
 				mState = state;
 
 				// ...new objects that should come in selected need to be added to the selected list
 				mCreateSelected = ((flags & FLAGS_CREATE_SELECTED) != 0);
 
 				// Set all name value pairs
-				S32 nv_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_NameValue);
+				S32 nv_size = mesgsys->getSize(full_namevalue_field, block_num);
 				if (nv_size > 0)
 				{
 					std::string name_value_list;
-					mesgsys->getStringFast(_PREHASH_ObjectData, _PREHASH_NameValue, name_value_list, block_num);
+					mesgsys->getString(full_namevalue_field, name_value_list, block_num);
 					setNameValueList(name_value_list);
 				}
 
@@ -1410,7 +1429,7 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				}
 
 				// Check for appended generic data
-				S32 data_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_Data);
+				S32 data_size = mesgsys->getSize(full_data_field, block_num);
 				if (data_size <= 0)
 				{
 					mData = NULL;
@@ -1419,10 +1438,10 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				{
 					// ...has generic data
 					mData = new U8[data_size];
-					mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, mData, data_size, block_num);
+					mesgsys->getBinaryData(full_data_field, mData, data_size, block_num);
 				}
 
-				S32 text_size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_Text);
+				S32 text_size = mesgsys->getSize(full_text_field, block_num);
 				if (text_size > 1)
 				{
 					// Setup object text
@@ -1432,10 +1451,10 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 					}
 
 					std::string temp_string;
-					mesgsys->getStringFast(_PREHASH_ObjectData, _PREHASH_Text, temp_string, block_num );
+					mesgsys->getString(full_text_field, temp_string, block_num );
 					
 					LLColor4U coloru;
-					mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_TextColor, coloru.mV, 4, block_num);
+					mesgsys->getBinaryData(full_textcolor_field, coloru.mV, 4, block_num);
 
 					// alpha was flipped so that it zero encoded better
 					coloru.mV[3] = 255 - coloru.mV[3];
@@ -1458,7 +1477,7 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				}
 
 				std::string media_url;
-				mesgsys->getStringFast(_PREHASH_ObjectData, _PREHASH_MediaURL, media_url, block_num);
+				mesgsys->getString(full_mediaurl_field, media_url, block_num);
                 retval |= checkMediaURL(media_url);
                 
 				//
@@ -1474,11 +1493,11 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				}
 
 				// Unpack extra parameters
-				S32 size = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_ExtraParams);
+				S32 size = mesgsys->getSize(full_extraparams_field, block_num);
 				if (size > 0)
 				{
 					U8 *buffer = new U8[size];
-					mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_ExtraParams, buffer, size, block_num);
+					mesgsys->getBinaryData(full_extraparams_field, buffer, size, block_num);
 					LLDataPackerBinaryBuffer dp(buffer, size);
 
 					U8 num_parameters;
@@ -1511,11 +1530,14 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 
 		case OUT_TERSE_IMPROVED:
 			{
+				static LLMessageAccessor terse_objectdata_field(_PREHASH_ObjectData, _PREHASH_ObjectData);
+				static LLMessageAccessor terse_state_field(_PREHASH_ObjectData, _PREHASH_State);
+
 #ifdef DEBUG_UPDATE_TYPE
 				LL_INFOS() << "TI:" << getID() << LL_ENDL;
 #endif
-				length = mesgsys->getSizeFast(_PREHASH_ObjectData, block_num, _PREHASH_ObjectData);
-				mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_ObjectData, data, length, block_num);
+				length = mesgsys->getSize(terse_objectdata_field, block_num);
+				mesgsys->getBinaryData(terse_objectdata_field, data, length, block_num);
 				count = 0;
 				LLVector4 collision_plane;
 				
@@ -1658,7 +1680,7 @@ U32 LLViewerObject::processUpdateMessage(LLMessageSystem *mesgsys,
 				}
 
 				U8 state;
-				mesgsys->getU8Fast(_PREHASH_ObjectData, _PREHASH_State, state, block_num );
+				mesgsys->getU8(terse_state_field, state, block_num );
 				mState = state;
 				break;
 			}
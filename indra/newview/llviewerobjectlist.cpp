@@ -52,6 +52,7 @@
 #include "llflexibleobject.h"
 #include "llviewertextureanim.h"
 #include "xform.h"
+#include "llskeletonupdater.h"
 #include "llsky.h"
 #include "llviewercamera.h"
 #include "llselectmgr.h"
@@ -453,6 +454,11 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 		return;
 	}
 
+	static LLMessageAccessor data_field(_PREHASH_ObjectData, _PREHASH_Data);
+	static LLMessageAccessor update_flags_field(_PREHASH_ObjectData, _PREHASH_UpdateFlags);
+	static LLMessageAccessor id_field(_PREHASH_ObjectData, _PREHASH_ID);
+	static LLMessageAccessor full_id_field(_PREHASH_ObjectData, _PREHASH_FullID);
+
 	U8 compressed_dpbuffer[2048];
 	LLDataPackerBinaryBuffer compressed_dp(compressed_dpbuffer, 2048);
 	LLViewerStatsRecorder& recorder = LLViewerStatsRecorder::instance();
@@ -470,14 +476,14 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 			S32							uncompressed_length = 2048;
 			compressed_dp.reset();
 
-			uncompressed_length = mesgsys->getSizeFast(_PREHASH_ObjectData, i, _PREHASH_Data);
-			mesgsys->getBinaryDataFast(_PREHASH_ObjectData, _PREHASH_Data, compressed_dpbuffer, 0, i);
+			uncompressed_length = mesgsys->getSize(data_field, i);
+			mesgsys->getBinaryData(data_field, compressed_dpbuffer, 0, i);
 			compressed_dp.assignBuffer(compressed_dpbuffer, uncompressed_length);
 
 			if (update_type != OUT_TERSE_IMPROVED) // OUT_FULL_COMPRESSED only?
 			{
 				U32 flags = 0;
-				mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, flags, i);
+				mesgsys->getU32(update_flags_field, flags, i);
 
 				compressed_dp.unpackUUID(fullid, "ID");
 				compressed_dp.unpackU32(local_id, "LocalID");
@@ -518,7 +524,7 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 		}
 		else if (update_type != OUT_FULL) // !compressed, !OUT_FULL ==> OUT_FULL_CACHED only?
 		{
-			mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, local_id, i);
+			mesgsys->getU32(id_field, local_id, i);
 			msg_size += sizeof(U32);
 
 			getUUIDFromLocal(fullid,
@@ -534,8 +540,8 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 		else // OUT_FULL only?
 		{
 			update_cache = true;
-			mesgsys->getUUIDFast(_PREHASH_ObjectData, _PREHASH_FullID, fullid, i);
-			mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, local_id, i);
+			mesgsys->getUUID(full_id_field, fullid, i);
+			mesgsys->getU32(id_field, local_id, i);
 			msg_size += sizeof(LLUUID);
 			msg_size += sizeof(U32);
 			// LL_INFOS() << "Full Update, obj " << local_id << ", global ID" << fullid << "from " << mesgsys->getSender() << LL_ENDL;
@@ -698,6 +704,10 @@ void LLViewerObjectList::processCachedObjectUpdate(LLMessageSystem *mesgsys,
 		return;
 	}
 
+	static LLMessageAccessor id_field(_PREHASH_ObjectData, _PREHASH_ID);
+	static LLMessageAccessor crc_field(_PREHASH_ObjectData, _PREHASH_CRC);
+	static LLMessageAccessor update_flags_field(_PREHASH_ObjectData, _PREHASH_UpdateFlags);
+
 	LLViewerStatsRecorder& recorder = LLViewerStatsRecorder::instance();
 
 	for (S32 i = 0; i < num_objects; i++)
@@ -706,9 +716,9 @@ void LLViewerObjectList::processCachedObjectUpdate(LLMessageSystem *mesgsys,
 		U32 id;
 		U32 crc;
 		U32 flags;
-		mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_ID, id, i);
-		mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_CRC, crc, i);
-		mesgsys->getU32Fast(_PREHASH_ObjectData, _PREHASH_UpdateFlags, flags, i);
+		mesgsys->getU32(id_field, id, i);
+		mesgsys->getU32(crc_field, crc, i);
+		mesgsys->getU32(update_flags_field, flags, i);
 		msg_size += sizeof(U32) * 2;
 		
 		// Lookup data packer and add this id to cache miss lists if necessary.
@@ -927,6 +937,12 @@ void LLViewerObjectList::update(LLAgent &agent)
 		}
 	}
 
+	// Avatars queued their skeletons in idleUpdate()
+	LLSkeletonUpdater::flush();
+	if (LLVOAvatar::sJointDebug)
+	{
+		LL_INFOS() << "avatar joint updates: " << LLSkeletonUpdater::getLastJointUpdates() << LL_ENDL;
+	}
 
 
 	fetchObjectCosts();
@@ -248,15 +248,17 @@ BOOL LLVLComposition::generateComposition()
 	return TRUE;
 }
 
+static LLTrace::BlockTimerStatHandle FTM_GENERATE_TERRAIN_TEXTURE("Generate Terrain Texture");
+
 BOOL LLVLComposition::generateTexture(const F32 x, const F32 y,
 									  const F32 width, const F32 height)
 {
+	LL_RECORD_BLOCK_TIME(FTM_GENERATE_TERRAIN_TEXTURE);
+
 	llassert(mSurfacep);
 	llassert(x >= 0.f);
 	llassert(y >= 0.f);
 
-	LLTimer gen_timer;
-
 	///////////////////////////
 	//
 	// Generate raw data arrays for surface textures
@@ -372,7 +374,17 @@ BOOL LLVLComposition::generateTexture(const F32 x, const F32 y,
 	tex_x_ratiof = (F32)mWidth*mScale / (F32)tex_width;
 	tex_y_ratiof = (F32)mWidth*mScale / (F32)tex_height;
 
-	LLPointer<LLImageRaw> raw = new LLImageRaw(tex_width, tex_height, tex_comps);
+	// Only the patch's own rectangle is written and uploaded, so one image
+	// the size of the surface texture is reused rather than allocating a
+	// fresh one for every patch.
+	if (mCompositeImage.isNull()
+		|| mCompositeImage->getWidth() != tex_width
+		|| mCompositeImage->getHeight() != tex_height
+		|| mCompositeImage->getComponents() != tex_comps)
+	{
+		mCompositeImage = new LLImageRaw(tex_width, tex_height, tex_comps);
+	}
+	LLImageRaw* raw = mCompositeImage;
 	U8 *rawp = raw->getData();
 
 	F32 st_x_stride, st_y_stride;
@@ -410,23 +422,37 @@ BOOL LLVLComposition::generateTexture(const F32 x, const F32 y,
 			tex1 = llclamp(tex1, 0, 3);
 
 			st_offset = (lltrunc(sti) + lltrunc(stj)*st_width) * st_comps;
-			for (U32 k = 0; k < tex_comps; k++)
+			if (st_offset + (S32)tex_comps <= st_data_size[tex0]
+				&& st_offset + (S32)tex_comps <= st_data_size[tex1])
 			{
-				// Linearly interpolate based on composition.
-				if (st_offset >= st_data_size[tex0] || st_offset >= st_data_size[tex1])
+				// Common case, the whole texel is in range.
+				const U8* a = st_data[tex0] + st_offset;
+				const U8* b = st_data[tex1] + st_offset;
+				for (U32 k = 0; k < tex_comps; k++)
 				{
-					// SJB: This shouldn't be happening, but does... Rounding error?
-					//LL_WARNS() << "offset 0 [" << tex0 << "] =" << st_offset << " >= size=" << st_data_size[tex0] << LL_ENDL;
-					//LL_WARNS() << "offset 1 [" << tex1 << "] =" << st_offset << " >= size=" << st_data_size[tex1] << LL_ENDL;
+					rawp[offset++] = (U8)lltrunc(a[k] + composition * (b[k] - a[k]));
 				}
-				else
+			}
+			else
+			{
+				for (U32 k = 0; k < tex_comps; k++)
 				{
-					F32 a = *(st_data[tex0] + st_offset);
-					F32 b = *(st_data[tex1] + st_offset);
-					rawp[ offset ] = (U8)lltrunc( a + composition * (b - a) );
+					// Linearly interpolate based on composition.
+					if (st_offset >= st_data_size[tex0] || st_offset >= st_data_size[tex1])
+					{
+						// SJB: This shouldn't be happening, but does... Rounding error?
+						//LL_WARNS() << "offset 0 [" << tex0 << "] =" << st_offset << " >= size=" << st_data_size[tex0] << LL_ENDL;
+						//LL_WARNS() << "offset 1 [" << tex1 << "] =" << st_offset << " >= size=" << st_data_size[tex1] << LL_ENDL;
+					}
+					else
+					{
+						F32 a = *(st_data[tex0] + st_offset);
+						F32 b = *(st_data[tex1] + st_offset);
+						rawp[ offset ] = (U8)lltrunc( a + composition * (b - a) );
+					}
+					offset++;
+					st_offset++;
 				}
-				offset++;
-				st_offset++;
 			}
 
 			sti += st_x_stride;
@@ -76,6 +76,10 @@ protected:
 	LLPointer<LLViewerFetchedTexture> mDetailTextures[CORNER_COUNT];
 	LLPointer<LLImageRaw> mRawImages[CORNER_COUNT];
 
+	// Surface texture sized scratch image that generateTexture() composes
+	// each patch into before uploading it.
+	LLPointer<LLImageRaw> mCompositeImage;
+
 	F32 mStartHeight[CORNER_COUNT];
 	F32 mHeightRange[CORNER_COUNT];
 
@@ -75,6 +75,7 @@
 #include "llregionhandle.h"
 #include "llresmgr.h"
 #include "llselectmgr.h"
+#include "llskeletonupdater.h"
 #include "llsprite.h"
 #include "lltargetingmotion.h"
 #include "lltoolmorph.h"
@@ -776,6 +777,8 @@ LLVOAvatar::~LLVOAvatar()
 	
 	LL_DEBUGS("Avatar") << "LLVOAvatar Destructor (0x" << this << ") id:" << mID << LL_ENDL;
 
+	LLSkeletonUpdater::dequeue(&mFlatSkeleton);
+
 	std::for_each(mAttachmentPoints.begin(), mAttachmentPoints.end(), DeletePairedPointer());
 	mAttachmentPoints.clear();
 
@@ -2491,10 +2494,11 @@ void LLVOAvatar::idleUpdateMisc(bool detailed_update)
 {
 	if (LLVOAvatar::sJointDebug)
 	{
-		LL_INFOS() << getFullname() << ": joint touches: " << LLJoint::sNumTouches << " updates: " << LLJoint::sNumUpdates << LL_ENDL;
+		// World matrix updates happen later, LLViewerObjectList::update()
+		// logs those for all avatars after flushing the skeletons
+		LL_INFOS() << getFullname() << ": joint touches: " << LLJoint::sNumTouches << LL_ENDL;
 	}
 
-	LLJoint::sNumUpdates = 0;
 	LLJoint::sNumTouches = 0;
 
 	BOOL visible = isVisible() || mNeedsAnimUpdate;
@@ -3229,7 +3233,8 @@ void LLVOAvatar::idleUpdateNameTagPosition(const LLVector3& root_pos_last)
 	local_camera_up.scaleVec(avatar_ellipsoid);
 	local_camera_at.scaleVec(avatar_ellipsoid);
 
-	LLVector3 head_offset = (mHeadp->getLastWorldPosition() - mRoot->getLastWorldPosition()) * inv_root_rot;
+	// The skeleton may still be queued in LLSkeletonUpdater, these update the head's chain.
+	LLVector3 head_offset = (mHeadp->getWorldPosition() - mRoot->getWorldPosition()) * inv_root_rot;
 
 	if (dist_vec(head_offset, mTargetRootToHeadOffset) > NAMETAG_UPDATE_THRESHOLD)
 	{
@@ -4001,7 +4006,9 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 		}
 	}
 
-	mRoot->updateWorldMatrixChildren();
+	// World matrices are brought up to date with the other avatars' before rendering.
+	mFlatSkeleton.setRoot(mRoot);
+	LLSkeletonUpdater::queue(&mFlatSkeleton);
 
 	//mesh vertices need to be reskinned
 	mNeedsSkin = TRUE;
@@ -91,6 +91,14 @@ void LLWind::decompress(LLBitPack &bitpack, LLGroupHeader *group_headerp)
 	LLPatchHeader  patch_header;
 	S32 buffer[16*16];
 
+	// Wind always comes as one 16x16 patch, anything else would overrun
+	// buffer and the velocity arrays.
+	if (group_headerp->patch_size != NORMAL_PATCH_SIZE)
+	{
+		LL_WARNS() << "Received invalid wind packet - patch size " << (S32)group_headerp->patch_size << LL_ENDL;
+		return;
+	}
+
 	init_patch_decompressor(group_headerp->patch_size);
 
 	// Don't use the packed group_header stride because the strides used on
@@ -35,6 +35,7 @@
 #include "llquaternion.h"
 #include "lltemplatemessagebuilder.h"
 #include "lltemplatemessagereader.h"
+#include "message.h"
 #include "message_prehash.h"
 #include "u64.h"
 #include "v3dmath.h"
@@ -966,5 +967,111 @@ namespace tut
 		ensure_equals("Ensure unchanged buffer ", strlen(outBuffer), 0);
 		delete reader;
 	}
+	template<> template<>
+	void LLTemplateMessageBuilderTestObject::test<46>()
+		// accessor reads match name reads, across repeated blocks and templates
+	{
+		LLMessageTemplate messageTemplate = defaultTemplate();
+		messageTemplate.addBlock(createBlock(const_cast<char*>(_PREHASH_Test0), MVT_U32, 4, MBT_SINGLE));
+		LLMessageBlock* block = createBlock(const_cast<char*>(_PREHASH_Test1), MVT_U32, 4);
+		block->addVariable(const_cast<char*>(_PREHASH_Test1), MVT_LLUUID, 16);
+		messageTemplate.addBlock(block);
+
+		LLUUID inUUID;
+		inUUID.generate();
+		LLTemplateMessageBuilder* builder = defaultBuilder(messageTemplate);
+		builder->addU32(_PREHASH_Test0, 0xaaaa);
+		for (U32 i = 0; i < 3; ++i)
+		{
+			builder->nextBlock(_PREHASH_Test1);
+			builder->addU32(_PREHASH_Test0, 0xbbbb + i);
+			builder->addUUID(_PREHASH_Test1, inUUID);
+		}
+		LLTemplateMessageReader* reader = setReader(messageTemplate, builder);
+
+		LLMessageAccessor single(_PREHASH_Test0, _PREHASH_Test0);
+		LLMessageAccessor repeated(_PREHASH_Test1, _PREHASH_Test0);
+		LLMessageAccessor uuid(_PREHASH_Test1, _PREHASH_Test1);
+		U32 outValue;
+		LLUUID outUUID;
+		reader->getU32(single, outValue);
+		ensure_equals("Ensure single block", outValue, 0xaaaa);
+		for (S32 i = 0; i < 3; ++i)
+		{
+			reader->getU32(repeated, outValue, i);
+			ensure_equals("Ensure repeated block", outValue, (U32)(0xbbbb + i));
+			reader->getUUID(uuid, outUUID, i);
+			ensure_equals("Ensure UUID", outUUID, inUUID);
+			ensure_equals("Ensure size", reader->getSize(uuid, i), 16);
+		}
+		delete reader;
+
+		// same accessor against a template with the blocks the other way round
+		LLMessageTemplate otherTemplate = defaultTemplate();
+		otherTemplate.addBlock(createBlock(const_cast<char*>(_PREHASH_Test1), MVT_U32, 4, MBT_SINGLE));
+		otherTemplate.addBlock(createBlock(const_cast<char*>(_PREHASH_Test0), MVT_U32, 4, MBT_SINGLE));
+		builder = defaultBuilder(otherTemplate, const_cast<char*>(_PREHASH_Test1));
+		builder->addU32(_PREHASH_Test0, 0xcccc);
+		builder->nextBlock(_PREHASH_Test0);
+		builder->addU32(_PREHASH_Test0, 0xdddd);
+		reader = setReader(otherTemplate, builder);
+		reader->getU32(single, outValue);
+		ensure_equals("Ensure other template", outValue, 0xdddd);
+		reader->getU32(repeated, outValue);
+		ensure_equals("Ensure other template repeated", outValue, 0xcccc);
+		delete reader;
+	}
+	template<> template<>
+	void LLTemplateMessageBuilderTestObject::test<47>()
+		// variables added out of template order build and zero code the same
+	{
+		LLMessageTemplate messageTemplate = defaultTemplate();
+		messageTemplate.setEncoding(ME_ZEROCODED);
+		LLMessageBlock* block = createBlock(const_cast<char*>(_PREHASH_Test0), MVT_U32, 4, MBT_SINGLE);
+		block->addVariable(const_cast<char*>(_PREHASH_Test1), MVT_VARIABLE, 1);
+		messageTemplate.addBlock(block);
+		messageTemplate.addBlock(createBlock(const_cast<char*>(_PREHASH_Test1), MVT_U32, 4));
+		messageTemplate.addBlock(createBlock(const_cast<char*>(_PREHASH_Test2), MVT_U32, 4));
+
+		U8 buffer1[MAX_BUFFER_SIZE];
+		U8 buffer2[MAX_BUFFER_SIZE];
+		memset(buffer1, 0, MAX_BUFFER_SIZE);
+		memset(buffer2, 0, MAX_BUFFER_SIZE);
+
+		// template order
+		LLTemplateMessageBuilder* builder = defaultBuilder(messageTemplate);
+		builder->addU32(_PREHASH_Test0, 0);
+		builder->addString(_PREHASH_Test1, "test");
+		builder->nextBlock(_PREHASH_Test2);
+		builder->addU32(_PREHASH_Test0, 0xbb);
+		builder->nextBlock(_PREHASH_Test2);
+		builder->addU32(_PREHASH_Test0, 0);
+		U32 bufferSize1 = builder->buildMessage(buffer1, MAX_BUFFER_SIZE, 0);
+		U8* encoded = buffer1;
+		U32 encodedSize1 = bufferSize1;
+		builder->compressMessage(encoded, encodedSize1);
+		std::vector<U8> encoded1(encoded, encoded + encodedSize1);
+		delete builder;
+
+		// same fields, variables out of order
+		builder = defaultBuilder(messageTemplate);
+		builder->addString(_PREHASH_Test1, "test");
+		builder->addU32(_PREHASH_Test0, 0);
+		builder->nextBlock(_PREHASH_Test2);
+		builder->addU32(_PREHASH_Test0, 0xbb);
+		builder->nextBlock(_PREHASH_Test2);
+		builder->addU32(_PREHASH_Test0, 0);
+		U32 bufferSize2 = builder->buildMessage(buffer2, MAX_BUFFER_SIZE, 0);
+		encoded = buffer2;
+		U32 encodedSize2 = bufferSize2;
+		builder->compressMessage(encoded, encodedSize2);
+		std::vector<U8> encoded2(encoded, encoded + encodedSize2);
+		delete builder;
+
+		ensure_equals("Ensure Buffer Sizes Equal", bufferSize1, bufferSize2);
+		ensure_equals("Ensure Buffer Contents Equal", memcmp(buffer1, buffer2, bufferSize1), 0);
+		ensure("Ensure zero coded", encodedSize1 < bufferSize1);
+		ensure("Ensure Zero Coded Buffers Equal", encoded1 == encoded2);
+	}
 }
 